@@ -0,0 +1,533 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+/*! \file
+ *  \brief nnfw-bench: micro and macro benchmarks of nnfw
+ *
+ *  The results are written as JSON, so that builds and releases can be compared:
+ *  <pre>
+ *  nnfw-bench [--json file] [--filter text] [--quick] [--min-time ms]
+ *  </pre>
+ *  Each benchmark is repeated until it runs for at least --min-time milliseconds, five times;
+ *  the best and the mean time per operation are reported. The precision of Real is the one the
+ *  library is compiled with, so float and double are compared running the benchmarks of the two
+ *  builds.<br>
+ *  The benchmarks of the group "numa" compare the placements of the weights (see MemoryPolicy)
+ *  and the Evaluator with and without pinning the threads; the JSON reports the NUMA nodes and
+ *  the huge pages of the machine, as the differences show up only where they are available.
+ */
+
+#include "nnfw.h"
+#include "utils.h"
+#include "biasedcluster.h"
+#include "dotlinker.h"
+#include "backpropagationalgo.h"
+#include "evaluator.h"
+#include "memorypolicy.h"
+#include "liboutputfunctions.h"
+#include "libradialfunctions.h"
+#include "libperiodicfunctions.h"
+#include "libcompetitivefunctions.h"
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+
+using namespace nnfw;
+
+/*! a piece of code to measure; run() is the operation timed */
+class Bench {
+public:
+	Bench( const char* group, const std::string& name, u_int size )
+		: group(group), name(name), size(size) { };
+	virtual ~Bench() { };
+	virtual void run() = 0;
+	const char* group;
+	std::string name;
+	u_int size;
+};
+
+/*! the measures of a Bench */
+class Result {
+public:
+	const Bench* bench;
+	u_int iterations;
+	double bestNs;
+	double meanNs;
+};
+
+/*! options of the command line */
+static const char* jsonFile = 0;
+static const char* filter = 0;
+static bool quick = false;
+static int minTimeUs = 200000;
+static const int repetitions = 5;
+
+/*! run b for iters times; return the microseconds spent */
+static int timeRuns( Bench* b, u_int iters ) {
+	SimpleTimer timer;
+	for( u_int i=0; i<iters; i++ ) {
+		b->run();
+	}
+	return timer.tac();
+}
+
+static Result measure( Bench* b ) {
+	Result r;
+	r.bench = b;
+	// --- calibration: the iterations are doubled until they last the minimum time
+	u_int iters = 1;
+	b->run();
+	while( true ) {
+		int us = timeRuns( b, iters );
+		if ( us >= minTimeUs || iters >= (1u << 30) ) break;
+		if ( us < minTimeUs/100 ) {
+			iters *= 10;
+		} else {
+			iters *= 2;
+		}
+	}
+	r.iterations = iters;
+	r.bestNs = 0.0;
+	r.meanNs = 0.0;
+	for( int k=0; k<repetitions; k++ ) {
+		double ns = timeRuns( b, iters )*1000.0/iters;
+		if ( k == 0 || ns < r.bestNs ) r.bestNs = ns;
+		r.meanNs += ns/repetitions;
+	}
+	return r;
+}
+
+static std::string sizeName( const char* base, u_int size ) {
+	char buf[32];
+	sprintf( buf, "/%u", size );
+	return std::string( base ) + buf;
+}
+
+/*! random inputs used by the benchmarks */
+static RandomStream rnd( 1234 );
+
+//--- RealVec operations
+class vecBench : public Bench {
+public:
+	vecBench( const char* op, u_int n )
+		: Bench( "micro", sizeName( op, n ), n ), x(n), y(n), z(n), acc(0.0) {
+		rnd.flatRealVec( x, -1.0, 1.0 );
+		rnd.flatRealVec( y, 0.5, 1.0 );
+		rnd.flatRealVec( z, -1.0, 1.0 );
+	};
+	RealVec x, y, z;
+	Real acc;
+};
+class vecAdd : public vecBench {
+public:
+	vecAdd( u_int n ) : vecBench( "RealVec::operator+=", n ) { };
+	void run() { x += y; };
+};
+class vecMul : public vecBench {
+public:
+	vecMul( u_int n ) : vecBench( "RealVec::operator*=", n ) { };
+	void run() { z.assign( x ); z *= y; };
+};
+class vecScale : public vecBench {
+public:
+	vecScale( u_int n ) : vecBench( "RealVec::scale", n ) { };
+	void run() { z.assign( x ); z.scale( 0.5 ); };
+};
+class vecDot : public vecBench {
+public:
+	vecDot( u_int n ) : vecBench( "RealVec::dot", n ) { };
+	void run() { acc += x.dot( y ); };
+};
+class vecAssign : public vecBench {
+public:
+	vecAssign( u_int n ) : vecBench( "RealVec::assign", n ) { };
+	void run() { z.assign( x ); };
+};
+class vecExp : public vecBench {
+public:
+	vecExp( u_int n ) : vecBench( "RealVec::exp", n ) { };
+	void run() { z.assign( x ); z.exp(); };
+};
+class vecDeltarule : public vecBench {
+public:
+	vecDeltarule( u_int n ) : vecBench( "RealVec::deltarule", n ) { };
+	void run() { z.deltarule( 0.001, x, y ); };
+};
+
+//--- RealMat operations
+class matBench : public Bench {
+public:
+	matBench( const char* op, u_int n )
+		: Bench( "micro", sizeName( op, n ), n ), m(n,n), x(n), y(n) {
+		rnd.flatRealMat( m, -1.0, 1.0 );
+		rnd.flatRealVec( x, -1.0, 1.0 );
+		rnd.flatRealVec( y, -1.0, 1.0 );
+	};
+	RealMat m;
+	RealVec x, y;
+};
+class matMulXM : public matBench {
+public:
+	matMulXM( u_int n ) : matBench( "RealMat::mul(y,x,m)", n ) { };
+	void run() { y.zeroing(); RealMat::mul( y, x, m ); };
+};
+class matMulMX : public matBench {
+public:
+	matMulMX( u_int n ) : matBench( "RealMat::mul(y,m,x)", n ) { };
+	void run() { y.zeroing(); RealMat::mul( y, m, x ); };
+};
+class matDeltarule : public matBench {
+public:
+	matDeltarule( u_int n ) : matBench( "RealMat::deltarule", n ) { };
+	void run() { m.deltarule( 0.0001, x, y ); };
+};
+
+//--- construction of MatrixData
+class matConstruct : public Bench {
+public:
+	matConstruct( u_int n ) : Bench( "micro", sizeName( "RealMat::RealMat", n ), n ) { };
+	void run() { RealMat m( size, size ); };
+};
+class vecConstruct : public Bench {
+public:
+	vecConstruct( u_int n ) : Bench( "micro", sizeName( "RealVec::RealVec", n ), n ) { };
+	void run() { RealVec v( size ); };
+};
+
+//--- OutputFunctions
+class funApply : public Bench {
+public:
+	funApply( const char* name, OutputFunction* f, u_int n )
+		: Bench( "micro", sizeName( ( std::string( name ) + "::apply" ).c_str(), n ), n ),
+		  fun(f), cl( new BiasedCluster( n, "bench" ) ), in(n), out(n) {
+		// --- some functions (as PoolFunction) get their size from the Cluster
+		fun->setCluster( cl );
+		rnd.flatRealVec( in, -2.0, 2.0 );
+	};
+	~funApply() {
+		delete fun;
+		delete cl;
+	};
+	void run() { fun->apply( in, out ); };
+	OutputFunction* fun;
+	Cluster* cl;
+	RealVec in, out;
+};
+class funDerivate : public Bench {
+public:
+	funDerivate( const char* name, DerivableOutputFunction* f, u_int n )
+		: Bench( "micro", sizeName( ( std::string( name ) + "::derivate" ).c_str(), n ), n ),
+		  fun(f), cl( new BiasedCluster( n, "bench" ) ), in(n), out(n), der(n) {
+		fun->setCluster( cl );
+		rnd.flatRealVec( in, -2.0, 2.0 );
+		fun->apply( in, out );
+	};
+	~funDerivate() {
+		delete fun;
+		delete cl;
+	};
+	void run() { fun->derivate( in, out, der ); };
+	DerivableOutputFunction* fun;
+	Cluster* cl;
+	RealVec in, out, der;
+};
+
+/*! add the benchmarks of apply, and of derivate when available, of f */
+static void addFunction( std::vector<Bench*>& list, const char* name, OutputFunction* f, u_int n ) {
+	list.push_back( new funApply( name, f, n ) );
+	DerivableOutputFunction* df = dynamic_cast<DerivableOutputFunction*>( f );
+	if ( df ) {
+		list.push_back( new funDerivate( name, (DerivableOutputFunction*)df->clone(), n ) );
+	}
+}
+
+//--- networks
+/*! a feed-forward net of three layers of n neurons */
+class netBench : public Bench {
+public:
+	netBench( const char* op, u_int n ) : Bench( "macro", sizeName( op, n ), n ), pat() {
+		net = new BaseNeuralNet();
+		in = new BiasedCluster( n, "in" );
+		hid = new BiasedCluster( n, "hid" );
+		out = new BiasedCluster( n, "out" );
+		l1 = new DotLinker( in, hid, "l1" );
+		l2 = new DotLinker( hid, out, "l2" );
+		hid->setFunction( SigmoidFunction( 1.0 ) );
+		out->setFunction( SigmoidFunction( 1.0 ) );
+		net->addInputCluster( in );
+		net->addCluster( hid );
+		net->addOutputCluster( out );
+		net->addLinker( l1 );
+		net->addLinker( l2 );
+		Updatable* ord[] = { in, l1, hid, l2, out };
+		net->setOrder( ord, 5 );
+		Random::setSeed( 1 );
+		net->randomize( -0.5, 0.5 );
+		RealVec x(n), t(n);
+		rnd.flatRealVec( x, 0.0, 1.0 );
+		rnd.flatRealVec( t, 0.1, 0.9 );
+		pat.setInputsOf( in, x );
+		pat.setOutputsOf( out, t );
+		in->inputs().assign( x );
+	};
+	~netBench() {
+		destroy( net );
+	};
+	static void destroy( BaseNeuralNet* n ) {
+		// --- BaseNeuralNet doesn't own its Clusters and Linkers
+		const LinkerVec& lks = n->linkers();
+		for( u_int i=0; i<lks.size(); i++ ) {
+			delete lks[i];
+		}
+		const ClusterVec& cls = n->clusters();
+		for( u_int i=0; i<cls.size(); i++ ) {
+			delete cls[i];
+		}
+		delete n;
+	};
+	BaseNeuralNet* net;
+	BiasedCluster *in, *hid, *out;
+	DotLinker *l1, *l2;
+	Pattern pat;
+};
+class netStep : public netBench {
+public:
+	netStep( u_int n ) : netBench( "BaseNeuralNet::step", n ) { };
+	void run() { net->step(); };
+};
+class netBackprop : public netBench {
+public:
+	netBackprop( u_int n ) : netBench( "BackPropagationAlgo::learn", n ), bp(0) {
+		UpdatableVec uv;
+		uv << out << l2 << hid << l1;
+		bp = new BackPropagationAlgo( net, uv, 0.01 );
+	};
+	~netBackprop() { delete bp; };
+	void run() { bp->learn( pat ); };
+	BackPropagationAlgo* bp;
+};
+/*! file used by the benchmarks of XML */
+static const char* xmlFile = "nnfw-bench.xml";
+class netSave : public netBench {
+public:
+	netSave( u_int n ) : netBench( "saveXML", n ) { };
+	void run() { saveXML( xmlFile, net ); };
+};
+class netLoad : public netBench {
+public:
+	netLoad( u_int n ) : netBench( "loadXML", n ) {
+		saveXML( xmlFile, net );
+	};
+	void run() {
+		BaseNeuralNet* n = loadXML( xmlFile );
+		if ( n ) destroy( n );
+	};
+};
+
+//--- placement of the parameters
+/*! a step of a net whose parameters are placed following a MemoryPolicy */
+class netPlacedStep : public netBench {
+public:
+	netPlacedStep( const char* op, u_int n, const MemoryPolicy& policy ) : netBench( op, n ) {
+		group = "numa";
+		net->setMemoryPolicy( policy );
+	};
+	void run() { net->step(); };
+};
+/*! an evaluation over a DataSet, with or without pinning the threads to the NUMA nodes */
+class netEvaluate : public netBench {
+public:
+	netEvaluate( const char* op, u_int n, bool pinning ) : netBench( op, n ), eval( net ), ds( 256 ) {
+		group = "numa";
+		ds.addInputsOf( in );
+		ds.addOutputsOf( out );
+		rnd.flatRealVec( ds.inputsDataOf( in ), 0.0, 1.0 );
+		rnd.flatRealVec( ds.outputsDataOf( out ), 0.1, 0.9 );
+		eval.setNumaPinning( pinning );
+	};
+	void run() { eval.evaluate( ds ); };
+	Evaluator eval;
+	DataSet ds;
+};
+
+static std::vector<Bench*> createBenchmarks() {
+	std::vector<Bench*> list;
+	const u_int vsizes[] = { 64, 1024, 16384 };
+	const u_int msizes[] = { 32, 128, 512 };
+	const u_int nsizes[] = { 16, 64, 256 };
+	const u_int nv = quick ? 2 : 3;
+	for( u_int i=0; i<nv; i++ ) {
+		const u_int n = vsizes[i];
+		list.push_back( new vecAdd( n ) );
+		list.push_back( new vecMul( n ) );
+		list.push_back( new vecScale( n ) );
+		list.push_back( new vecDot( n ) );
+		list.push_back( new vecAssign( n ) );
+		list.push_back( new vecExp( n ) );
+		list.push_back( new vecDeltarule( n ) );
+		list.push_back( new vecConstruct( n ) );
+	}
+	for( u_int i=0; i<nv; i++ ) {
+		const u_int n = msizes[i];
+		list.push_back( new matMulXM( n ) );
+		list.push_back( new matMulMX( n ) );
+		list.push_back( new matDeltarule( n ) );
+		list.push_back( new matConstruct( n ) );
+	}
+	const u_int fn = 1024;
+	RealVec leak( fn, 0.5 );
+	addFunction( list, "IdentityFunction", new IdentityFunction(), fn );
+	addFunction( list, "ScaleFunction", new ScaleFunction( 0.5 ), fn );
+	addFunction( list, "GainFunction", new GainFunction( 0.5 ), fn );
+	addFunction( list, "SigmoidFunction", new SigmoidFunction( 1.0 ), fn );
+	addFunction( list, "FakeSigmoidFunction", new FakeSigmoidFunction( 1.0 ), fn );
+	addFunction( list, "ScaledSigmoidFunction", new ScaledSigmoidFunction( 1.0, -1.0, 1.0 ), fn );
+	addFunction( list, "RampFunction", new RampFunction( -1.0, 1.0 ), fn );
+	addFunction( list, "LinearFunction", new LinearFunction( 1.0, 0.0 ), fn );
+	addFunction( list, "StepFunction", new StepFunction(), fn );
+	addFunction( list, "LeakyIntegratorFunction", new LeakyIntegratorFunction( leak ), fn );
+	addFunction( list, "LogLikeFunction", new LogLikeFunction(), fn );
+	addFunction( list, "PoolFunction", new PoolFunction( SigmoidFunction( 1.0 ), fn ), fn );
+	addFunction( list, "CompositeFunction", new CompositeFunction( SigmoidFunction( 1.0 ), LinearFunction( 2.0, 0.0 ) ), fn );
+	addFunction( list, "LinearComboFunction", new LinearComboFunction( 0.5, SigmoidFunction( 1.0 ), 0.5, IdentityFunction() ), fn );
+	addFunction( list, "GaussFunction", new GaussFunction(), fn );
+	addFunction( list, "PseudoGaussFunction", new PseudoGaussFunction(), fn );
+	addFunction( list, "SawtoothFunction", new SawtoothFunction(), fn );
+	addFunction( list, "SinFunction", new SinFunction(), fn );
+	addFunction( list, "TriangleFunction", new TriangleFunction(), fn );
+	addFunction( list, "WinnerTakeAllFunction", new WinnerTakeAllFunction(), fn );
+	for( u_int i=0; i<nv; i++ ) {
+		const u_int n = nsizes[i];
+		list.push_back( new netStep( n ) );
+		list.push_back( new netBackprop( n ) );
+		list.push_back( new netSave( n ) );
+		list.push_back( new netLoad( n ) );
+	}
+	// --- the weights of these nets are far bigger than the caches: the step is bound by the memory
+	const u_int pn = quick ? 512 : 1024;
+	const size_t big = 256*1024;
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[first-touch]", pn, MemoryPolicy() ) );
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[transparent-huge-pages]", pn,
+		MemoryPolicy( MemoryPolicy::FirstTouch, 0, MemoryPolicy::TransparentHugePages, big ) ) );
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[huge-pages]", pn,
+		MemoryPolicy( MemoryPolicy::FirstTouch, 0, MemoryPolicy::HugePages, big ) ) );
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[local-node]", pn,
+		MemoryPolicy( MemoryPolicy::OnNode, MemoryPolicy::currentNode(), MemoryPolicy::SmallPages, big ) ) );
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[remote-node]", pn,
+		MemoryPolicy( MemoryPolicy::OnNode, MemoryPolicy::currentNode()+1, MemoryPolicy::SmallPages, big ) ) );
+	list.push_back( new netPlacedStep( "BaseNeuralNet::step[interleaved]", pn,
+		MemoryPolicy( MemoryPolicy::Interleaved, 0, MemoryPolicy::SmallPages, big ) ) );
+	list.push_back( new netEvaluate( "Evaluator::evaluate[unpinned]", pn, false ) );
+	list.push_back( new netEvaluate( "Evaluator::evaluate[pinned]", pn, true ) );
+	return list;
+}
+
+/*! write s as a JSON string */
+static void jsonString( FILE* f, const char* s ) {
+	fputc( '"', f );
+	for( ; *s; s++ ) {
+		if ( *s == '"' || *s == '\\' ) fputc( '\\', f );
+		fputc( *s, f );
+	}
+	fputc( '"', f );
+}
+
+static void writeJson( FILE* f, const std::vector<Result>& results ) {
+	fprintf( f, "{\n" );
+	fprintf( f, "  \"nnfw_version\": %d,\n", NNFW_VERSION );
+	fprintf( f, "  \"precision\": \"%s\",\n", sizeof(Real) == sizeof(double) ? "double" : "float" );
+#ifdef NNFW_USE_MKL
+	fprintf( f, "  \"mkl\": true,\n" );
+#else
+	fprintf( f, "  \"mkl\": false,\n" );
+#endif
+#ifdef NNFW_USE_GSL
+	fprintf( f, "  \"gsl\": true,\n" );
+#else
+	fprintf( f, "  \"gsl\": false,\n" );
+#endif
+#ifdef NNFW_DEBUG
+	fprintf( f, "  \"debug\": true,\n" );
+#else
+	fprintf( f, "  \"debug\": false,\n" );
+#endif
+	fprintf( f, "  \"numa_nodes\": %d,\n", MemoryPolicy::numNodes() );
+	fprintf( f, "  \"huge_page_size\": %lu,\n", (unsigned long)MemoryPolicy::hugePageSize() );
+	fprintf( f, "  \"free_huge_pages\": %d,\n", MemoryPolicy::freeHugePages() );
+	fprintf( f, "  \"transparent_huge_pages\": %s,\n", MemoryPolicy::transparentHugePagesEnabled() ? "true" : "false" );
+	fprintf( f, "  \"min_time_ms\": %d,\n", minTimeUs/1000 );
+	fprintf( f, "  \"benchmarks\": [" );
+	for( u_int i=0; i<results.size(); i++ ) {
+		const Result& r = results[i];
+		fprintf( f, "%s\n    { \"name\": ", ( i == 0 ) ? "" : "," );
+		jsonString( f, r.bench->name.c_str() );
+		fprintf( f, ", \"group\": \"%s\", \"size\": %u, \"iterations\": %u, "
+		            "\"best_ns\": %.2f, \"mean_ns\": %.2f }",
+		         r.bench->group, r.bench->size, r.iterations, r.bestNs, r.meanNs );
+	}
+	fprintf( f, "\n  ]\n}\n" );
+}
+
+static void usage() {
+	fprintf( stderr, "usage: nnfw-bench [--json file] [--filter text] [--quick] [--min-time ms]\n" );
+}
+
+int main( int argc, char** argv ) {
+	for( int i=1; i<argc; i++ ) {
+		if ( strcmp( argv[i], "--json" ) == 0 && i+1 < argc ) {
+			jsonFile = argv[++i];
+		} else if ( strcmp( argv[i], "--filter" ) == 0 && i+1 < argc ) {
+			filter = argv[++i];
+		} else if ( strcmp( argv[i], "--min-time" ) == 0 && i+1 < argc ) {
+			minTimeUs = atoi( argv[++i] )*1000;
+			if ( minTimeUs <= 0 ) minTimeUs = 1000;
+		} else if ( strcmp( argv[i], "--quick" ) == 0 ) {
+			quick = true;
+			minTimeUs = 20000;
+		} else {
+			usage();
+			return 1;
+		}
+	}
+	std::vector<Bench*> list = createBenchmarks();
+	std::vector<Result> results;
+	for( u_int i=0; i<list.size(); i++ ) {
+		if ( filter && list[i]->name.find( filter ) == std::string::npos ) continue;
+		Result r = measure( list[i] );
+		fprintf( stderr, "%-48s %14.1f ns  (%u iterations)\n", r.bench->name.c_str(), r.bestNs, r.iterations );
+		results.push_back( r );
+	}
+	remove( xmlFile );
+	FILE* f = stdout;
+	if ( jsonFile ) {
+		f = fopen( jsonFile, "w" );
+		if ( !f ) {
+			fprintf( stderr, "nnfw-bench: can't write %s\n", jsonFile );
+			return 1;
+		}
+	}
+	writeJson( f, results );
+	if ( jsonFile ) fclose( f );
+	for( u_int i=0; i<list.size(); i++ ) {
+		delete list[i];
+	}
+	return 0;
+}
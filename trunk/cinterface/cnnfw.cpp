@@ -74,6 +74,9 @@ typedef struct NnfwCluster {
 	Updatable* myup;
 	Cluster* cluster;
 	NnfwOutputFunction* func;
+	//--- views on the caller's arrays bound by NnfwClusterBindInputs/Outputs
+	RealVec boundins;
+	RealVec boundouts;
 } NnfwCluster;
 
 /*! enum of possible modality of copying */
@@ -157,8 +160,16 @@ C_NNFW_API void NnfwClusterRandomize( NnfwCluster* cl, Real min, Real max ) {
 }
 
 C_NNFW_API void NnfwClusterSetInputs( NnfwCluster* cl, Real* ins ) {
-	RealVec insr( ins, cl->cluster->numNeurons() );
-	cl->cluster->setInputs( insr );
+	memoryCopy( getRawData( cl->cluster->inputs() ), ins, cl->cluster->numNeurons() );
+}
+
+C_NNFW_API void NnfwClusterBindInputs( NnfwCluster* cl, Real* ins ) {
+	cl->boundins.convertToView( ins, cl->cluster->numNeurons() );
+	cl->cluster->bindInputs( cl->boundins );
+}
+
+C_NNFW_API void NnfwClusterUnbindInputs( NnfwCluster* cl ) {
+	cl->cluster->unbindInputs();
 }
 
 C_NNFW_API void NnfwClusterSetInput( NnfwCluster* cl, unsigned int neuron, Real value ) {
@@ -174,8 +185,16 @@ C_NNFW_API Real NnfwClusterInput( NnfwCluster* cl, unsigned int neuron ) {
 }
 
 C_NNFW_API void NnfwClusterSetOutputs( NnfwCluster* cl, Real* outs ) {
-	RealVec outsr( outs, cl->cluster->numNeurons() );
-	cl->cluster->setOutputs( outsr );
+	memoryCopy( getRawData( cl->cluster->outputs() ), outs, cl->cluster->numNeurons() );
+}
+
+C_NNFW_API void NnfwClusterBindOutputs( NnfwCluster* cl, Real* outs ) {
+	cl->boundouts.convertToView( outs, cl->cluster->numNeurons() );
+	cl->cluster->bindOutputs( cl->boundouts );
+}
+
+C_NNFW_API void NnfwClusterUnbindOutputs( NnfwCluster* cl ) {
+	cl->cluster->unbindOutputs();
 }
 
 C_NNFW_API void NnfwClusterSetOutput( NnfwCluster* cl, unsigned int neuron, Real value ) {
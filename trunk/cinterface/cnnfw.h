@@ -87,6 +87,12 @@ C_NNFW_API void NnfwClusterRandomize( NnfwCluster*, Real min, Real max );
  * \param ins is an array of at least NnfwClusterNumNeurons containing the inputs values
  */
 C_NNFW_API void NnfwClusterSetInputs( NnfwCluster*, Real* ins );
+/*! Use the array passed as the inputs of Cluster without copying it
+ * \param ins is an array of NnfwClusterNumNeurons values that must remain valid until NnfwClusterUnbindInputs
+ */
+C_NNFW_API void NnfwClusterBindInputs( NnfwCluster*, Real* ins );
+/*! Restore the inputs of Cluster bound by NnfwClusterBindInputs to its own memory */
+C_NNFW_API void NnfwClusterUnbindInputs( NnfwCluster* );
 /*! Set a single input of Cluster
  * \param neuron index of neuron of which to setup the input
  * \param value the value of input
@@ -98,6 +104,12 @@ C_NNFW_API Real* NnfwClusterInputs( NnfwCluster* );
 C_NNFW_API Real NnfwClusterInput( NnfwCluster*, unsigned int neuron );
 /*! */
 C_NNFW_API void NnfwClusterSetOutputs( NnfwCluster*, Real* outs );
+/*! Let the Cluster write its outputs directly into the array passed
+ * \param outs is an array of NnfwClusterNumNeurons values that must remain valid until NnfwClusterUnbindOutputs
+ */
+C_NNFW_API void NnfwClusterBindOutputs( NnfwCluster*, Real* outs );
+/*! Restore the outputs of Cluster bound by NnfwClusterBindOutputs to its own memory */
+C_NNFW_API void NnfwClusterUnbindOutputs( NnfwCluster* );
 /*! */
 C_NNFW_API void NnfwClusterSetOutput( NnfwCluster*, unsigned int neuron, Real value );
 /*! */
@@ -26,13 +26,19 @@
 #include "types.h"
 #include "learningalgorithm.h"
 #include <map>
+#include <algorithm>
 
 namespace nnfw {
 
 class AbstractModifier;
+class SharedTraining;
 
 /*! \brief Back-Propagation Algorithm implementation
  *
+ *  The frozen Clusters and Linkers (see Updatable::setFrozen), and those passed to dontLearn, are
+ *  not modified; the deltas are calculated only for the Clusters from which a modifiable Linker
+ *  or BiasedCluster can be reached, so training only the last layers of a net doesn't propagate
+ *  the errors down to the inputs.
  */
 class NNFW_API BackPropagationAlgo : public LearningAlgorithm {
 public:
@@ -63,15 +69,38 @@ public:
 	void dontLearn( Cluster* cluster );
 	/*! Don't modify weight about that Linker */
 	void dontLearn( Linker* linker );
+	/*! Modify again the Cluster passed to dontLearn */
+	void doLearn( Cluster* cluster );
+	/*! Modify again the Linker passed to dontLearn */
+	void doLearn( Linker* linker );
 
 	virtual void learn();
 
-	/*! Starts a single training step. */
+	/*! Starts a single training step.<br>
+	 *  The input Clusters without incoming Linkers are bound to the inputs of the Pattern instead of
+	 *  copying them (see Cluster::bindInputs); nothing writes into the inputs of such Clusters, so the
+	 *  Pattern is only read. The Clusters are unbound before returning */
 	virtual void learn( const Pattern& );
 
-	/*! Calculate the Mean Square Error respect to Pattern passed */
+	/*! Calculate the Mean Square Error respect to Pattern passed; the inputs are bound like learn does */
 	virtual Real calculateMSE( const Pattern& );
 
+	using LearningAlgorithm::learnOnSet;
+	using LearningAlgorithm::calculateMSEOnSet;
+
+	/*! Learn all the patterns of the DataSet; the input Clusters are bound once to the rows of the
+	 *  DataSet, and each pattern only moves the views, so no memory is allocated per pattern */
+	virtual void learnOnSet( const DataSet& set );
+
+	/*! Calculate the Mean Square Error on the DataSet, binding the inputs once like learnOnSet */
+	virtual Real calculateMSEOnSet( const DataSet& set );
+
+	/*! Learn all the patterns of the PatternStream; the inputs are bound once for each batch */
+	virtual void learnOnSet( PatternStream& stream );
+
+	/*! Calculate the Mean Square Error on the PatternStream; the inputs are bound once for each batch */
+	virtual Real calculateMSEOnSet( PatternStream& stream );
+
 	/*! Set the learning rate */
 	void setRate( Real newrate ) {
 		learn_rate = newrate;
@@ -100,6 +129,15 @@ public:
 		useMomentum = false;
 	};
 
+	/*! Train together with other processes (see SharedTraining): after each learning step
+	 *  SharedTraining::stepDone is called, which exchanges the parameters of the net with the other
+	 *  processes every SharedTraining::syncEvery steps. Zero, the default, trains alone.<br>
+	 *  The SharedTraining is not owned by the BackPropagationAlgo
+	 */
+	void setSharedTraining( SharedTraining* shared ) {
+		sharedTraining = shared;
+	};
+
 	/*! This method returns the deltas calculated by the Back-propagation Algorithm.
 	 *  These deltas are set every time new targets are defined for the output layer(s),
 	 *  which are then used to update network weights when the method learn() is called.<br>
@@ -138,9 +176,17 @@ private:
 	Real useMomentum;
 	//! The update order
 	UpdatableVec update_order;
+	//! the group of processes training together, if any
+	SharedTraining* sharedTraining;
+	//! true while learning a set, when the input Clusters stay bound between the patterns
+	bool keepBound;
 	//! Flags for Cluster
 	std::map<Cluster*, bool> learnableClusters;
 	std::map<Linker*, bool> learnableLinkers;
+	//! true when dontLearn or doLearn changed the flags after the last updateLearnables
+	bool learnablesDirty;
+	//! the value of Updatable::frozenChanges seen by the last updateLearnables
+	int frozenSeen;
 
 	//! The struct of Clusters and Deltas
 	class NNFW_API cluster_deltas {
@@ -148,12 +194,44 @@ private:
 		Cluster* cluster;
 		AbstractModifier* modcluster;
 		bool isOutput;
+		//! true if it's a BiasedCluster
+		bool hasBiases;
+		//! true if the biases are modified
+		bool learnCluster;
+		//! true if the deltas of inputs are needed
+		bool needDeltas;
+		VectorData<bool> learnLinkers;
 		RealVec deltas_outputs;
 		RealVec deltas_inputs;
 		RealVec last_deltas_inputs;
 		LinkerVec incoming_linkers_vec;
 		VectorData<AbstractModifier*> incoming_modlinkers;
 		VectorData<RealVec> incoming_last_outputs;
+		//! a vector of -1 used as input when learning the biases
+		RealVec minus_ones;
+		//! exchange the contents with cd without copying the data
+		void swap( cluster_deltas& cd ) {
+			std::swap( cluster, cd.cluster );
+			std::swap( modcluster, cd.modcluster );
+			std::swap( isOutput, cd.isOutput );
+			std::swap( hasBiases, cd.hasBiases );
+			std::swap( learnCluster, cd.learnCluster );
+			std::swap( needDeltas, cd.needDeltas );
+			learnLinkers.swap( cd.learnLinkers );
+			deltas_outputs.swap( cd.deltas_outputs );
+			deltas_inputs.swap( cd.deltas_inputs );
+			last_deltas_inputs.swap( cd.last_deltas_inputs );
+			incoming_linkers_vec.swap( cd.incoming_linkers_vec );
+			incoming_modlinkers.swap( cd.incoming_modlinkers );
+			incoming_last_outputs.swap( cd.incoming_last_outputs );
+			minus_ones.swap( cd.minus_ones );
+		};
+		//! used by VectorData when it grows; the entries are swapped instead of copied
+		friend void memoryMove( cluster_deltas* dest, cluster_deltas* src, unsigned int size ) {
+			for( unsigned int i=0; i<size; i++ ) {
+				dest[i].swap( src[i] );
+			}
+		};
 	};
 	//! map to help looking for cluster_deltas info
 	std::map<Cluster*, int> mapIndex;
@@ -163,6 +241,13 @@ private:
 	void addCluster( Cluster*, bool );
 	// --- add a Linker into the structures above
 	void addLinker( Linker* );
+	// --- find what is modified and where deltas are needed, following frozen flags and dontLearn;
+	// --- it's called by learn() only when they changed
+	void updateLearnables();
+	// --- bind the input Clusters to the data of the Pattern, or copy them when it's not possible
+	void bindInputs( const Pattern& );
+	// --- restore the input Clusters bound by bindInputs
+	void unbindInputs();
 
 };
 
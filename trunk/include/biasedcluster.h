@@ -73,6 +73,12 @@ public:
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
+    /*! Append tempdata, used by update() */
+    void workingMemory( std::vector<RealVec*>& buffers );
+
     /*! Set the bias of the neuron
      */
     void setBias( u_int neuron, Real bias );
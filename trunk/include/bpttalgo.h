@@ -0,0 +1,236 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef BPTTALGO_H
+#define BPTTALGO_H
+
+/*! \file
+ *  \brief This file contains the BPTTAlgo Class; Truncated Back-Propagation Through Time
+ */
+
+#include "types.h"
+#include "learningalgorithm.h"
+#include <map>
+
+namespace nnfw {
+
+class BiasedCluster;
+class GatedCluster;
+class DotLinker;
+class LeakyIntegratorFunction;
+class DerivableOutputFunction;
+
+/*! \brief Truncated Back-Propagation Through Time
+ *
+ *  \par Motivation
+ *  BackPropagationAlgo treats the net as feedforward, so recurrent nets built with CopyLinker,
+ *  DDECluster or LeakyIntegratorFunction can't be trained on sequences.
+ *  \par Description
+ *  BPTTAlgo spreads the net step by step recording the inputs and the outputs of all Clusters into
+ *  ring buffers allocated at construction. Every window steps the errors are propagated backward
+ *  through the recorded steps, following BaseNeuralNet::order() in reverse, and the biases and the
+ *  weights are modified once with the gradients accumulated over the whole window; the weights of
+ *  each DotLinker are changed with a single matrix product (see RealMat::batchDeltarule).<br>
+ *  The value read by a Linker comes from the current step if its source Cluster precedes it into
+ *  the order, otherwise from the previous step; in the same way, what a Linker writes is used by
+ *  the next update of its destination Cluster. So the recurrences are deduced from the order:
+ *  \code
+ *  // --- Elman net: context is updated first and receives the hidden outputs at the end of the step
+ *  net->setOrder( in, context, l1, lctx, hidden, l2, out, copyHiddenToContext );
+ *  BPTTAlgo bptt( net, 10, 0.1 );
+ *  for( int epoch=0; epoch<1000; epoch++ ) {
+ *      bptt.learnOnSet( aSequence );
+ *  }
+ *  \endcode
+ *  The gradient flows through DotLinker, through CopyLinker in In2In and Out2In mode, through the
+ *  previous outputs of Clusters with a LeakyIntegratorFunction, through the past outputs used
+ *  by DDECluster and through the gates and the internal state of GatedCluster (LSTMCluster, GRUCluster);
+ *  the weights of a GatedCluster are changed with a single matrix product as for DotLinker.
+ *  The frozen Clusters and Linkers (see Updatable::setFrozen) are not modified.
+ *  \par Warnings
+ *  Other Linkers, and CopyLinker in In2Out or Out2Out mode, don't propagate the gradient.<br>
+ *  The internal state of the net (context inputs, LeakyIntegratorFunction, DDECluster, GatedCluster) is not reset
+ *  at the start of a sequence; the gradient never flows beyond the start of the window.
+ */
+class NNFW_API BPTTAlgo : public LearningAlgorithm {
+public:
+	/*! \name Constructors */
+	//@{
+
+	/*! Constructor
+	 *  \param net the neural network to train; its structure can't change after this constructor
+	 *  \param window the number of steps of truncation
+	 *  \param rate the learning rate
+	 */
+	BPTTAlgo( BaseNeuralNet* net, u_int window, Real rate = 0.1f );
+
+	/*! Destructor */
+	~BPTTAlgo();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Return the number of steps of truncation */
+	u_int window() const {
+		return winsize;
+	};
+
+	/*! Set the learning rate */
+	void setRate( Real newrate ) {
+		learn_rate = newrate;
+	};
+
+	/*! return the learning rate */
+	Real rate() const {
+		return learn_rate;
+	};
+
+	/*! Don't modify the biases of that Cluster (and the weights, if it is a GatedCluster) */
+	void dontLearn( Cluster* cluster );
+	/*! Don't modify the weights of that Linker */
+	void dontLearn( Linker* linker );
+
+	/*! Spread the net of one step recording the activities */
+	void step();
+
+	/*! Set the teaching input of the output Cluster passed for the last recorded step */
+	void setTeachingInput( Cluster* output, const RealVec& ti );
+
+	/*! Return the number of steps recorded and not yet learned */
+	u_int recordedSteps() const {
+		return nsteps;
+	};
+
+	/*! Forget the steps recorded and not yet learned; the next step starts a new sequence */
+	void reset();
+
+	/*! Propagate the errors through the steps recorded and modify the net, even if they are less than window */
+	virtual void learn();
+
+	/*! Set the inputs, step the net and set the teaching inputs of Pattern passed;
+	 *  the net is modified every window steps */
+	virtual void learn( const Pattern& );
+
+	/*! Spread the net without recording it and return the Mean Square Error respect to Pattern passed
+	 *  \warning the steps recorded and not yet learned are forgotten */
+	virtual Real calculateMSE( const Pattern& );
+
+	/*! Learn the PatternSet as a sequence; it starts a new sequence and learns the last partial window */
+	virtual void learnOnSet( const PatternSet& set );
+
+	/*! Learn the DataSet as a sequence; it starts a new sequence and learns the last partial window */
+	virtual void learnOnSet( const DataSet& set );
+
+	/*! Learn the patterns of PatternStream as a sequence; it starts a new sequence and learns the last partial window */
+	virtual void learnOnSet( PatternStream& stream );
+
+	//@}
+
+private:
+	/*! The recorded history and the deltas of a Cluster */
+	class clusterInfo {
+	public:
+		Cluster* cluster;
+		/*! position into order, -1 if it's not updated */
+		int pos;
+		/*! inputs and outputs of last window+1 steps, indexed by step modulo window+1 */
+		RealMat* ins;
+		RealMat* outs;
+		/*! deltas of outputs for each step of window */
+		RealMat* dOuts;
+		/*! deltas of inputs for each step of window */
+		RealMat* dIns;
+		/*! errors respect to teaching inputs for each step of window; NULL if it's not an output */
+		RealMat* errs;
+		/*! derivatives of the OutputFunction */
+		RealVec* diff;
+		/*! accumulated gradient of the biases; NULL if they are not learned (for a GatedCluster, also the weights) */
+		RealVec* bgrad;
+		BiasedCluster* biased;
+		/*! the OutputFunction if it's derivable */
+		const DerivableOutputFunction* deriv;
+		/*! not NULL if the OutputFunction is a LeakyIntegratorFunction */
+		LeakyIntegratorFunction* leaky;
+		/*! true if the outputs are the inputs (FakeCluster) */
+		bool identity;
+		/*! DDECluster: coefficients of f(x) and x, and of the past outputs */
+		bool isDDE;
+		Real ddeF;
+		Real ddeX;
+		RealVec* ddePast;
+		/*! DDECluster: f(x) recalculated for the derivative */
+		RealVec* fx;
+		/*! GatedCluster: internal state of last window+1 steps, indexed as ins and outs */
+		GatedCluster* gated;
+		RealMat* states;
+		/*! GatedCluster: inputs followed by the previous outputs, and deltas of the gates, for each step of window */
+		RealMat* xhs;
+		RealMat* dzs;
+		/*! GatedCluster: deltas of internal state carried to the previous step, and deltas of xh */
+		RealVec* dState;
+		RealVec* dxh;
+	};
+	/*! The Linker propagating the deltas */
+	class linkerInfo {
+	public:
+		Linker* linker;
+		int pos;
+		/*! index into clusters of from() and to() */
+		int from;
+		int to;
+		DotLinker* dot;
+		/*! for CopyLinker: true if it reads the inputs of from (In2In) */
+		bool copyFromIns;
+		u_int copySize;
+		/*! for DotLinker: outputs of from and deltas of to for each step of window; NULL if it's not learned */
+		RealMat* xs;
+		RealMat* ds;
+	};
+
+	Real learn_rate;
+	u_int winsize;
+	/*! number of rows of history: window+1 */
+	u_int hsize;
+	/*! index of the next step into history */
+	u_int tnext;
+	/*! number of steps recorded into the current window */
+	u_int nsteps;
+	VectorData<clusterInfo> cls;
+	VectorData<linkerInfo> lks;
+	std::map<Cluster*, int> clsIndex;
+	std::map<Linker*, int> lksIndex;
+	/*! for each position into order, the index into cls or lks (-1 otherwise) */
+	VectorData<int> ordCls;
+	VectorData<int> ordLks;
+
+	/*! record the activities of cluster i into history row */
+	void record( int i, u_int row );
+	/*! the spread of the deltas of step k of window */
+	void backwardCluster( clusterInfo& ci, int k, u_int row );
+	void backwardLinker( linkerInfo& li, int k, u_int start );
+	/*! Forbidden copy-constructor */
+	BPTTAlgo( const BPTTAlgo& );
+	/*! Forbidden assignment */
+	BPTTAlgo& operator=( const BPTTAlgo& );
+};
+
+}
+
+#endif
@@ -235,6 +235,43 @@ public:
         return true;
     };
 
+    //@}
+    /*! \name Binding to external memory */
+    //@{
+
+    /*! Bind the inputs of this Cluster to the data of src without copying them<br>
+     *  After this call inputs() is a view of src, so every read and write on the inputs of the Cluster
+     *  (including resetInputs and the accumulation of Linkers) acts directly on src.
+     *  The binding lasts until unbindInputs is called; src must outlive it.
+     *  \return false, leaving the inputs untouched, if the size of src differs from numNeurons()
+     */
+    bool bindInputs( RealVec& src );
+
+    /*! Restore the inputs to the memory owned by this Cluster<br>
+     *  The values held by the bound memory are not copied back
+     */
+    void unbindInputs();
+
+    /*! Return true if the inputs are bound to external memory */
+    bool isInputsBound() const {
+        return insBound;
+    };
+
+    /*! Bind the outputs of this Cluster to the data of src without copying them<br>
+     *  After this call the OutputFunction will write directly into src at every update.
+     *  The binding lasts until unbindOutputs is called; src must outlive it.
+     *  \return false, leaving the outputs untouched, if the size of src differs from numNeurons()
+     */
+    virtual bool bindOutputs( RealVec& src );
+
+    /*! Restore the outputs to the memory owned by this Cluster */
+    virtual void unbindOutputs();
+
+    /*! Return true if the outputs are bound to external memory */
+    bool isOutputsBound() const {
+        return outsBound;
+    };
+
     //@}
     /*! \name Operations on OutputFunction */
     //@{
@@ -251,6 +288,9 @@ public:
         return updater;
     };
 
+    /*! Estimate the cost of applying the output function to all neurons */
+    virtual void updateCost( double& flops, double& bytes ) const;
+
     /*! read property 'outfunction' */
     Variant getFunctionP() {
         return Variant( updater );
@@ -278,10 +318,18 @@ protected:
 private:
     /*! Number of neurons */
     u_int numneurons;
+    /*! Memory owned for the inputs, viewed by inputdata when not bound */
+    RealVec inputstore;
+    /*! Memory owned for the outputs, viewed by outputdata when not bound */
+    RealVec outputstore;
     /*! Input of neurons */
     RealVec inputdata;
     /*! Output of neurons */
     RealVec outputdata;
+    /*! True if inputdata is bound to external memory */
+    bool insBound;
+    /*! True if outputdata is bound to external memory */
+    bool outsBound;
     /*! OutputFunction Object */
     OutputFunction* updater;
 
@@ -95,6 +95,9 @@ public:
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
     /*! Returns the number of neurons connected
      */
     u_int size() const;
@@ -38,7 +38,10 @@ namespace nnfw {
  *    Note: L'attivazione delta alla 'Stefano' e' possibile ottenerla configurando i coefficienti nel seguente modo:<br>
  *    a0 <- 0.0 ; a1 <- delta ; a2 <- 0.0 ; a3 <- 1.0-delta <br>
  *    ottenendo: <br>
- *    y(t) <- (delta)*f(x) + (1.0-delta)*y(t-1)
+ *    y(t) <- (delta)*f(x) + (1.0-delta)*y(t-1) <br>
+ *    The derivatives are backward differences (y'(t-1) = y(t-1) - y(t-2), and so on), so the equation is
+ *    expanded into a linear combination of the past outputs (see pastCoeff) kept into a ring of history
+ *    vectors; each update is a single pass over the neurons and doesn't copy any history vector.
  *  \par Warnings
  *
  *   <table class="proptable">
@@ -93,10 +96,23 @@ public:
      */
     Variant getCoeffP();
 
+    /*! Return the coefficients of the past outputs: the terms a3*y(t-1) + a4*y'(t-1) + ... are
+     *  expanded into pastCoeff()[0]*y(t-1) + pastCoeff()[1]*y(t-2) + ...
+     */
+    const RealVec& pastCoeff() const {
+        return pcoeff;
+    };
+
     /*! Update the outputs of neurons
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
+    /*! Append the history vectors and tmpdata, used by update() */
+    void workingMemory( std::vector<RealVec*>& buffers );
+
     /*! Randomize Nothing ;-)
      */
     void randomize( Real, Real ) { /* Nothing To Do */ };
@@ -109,17 +125,14 @@ public:
 private:
     /*! Coefficient of equation */
     RealVec coeff;
-    /*! Derivates of output */
-    VectorData< RealVec > ds;
+    /*! Coefficients of the past outputs */
+    RealVec pcoeff;
+    /*! Past outputs y(t-1), y(t-2), ... */
+    VectorData< RealVec > history;
+    /*! Ring of pointers to history: ring[j] points to y(t-1-j) */
+    VectorData< RealVec* > ring;
     /*! temporary data for calculation */
     RealVec tmpdata;
-    /*! temporary data for calculation */
-    RealVec tmpdata2;
-
-    /*! Update the derivates of output */
-    void updateDs();
-    /*! Break the update calculates */
-    void breakUpdate();
 
     /*! property definitions */
     void propdefs();
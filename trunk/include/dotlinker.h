@@ -29,6 +29,18 @@
 namespace nnfw {
 
 /*! \brief DotLinker Class
+ *
+ *  \par Description
+ *  Add to the inputs of to() the product of the outputs of from() and the weight matrix.
+ *  \par Incremental mode
+ *  When only a few outputs of from() change between steps (as the sensors into a control loop),
+ *  the incremental mode (see setIncremental) keeps the product calculated at the previous step
+ *  and adds to it (x[j] - xold[j]) * W[j,:] only for the outputs changed more than a tolerance,
+ *  so the cost depends on the number of changes rather than on the size of the matrix. Every
+ *  given number of steps the product is recalculated from scratch to bound the drift.
+ *  \par Warnings
+ *  In incremental mode, after modifying the weights directly through matrix() it's necessary
+ *  to call weightsChanged(); the learning algorithms of nnfw already do that.
  *
  *   <table class="proptable">
  *   <tr><td class="prophead" colspan="5">Properties</td></tr>
@@ -64,10 +76,60 @@ public:
     /*! Performs the dot-product calculation */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
+    /*! Append lastx and contrib, used by update() */
+    void workingMemory( std::vector<RealVec*>& buffers );
+
+    /*! Enable or disable the incremental mode
+     *  \param b true for enabling
+     *  \param tolerance the outputs of from() changed less than tolerance are considered unchanged
+     *  \param fullEvery the number of steps after which the product is recalculated from scratch
+     */
+    void setIncremental( bool b, Real tolerance = 0.0, u_int fullEvery = 1000 );
+
+    /*! Return true if the incremental mode is enabled */
+    bool isIncremental() const {
+        return incremental;
+    };
+
+    /*! Return the tolerance of incremental mode */
+    Real incrementalTolerance() const {
+        return tolerance;
+    };
+
+    /*! Return the number of steps between two full calculations in incremental mode */
+    u_int fullUpdateInterval() const {
+        return fullEvery;
+    };
+
+    /*! Return the number of outputs of from() used by the last update; it's the number of
+     *  changed outputs in incremental mode, or all outputs when the product is fully calculated */
+    u_int lastChanges() const {
+        return changes;
+    };
+
+    /*! The next update recalculates the product from scratch */
+    void weightsChanged();
+
 	/*! Clone this DotLinker */
 	virtual DotLinker* clone() const;
 
     //@}
+
+private:
+    /*! true if incremental mode is enabled */
+    bool incremental;
+    Real tolerance;
+    u_int fullEvery;
+    /*! steps remaining before the next full calculation; zero forces it */
+    u_int countdown;
+    u_int changes;
+    /*! outputs of from() used for calculating contrib */
+    RealVec lastx;
+    /*! product of lastx and the weight matrix */
+    RealVec contrib;
 };
 
 }
@@ -0,0 +1,127 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef EVALUATOR_H
+#define EVALUATOR_H
+
+/*! \file
+ *  \brief This file contains the Evaluator Class; it evaluates a net over a whole set of patterns in parallel
+ */
+
+#include "types.h"
+#include "learningalgorithm.h"
+
+namespace nnfw {
+
+class EvaluatorPrivate;
+
+/*! \brief Evaluator Class. Parallel evaluation of a BaseNeuralNet over a PatternSet or a DataSet
+ *
+ *  \par Motivation
+ *  Calculating the error on a big validation set pattern by pattern takes as long as a training epoch.
+ *  \par Description
+ *  Evaluator splits the patterns among some threads; each thread spreads its own clone of the net,
+ *  so the net passed is never touched during the evaluation. The clones are created at the first
+ *  evaluation and then only the free parameters (see BaseNeuralNet::parameterBlocks) are copied
+ *  from the net at each call. The errors are accumulated in a single pass over the outputs without
+ *  allocating memory:
+ *  \code
+ *  Evaluator eval( net );
+ *  Evaluator::Metrics m = eval.evaluate( validationSet );
+ *  printf( "mse %f max error %f accuracy %f\n", m.mse, m.maxError, m.accuracy );
+ *  \endcode
+ *  The patterns are grouped into blocks of fixed size and the partial results of each block are
+ *  summed in order, so the metrics don't depend on the number of threads.<br>
+ *  The inputs of a DataSet are bound to the input Clusters of the clones (see Cluster::bindInputs)
+ *  instead of being copied.
+ *  \par Warnings
+ *  Each pattern is evaluated by a clone that has just spread the previous pattern of the same block;
+ *  for nets with internal state (DDECluster, recurrent CopyLinker) the metrics can differ from a
+ *  sequential evaluation.<br>
+ *  Call rebuild after changing the structure of the net, or any property other than biases and weights.
+ */
+class NNFW_API Evaluator {
+public:
+	/*! \name Nested Structures */
+	//@{
+	/*! The metrics calculated by evaluate */
+	class Metrics {
+	public:
+		/*! Mean Square Error, calculated like BackPropagationAlgo::calculateMSEOnSet */
+		Real mse;
+		/*! maximum absolute difference between an output and its target */
+		Real maxError;
+		/*! fraction of patterns correctly classified; a pattern is correct if, for each output Cluster,
+		 *  the most active output is the same as the target's one (for single neuron Clusters, if both
+		 *  are above or below 0.5) */
+		Real accuracy;
+		/*! number of patterns evaluated */
+		u_int count;
+	};
+	//@}
+	/*! \name Constructors */
+	//@{
+
+	/*! Construct an Evaluator of net using numThreads threads; zero means the number of processors */
+	Evaluator( BaseNeuralNet* net, u_int numThreads = 0 );
+
+	/*! Destructor */
+	~Evaluator();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Return the number of threads used */
+	u_int numThreads() const;
+
+	/*! Evaluate the net over all patterns of set */
+	Metrics evaluate( const PatternSet& set );
+
+	/*! Evaluate the net over all patterns of set */
+	Metrics evaluate( const DataSet& set );
+
+	/*! Destroy the clones of the net; they will be created again at the next evaluation */
+	void rebuild();
+
+	/*! Enable or disable the pinning of the threads to the NUMA nodes: the threads are divided
+	 *  among the nodes, each one runs only on the processors of its node and the free parameters
+	 *  of its clone are placed on the same node (see BaseNeuralNet::setMemoryPolicy, the page size
+	 *  and minBytes of the policy of the net are kept). The first thread is the calling one and it
+	 *  isn't pinned; its clone is placed on the node where it's running.<br>
+	 *  It has no effect on machines with a single node. The clones are created again
+	 */
+	void setNumaPinning( bool enable );
+
+	/*! Return true if the threads are pinned to the NUMA nodes */
+	bool numaPinning() const;
+
+	//@}
+
+private:
+	EvaluatorPrivate* prv;
+	/*! Forbidden copy-constructor */
+	Evaluator( const Evaluator& );
+	/*! Forbidden assignment */
+	Evaluator& operator=( const Evaluator& );
+};
+
+}
+
+#endif
@@ -82,10 +82,21 @@ public:
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
     /*! Randomize ?!?! it do nothings
      */
     void randomize( Real min, Real max );
 
+    /*! The outputs are an alias of inputs, so this binds the inputs
+     */
+    bool bindOutputs( RealVec& src );
+
+    /*! The outputs are an alias of inputs, so this unbinds the inputs
+     */
+    void unbindOutputs();
+
 	/*! Clone this FakeCluster */
 	virtual FakeCluster* clone() const;
 
@@ -0,0 +1,215 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef GATEDCLUSTER_H
+#define GATEDCLUSTER_H
+
+/*! \file
+ *  \brief This file contains the declaration of GatedCluster class, the base of LSTMCluster and GRUCluster
+ */
+
+#include "types.h"
+#include "cluster.h"
+
+namespace nnfw {
+
+/*! \brief GatedCluster Class. Base class of recurrent Clusters whose units are controlled by gates
+ *
+ *  \par Motivation
+ *  Building gated recurrent units from many small Clusters and DotLinkers costs many tiny matrix-vector
+ *  products and update() calls for each step.
+ *
+ *  \par Description
+ *  A GatedCluster with n neurons and G gates holds all the weights of its gates into a single matrix
+ *  of 2n rows and G*n columns: the first n rows multiply the inputs of the Cluster, the last n rows
+ *  multiply the outputs of the previous step. The columns from g*n to (g+1)*n are the weights of the
+ *  g-th gate. At each update the preactivations of all gates are calculated with one matrix-vector
+ *  product, and then the subclass calculates the new outputs and the internal state with a single
+ *  pass over the neurons (see pointwise).<br>
+ *  The OutputFunction is not used.<br>
+ *  GatedCluster can be trained by BPTTAlgo, that uses the method backward.
+ *
+ *   <table class="proptable">
+ *   <tr><td class="prophead" colspan="5">Properties</td></tr>
+ *   <tr><th>Name</th> <th>Type [isVector]</th> <th>Access mode</th> <th>Description</th> <th>Class</th></tr>
+ *   <tr><td>typename</td> <td>string</td> <td>read-only</td> <td> Class's type </td> <td>Propertized</td> </tr>
+ *   <tr><td>name</td> <td>string</td> <td>read/write</td> <td> name of the object </td> <td>Updatable</td> </tr>
+ *   <tr><td>accumulate</td> <td>boolean</td> <td>read/write</td> <td> if inputs are accumulated </td> <td>Cluster</td> </tr>
+ *   <tr><td>inputs</td> <td>RealVec</td> <td>read/write</td> <td> neuron's input </td> <td>Cluster</td> </tr>
+ *   <tr><td>outfunction</td> <td>OutputFunction</td> <td>read/write</td> <td> ignored </td> <td>Cluster</td> </tr>
+ *   <tr><td>outputs</td> <td>RealVec</td> <td>read/write</td> <td> neuron's output </td> <td>Cluster</td> </tr>
+ *   <tr><td>numNeurons</td> <td>unsigned int</td> <td>read-only</td> <td> number of neurons </td> <td>Cluster</td> </tr>
+ *   <tr><td>weights</td> <td>RealMat</td> <td>read/write</td> <td> weights of all gates </td> <td>this</td> </tr>
+ *   <tr><td>biases</td> <td>RealVec</td> <td>read/write</td> <td> biases of all gates </td> <td>this</td> </tr>
+ *   </table>
+ */
+class NNFW_API GatedCluster : public Cluster {
+public:
+    /*! \name Constructors */
+    //@{
+
+    /*! Construct a GatedCluster with numGates gates and an internal state of numStates values for each neuron
+     */
+    GatedCluster( u_int numNeurons, u_int numGates, u_int numStates, const char* name = "unnamed" );
+
+    /*! Construct by a PropertySettings
+     */
+    GatedCluster( PropertySettings& prop, u_int numGates, u_int numStates );
+
+    /*! Destructor
+     */
+    virtual ~GatedCluster();
+
+    //@}
+    /*! \name Interface */
+    //@{
+
+    /*! Update the outputs and the internal state
+     */
+    void update();
+
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
+    /*! Append xh, z and the internal state, used by update() */
+    void workingMemory( std::vector<RealVec*>& buffers );
+
+    /*! Return the number of gates
+     */
+    u_int numGates() const {
+        return ngates;
+    };
+
+    /*! Return the matrix of weights of all gates (2*numNeurons() x numGates()*numNeurons())
+     */
+    RealMat& weights() {
+        return w;
+    };
+
+    /*! Return the matrix of weights of all gates (const version)
+     */
+    const RealMat& weights() const {
+        return w;
+    };
+
+    /*! Set the matrix of weights of all gates
+     */
+    void setWeights( const RealMat& mat );
+
+    /*! read property 'weights' */
+    Variant getWeightsP() {
+        return Variant( &w );
+    };
+
+    /*! set property 'weights' */
+    bool setWeights( const Variant& v ) {
+        setWeights( *( v.getRealMat() ) );
+        return true;
+    };
+
+    /*! Return the biases of all gates (numGates()*numNeurons())
+     */
+    RealVec& biases() {
+        return b;
+    };
+
+    /*! Set the biases of all gates
+     */
+    void setBiases( const RealVec& bias );
+
+    /*! read property 'biases' */
+    Variant getBiasesP() {
+        return Variant( &b );
+    };
+
+    /*! set property 'biases' */
+    bool setBiases( const Variant& v ) {
+        setBiases( *( v.getRealVec() ) );
+        return true;
+    };
+
+    /*! Randomize the weights and the biases
+     */
+    void randomize( Real min, Real max );
+
+    /*! Return the size of internal state
+     */
+    u_int stateSize() const {
+        return st.size();
+    };
+
+    /*! Return the internal state calculated by the last update
+     */
+    RealVec& state() {
+        return st;
+    };
+
+    /*! Zeroing the outputs and the internal state; the next update starts a new sequence
+     */
+    void resetState();
+
+    /*! Put to zero the weights that don't exist in the structure of the units; it's called after
+     *  every modification of the weights done by this class, and it has to be called by learning
+     *  algorithms after changing the weights
+     */
+    virtual void constrainWeights() { /* all weights exist */ };
+
+    /*! Calculate the derivatives of one step for Back-Propagation Through Time
+     *  \param xh the inputs of the step followed by the outputs of the previous step
+     *  \param statePrev the internal state at the end of the previous step
+     *  \param state the internal state at the end of the step
+     *  \param dOut the derivatives respect to the outputs of the step
+     *  \param dState the derivatives respect to the internal state of the step; on return, respect to statePrev
+     *  \param dxh on return, the derivatives respect to xh
+     *  \param dz on return, the derivatives respect to the preactivations of the gates
+     */
+    virtual void backward( const RealVec& xh, const RealVec& statePrev, const RealVec& state,
+                           const RealVec& dOut, RealVec& dState, RealVec& dxh, RealVec& dz ) const = 0;
+
+    //@}
+
+protected:
+    /*! Calculate the new outputs and internal state from the preactivations of the gates z;
+     *  it's called by update and xh contains the inputs followed by the outputs of the previous step
+     */
+    virtual void pointwise( const RealVec& z, const RealVec& xh, RealVec& state, RealVec& outputs ) = 0;
+
+    /*! Copy weights, biases, state, inputs and outputs into the clone passed */
+    void copyInto( GatedCluster* clone ) const;
+
+private:
+    u_int ngates;
+    /*! weights of all gates */
+    RealMat w;
+    /*! biases of all gates */
+    RealVec b;
+    /*! inputs followed by the previous outputs */
+    RealVec xh;
+    /*! preactivations of all gates */
+    RealVec z;
+    /*! internal state */
+    RealVec st;
+
+    /*! define properties */
+    void propdefs();
+};
+
+}
+
+#endif
@@ -0,0 +1,92 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef GRUCLUSTER_H
+#define GRUCLUSTER_H
+
+/*! \file
+ *  \brief This file contains the declaration of GRUCluster class
+ */
+
+#include "types.h"
+#include "gatedcluster.h"
+
+namespace nnfw {
+
+/*! \brief GRUCluster Class. A layer of Gated Recurrent Units
+ *
+ *  \par Description
+ *  Each neuron is a Gated Recurrent Unit with update gate u and reset gate r:<br>
+ *  u = sigmoid(zu) ; r = sigmoid(zr) <br>
+ *  n = tanh( zx + r*zh ) <br>
+ *  y(t) <- (1-u)*n + u*y(t-1) <br>
+ *  The candidate n is splitted into the contribution of the inputs zx and the contribution of y(t-1) zh,
+ *  so that the reset gate is applied after the matrix product and all gates are calculated by the single
+ *  matrix-vector product of GatedCluster. Then the columns of the weights and the biases are ordered
+ *  as u, r, x, h; the weights from y(t-1) to x and from the inputs to h don't exist and they are kept
+ *  to zero.<br>
+ *  The internal state contains the values of u, r, n and zh of the last step.
+ *  \par Warnings
+ *  Use resetState() before presenting a new sequence
+ *
+ *  See GatedCluster for the properties
+ */
+class NNFW_API GRUCluster : public GatedCluster {
+public:
+    /*! \name Constructors */
+    //@{
+
+    /*! Construct a GRUCluster
+     */
+    GRUCluster( u_int numNeurons, const char* name = "unnamed" );
+
+    /*! Construct by PropertySettings
+     */
+    GRUCluster( PropertySettings& prop );
+
+    /*! Destructor
+     */
+    virtual ~GRUCluster();
+
+    //@}
+    /*! \name Interface */
+    //@{
+
+    /*! Put to zero the weights from y(t-1) to x and from the inputs to h
+     */
+    void constrainWeights();
+
+    /*! Derivatives of one step; see GatedCluster::backward
+     */
+    void backward( const RealVec& xh, const RealVec& statePrev, const RealVec& state,
+                   const RealVec& dOut, RealVec& dState, RealVec& dxh, RealVec& dz ) const;
+
+    /*! Clone this GRUCluster */
+    virtual GRUCluster* clone() const;
+
+    //@}
+
+protected:
+    /*! Fused calculation of gates, candidates and outputs */
+    void pointwise( const RealVec& z, const RealVec& xh, RealVec& state, RealVec& outputs );
+};
+
+}
+
+#endif
@@ -0,0 +1,99 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef LATENCYHISTOGRAM_H
+#define LATENCYHISTOGRAM_H
+
+/*! \file
+ *  \brief This file contains the LatencyHistogram Class
+ */
+
+#include "types.h"
+#include <vector>
+
+namespace nnfw {
+
+/*! \brief LatencyHistogram counts durations with a constant relative precision
+ *
+ *  \par Description
+ *  The durations are counted into buckets whose width grows with the value, like the HDR
+ *  histograms: each power of two of nanoseconds is divided into 128 linear sub-buckets, so
+ *  any percentile is known with a relative error lower than 1% from 1 nanosecond to several
+ *  minutes. The buckets are allocated by the constructor and record doesn't allocate memory,
+ *  so it can be used inside a real-time loop.<br>
+ *  The minimum, the maximum and the mean are exact.
+ *  \par Warnings
+ *  It's not thread-safe; each thread has to use its own LatencyHistogram.
+ */
+class NNFW_API LatencyHistogram {
+public:
+	/*! \name Constructors */
+	//@{
+
+	/*! Construct an empty histogram */
+	LatencyHistogram();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Count a duration expressed in seconds */
+	void record( double seconds );
+
+	/*! Discard all durations counted */
+	void reset();
+
+	/*! Return the number of durations counted */
+	unsigned long count() const {
+		return total;
+	};
+
+	/*! Return the shortest duration in seconds; zero if empty */
+	double min() const;
+
+	/*! Return the longest duration in seconds; zero if empty */
+	double max() const;
+
+	/*! Return the mean duration in seconds; zero if empty */
+	double mean() const;
+
+	/*! Return the duration in seconds that isn't exceeded by the percentage p of the durations
+	 *  counted (for example 50 for the median, 99 for the 99th percentile); the upper bound of
+	 *  the bucket is returned, so the value is never underestimated
+	 */
+	double percentile( double p ) const;
+
+	//@}
+
+private:
+	/*! counts of the buckets */
+	std::vector<unsigned long> buckets;
+	unsigned long total;
+	double minv;
+	double maxv;
+	double sum;
+	/*! return the bucket of ns nanoseconds */
+	static u_int bucketOf( double ns );
+	/*! return the upper bound in nanoseconds of the bucket i */
+	static double upperBound( u_int i );
+};
+
+}
+
+#endif
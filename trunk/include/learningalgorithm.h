@@ -31,6 +31,8 @@
 namespace nnfw {
 
 class BaseNeuralNet;
+class PatternStream;
+class Evaluator;
 
 /*! \brief Pattern object
  *
@@ -75,6 +77,22 @@ public:
 	//@{
 	/*! Construct an empty Pattern */
 	Pattern() : pinfo(), empty() { /*nothing to do*/ };
+	/*! Copy-Constructor; all the data are copied */
+	Pattern( const Pattern& src ) : pinfo( src.pinfo ), empty() { /*nothing to do*/ };
+	/*! Assignment operator; all the data are copied */
+	Pattern& operator=( const Pattern& src ) {
+		pinfo = src.pinfo;
+		return (*this);
+	};
+#if __cplusplus >= 201103L
+	/*! Move-Constructor; the data of src are taken without copying them */
+	Pattern( Pattern&& src ) noexcept : pinfo( std::move( src.pinfo ) ), empty() { /*nothing to do*/ };
+	/*! Move-Assignment; the data are exchanged with the ones of src */
+	Pattern& operator=( Pattern&& src ) noexcept {
+		pinfo.swap( src.pinfo );
+		return (*this);
+	};
+#endif
 	/*! Destructor */
 	~Pattern() { /*nothing to do*/ };
 
@@ -97,12 +115,34 @@ public:
 	 *  \warning it silently create a new one if the Cluster passed is not present */
 	PatternInfo& operator[]( Cluster* );
 
+	/*! remove all stored information */
+	void clear() {
+		pinfo.clear();
+	};
+
+	/*! exchange the stored information with the ones of p without copying them */
+	void swap( Pattern& p ) {
+		pinfo.swap( p.pinfo );
+	};
+
 	//@}
 private:
 	mutable std::map<Cluster*, PatternInfo> pinfo;
 	RealVec empty;
 };
 
+/*! Exchange the stored information of two Pattern without copying them */
+inline void swap( Pattern& a, Pattern& b ) {
+	a.swap( b );
+}
+
+/*! specialization of memoryMove for Pattern, so a PatternSet growing doesn't copy its Patterns */
+inline void memoryMove( Pattern* dest, Pattern* src, unsigned int size ) {
+	for( unsigned int i=0; i<size; i++ ) {
+		dest[i].swap( src[i] );
+	}
+}
+
 /*! \brief PatternSet object
  *
  *  \par Motivation
@@ -140,6 +180,131 @@ public:
 	//@}
 };
 
+/*! \brief DataSet object
+ *
+ *  \par Motivation
+ *  A PatternSet stores two separately allocated RealVec for each Cluster of each Pattern; a big dataset
+ *  becomes millions of small allocations scattered in memory, and copying it deep-copies everything.
+ *
+ *  \par Description
+ *  DataSet stores the data in columnar form: the inputs (and the outputs) of each Cluster for all patterns
+ *  are kept into one contiguous RealVec, accessible as a RealMat with one row per pattern:
+ *  \code
+ *  DataSet set( 1000 );
+ *  set.addInputsOf( anInputCluster );
+ *  set.addOutputsOf( anOutputCluster );
+ *  set.inputsOf( anInputCluster )[i].assign( someInputs );
+ *  set.outputsOf( anOutputCluster )[i][k] = 1.0;
+ *  //--- a Pattern whose RealVec are views on the i-th row (no copies)
+ *  const Pattern& pat = set[i];
+ *  \endcode
+ *  The LearningAlgorithm accept a DataSet directly in learnOnSet and calculateMSEOnSet.
+ *
+ *  \par Warnings
+ *  The Pattern returned by operator[] is shared and it's valid only until the next call of operator[];
+ *  use viewPattern for handling more Pattern at the same time.
+ */
+class NNFW_API DataSet {
+public:
+	/*! \name Constructors */
+	//@{
+	/*! Construct a DataSet of size patterns without data */
+	DataSet( u_int size );
+	/*! Construct a DataSet copying the inputs of input Clusters and the outputs of output Clusters
+	 *  of the net from the PatternSet passed */
+	DataSet( const PatternSet& set, BaseNeuralNet* net );
+	/*! Destructor */
+	~DataSet();
+	//@}
+	/*! \name Interface */
+	//@{
+	/*! Return the number of patterns */
+	u_int size() const {
+		return dim;
+	};
+	/*! Allocate the space for inputs of Cluster passed, for all patterns; data is initialized to zero */
+	void addInputsOf( Cluster* );
+	/*! Allocate the space for outputs of Cluster passed, for all patterns; data is initialized to zero */
+	void addOutputsOf( Cluster* );
+	/*! Return true if the DataSet has the inputs of Cluster passed */
+	bool hasInputsOf( Cluster* cl ) const {
+		return ins.count( cl ) > 0;
+	};
+	/*! Return true if the DataSet has the outputs of Cluster passed */
+	bool hasOutputsOf( Cluster* cl ) const {
+		return outs.count( cl ) > 0;
+	};
+	/*! Return the inputs of Cluster passed, one row for each pattern; the Cluster must be added with addInputsOf
+	 *  \warning the RealMat and its row views are created at the first call, so it takes time and memory
+	 *  proportional to the number of patterns; use inputsDataOf for filling a big DataSet */
+	RealMat& inputsOf( Cluster* cl ) {
+		return matrixOf( ins[cl], cl );
+	};
+	/*! Return the outputs of Cluster passed, one row for each pattern; the Cluster must be added with addOutputsOf
+	 *  \warning the RealMat is created at the first call, like inputsOf */
+	RealMat& outputsOf( Cluster* cl ) {
+		return matrixOf( outs[cl], cl );
+	};
+	/*! Return the inputs of Cluster passed for all patterns, one after the other into a contiguous RealVec;
+	 *  the Cluster must be added with addInputsOf */
+	RealVec& inputsDataOf( Cluster* cl ) {
+		return *( ins[cl].data );
+	};
+	/*! Return the outputs of Cluster passed for all patterns, one after the other into a contiguous RealVec;
+	 *  the Cluster must be added with addOutputsOf */
+	RealVec& outputsDataOf( Cluster* cl ) {
+		return *( outs[cl].data );
+	};
+	/*! Return the Clusters whose inputs are stored, in order of adding */
+	const ClusterVec& inputClusters() const {
+		return inscl;
+	};
+	/*! Return the Clusters whose outputs are stored, in order of adding */
+	const ClusterVec& outputClusters() const {
+		return outscl;
+	};
+	/*! Copy the data of Pattern passed into the i-th row */
+	void setPattern( u_int i, const Pattern& pat );
+	/*! Configure the Pattern passed as a view of the i-th row; the RealVec of the Pattern become views on
+	 *  the data of this DataSet, so moving it to another row doesn't allocate memory */
+	void viewPattern( u_int i, Pattern& pat ) const;
+	/*! Return a Pattern viewing the i-th row
+	 *  \warning the Pattern returned is shared and it'll change at next call */
+	const Pattern& operator[]( u_int i ) const {
+		viewPattern( i, cursor );
+		return cursor;
+	};
+	//@}
+private:
+	/*! data of one Cluster */
+	class block {
+	public:
+		RealVec* data;
+		/*! the RealMat viewing data; zero until inputsOf or outputsOf is called */
+		RealMat* mat;
+	};
+	/*! number of patterns */
+	u_int dim;
+	/*! inputs */
+	std::map<Cluster*, block> ins;
+	/*! outputs */
+	std::map<Cluster*, block> outs;
+	/*! Clusters with inputs */
+	ClusterVec inscl;
+	/*! Clusters with outputs */
+	ClusterVec outscl;
+	/*! the Pattern returned by operator[] */
+	mutable Pattern cursor;
+	/*! create a new block for Cluster passed */
+	block createBlock( Cluster* );
+	/*! return the RealMat of the block, creating it if necessary */
+	RealMat& matrixOf( block& b, Cluster* cl );
+	/*! Forbidden copy-constructor */
+	DataSet( const DataSet& );
+	/*! Forbidden assignment */
+	DataSet& operator=( const DataSet& );
+};
+
 /*! \brief LearningAlgorithm object
  *
  *  The LearningAlgorithm object is a the abstract class from which to implement learning algorithms
@@ -179,15 +344,9 @@ public:
 	/*! Calculate the Mean Square Error respect to Pattern passed */
 	virtual Real calculateMSE( const Pattern& ) = 0;
 	
-	/*! Calculate the Mean Square Error respect to all Patterns passed */
-	virtual Real calculateMSEOnSet( const PatternSet& set ) {
-		Real mseacc = 0.0;
-		int dim = (int)set.size();
-		for( int i=0; i<dim; i++ ) {
-			mseacc += calculateMSE( set[i] );
-		}
-		return mseacc/dim;
-	};
+	/*! Calculate the Mean Square Error respect to all Patterns passed; if the parallel evaluation
+	 *  is enabled the patterns are spread by an Evaluator */
+	virtual Real calculateMSEOnSet( const PatternSet& set );
 
 	/*! Calculate the Root Mean Square Deviation, i.e. the square root of MSE */
 	Real calculateRMSD( const Pattern& p ) {
@@ -199,10 +358,53 @@ public:
 		return sqrt( calculateMSEOnSet( p ) );
 	};
 
+    /*! Modify the object tring to learn all patterns present into DataSet passed */
+    virtual void learnOnSet( const DataSet& set ) {
+		for( int i=0; i<(int)set.size(); i++ ) {
+			learn( set[i] );
+		}
+	};
+
+	/*! Calculate the Mean Square Error respect to all Patterns of DataSet passed; if the parallel
+	 *  evaluation is enabled the patterns are spread by an Evaluator */
+	virtual Real calculateMSEOnSet( const DataSet& set );
+
+    /*! Modify the object tring to learn all patterns read from the PatternStream passed;
+	 *  it rewinds the stream and consumes one epoch; the next batch is decoded in background
+	 *  while the current one is learned */
+    virtual void learnOnSet( PatternStream& stream );
+
+	/*! Calculate the Mean Square Error respect to all Patterns read from the PatternStream passed */
+	virtual Real calculateMSEOnSet( PatternStream& stream );
+
+	/*! Calculate the Root Mean Square Deviation, i.e. the square root of MSE */
+	Real calculateRMSDOnSet( const DataSet& p ) {
+		return sqrt( calculateMSEOnSet( p ) );
+	};
+
+	/*! Enable the parallel evaluation of calculateMSEOnSet with numThreads threads (zero means
+	 *  the number of processors); each thread spreads a clone of the net, so the MSE is calculated
+	 *  from the outputs of the net regardless of calculateMSE
+	 *  \warning call it again after changing the structure of the net */
+	void enableParallelEvaluation( u_int numThreads = 0 );
+
+	/*! Disable the parallel evaluation */
+	void disableParallelEvaluation();
+
+	/*! Return the Evaluator used for the parallel evaluation, or NULL if it's disabled */
+	Evaluator* evaluator() {
+		return evalp;
+	};
+
 	//@}
 
 private:
 	BaseNeuralNet* netp;
+	Evaluator* evalp;
+	/*! Forbidden copy-constructor */
+	LearningAlgorithm( const LearningAlgorithm& );
+	/*! Forbidden assignment */
+	LearningAlgorithm& operator=( const LearningAlgorithm& );
 };
 
 }
@@ -212,6 +212,11 @@ public:
      */
     virtual void apply( RealVec& inputs, RealVec& outputs );
 
+    /*! Estimate of the operations for each neuron; an exponential counts as eight */
+    virtual double applyCost() const {
+        return 12.0;
+    };
+
     /*! return the approximation commonly used in backpropagation learning: x(1-x) */
     virtual void derivate( const RealVec& x, const RealVec& y, RealVec& d ) const;
 
@@ -341,6 +346,11 @@ public:
      */
     virtual void apply( RealVec& inputs, RealVec& outputs );
 
+    /*! Estimate of the operations for each neuron; an exponential counts as eight */
+    virtual double applyCost() const {
+        return 14.0;
+    };
+
     /*! return the approximation commonly used in backpropagation learning: x(1-x) */
     virtual void derivate( const RealVec& x, const RealVec& y, RealVec& d ) const;
 
@@ -203,6 +203,11 @@ public:
 	/*! Implement the Sin function */
 	virtual void apply( RealVec& inputs, RealVec& outputs );
 
+	/*! Estimate of the operations for each neuron; a sine counts as eight */
+	virtual double applyCost() const {
+	    return 12.0;
+	};
+
 	/*! Clone this object */
 	virtual SinFunction* clone() const;
 	
@@ -79,6 +79,11 @@ public:
 
     /*! Implement the Gaussian function */
     virtual void apply( RealVec& inputs, RealVec& outputs );
+
+    /*! Estimate of the operations for each neuron; an exponential counts as eight */
+    virtual double applyCost() const {
+        return 12.0;
+    };
     /*! derivate of Gauss function */
     virtual void derivate( const RealVec& x, const RealVec& y, RealVec& d ) const;
     /*! Clone this object */
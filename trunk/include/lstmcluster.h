@@ -0,0 +1,85 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef LSTMCLUSTER_H
+#define LSTMCLUSTER_H
+
+/*! \file
+ *  \brief This file contains the declaration of LSTMCluster class
+ */
+
+#include "types.h"
+#include "gatedcluster.h"
+
+namespace nnfw {
+
+/*! \brief LSTMCluster Class. A layer of Long Short-Term Memory units
+ *
+ *  \par Description
+ *  Each neuron is an LSTM unit with input gate i, forget gate f, cell candidate g and output gate o:<br>
+ *  i = sigmoid(zi) ; f = sigmoid(zf) ; g = tanh(zg) ; o = sigmoid(zo) <br>
+ *  c(t) <- f*c(t-1) + i*g <br>
+ *  y(t) <- o*tanh( c(t) ) <br>
+ *  where the preactivations [zi zf zg zo] are calculated by GatedCluster from the inputs and y(t-1).
+ *  The columns of the weights and the biases are ordered as i, f, g, o.<br>
+ *  The internal state contains c(t) followed by the values of i, f, g, o of the last step.
+ *  \par Warnings
+ *  Use resetState() before presenting a new sequence
+ *
+ *  See GatedCluster for the properties
+ */
+class NNFW_API LSTMCluster : public GatedCluster {
+public:
+    /*! \name Constructors */
+    //@{
+
+    /*! Construct a LSTMCluster
+     */
+    LSTMCluster( u_int numNeurons, const char* name = "unnamed" );
+
+    /*! Construct by PropertySettings
+     */
+    LSTMCluster( PropertySettings& prop );
+
+    /*! Destructor
+     */
+    virtual ~LSTMCluster();
+
+    //@}
+    /*! \name Interface */
+    //@{
+
+    /*! Derivatives of one step; see GatedCluster::backward
+     */
+    void backward( const RealVec& xh, const RealVec& statePrev, const RealVec& state,
+                   const RealVec& dOut, RealVec& dState, RealVec& dxh, RealVec& dz ) const;
+
+    /*! Clone this LSTMCluster */
+    virtual LSTMCluster* clone() const;
+
+    //@}
+
+protected:
+    /*! Fused calculation of gates, cells and outputs */
+    void pointwise( const RealVec& z, const RealVec& xh, RealVec& state, RealVec& outputs );
+};
+
+}
+
+#endif
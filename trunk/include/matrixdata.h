@@ -92,16 +92,49 @@ public:
         nrows = rows;
         ncols = cols;
         tsize = nrows*ncols;
-        rowView.resize( tsize );
+        rowView.resize( nrows );
         for( u_int i=0; i<nrows; i++ ) {
             rowView[i].convertToView( data, i*ncols, (i+1)*ncols );
         }
     };
 
+#if __cplusplus >= 201103L
+    /*! The Move-Constructor takes the data of src without copying them and leaves src empty;
+     *  if src is a view the data viewed are copied, so it may allocate and it's not declared noexcept
+     */
+    MatrixData( MatrixData&& src )
+        : Observer(), Observable(), data(), rowView() {
+        nrows = 0;
+        ncols = 0;
+        tsize = 0;
+        view = false;
+        if ( src.view ) {
+            resize( src.nrows, src.ncols );
+            assign( src );
+        } else {
+            swap( src );
+        }
+    };
+
+    /*! The Move-Assignment exchanges the data with src; when one of them is a view the data are
+     *  copied, so they must have the same dimensions
+     */
+    MatrixData& operator=( MatrixData&& src ) {
+        if ( view || src.view ) {
+            return assign( src );
+        }
+        swap( src );
+        return (*this);
+    };
+#endif
+
     /*! Destructor
      */
     ~MatrixData() {
-        // --- nothing to do
+        if ( view ) {
+            // --- the local data is going to be destroyed; it's not necessary to be notified
+            data.delObserver( this );
+        }
     };
 
     //@}
@@ -252,6 +285,32 @@ public:
         data.zeroing();
     };
 
+    /*! Exchange the data and the dimensions with the ones of b without copying them. The rows
+     *  follow the data: a view of a row of this matrix becomes a view of the same row of b.<br>
+     *  MatrixData views can't be swapped
+     */
+    void swap( MatrixData& b ) {
+        if ( view || b.view ) {
+            nError() << "It's not possible swap MatrixData views" ;
+            return;
+        }
+        if ( this == &b ) return;
+        data.swapData( b.data );
+        rowView.swapData( b.rowView );
+        u_int n = nrows;
+        nrows = b.nrows;
+        b.nrows = n;
+        n = ncols;
+        ncols = b.ncols;
+        b.ncols = n;
+        n = tsize;
+        tsize = b.tsize;
+        b.tsize = n;
+        // --- the rows are still views of the data of the other matrix
+        rebuildRows();
+        b.rebuildRows();
+    };
+
 
     //@}
     /*! \name STL compatibility */
@@ -408,6 +467,13 @@ private:
     /*! if is a MatrixData view */
     bool view;
 
+    /*! Make each row a view of the corresponding part of data */
+    void rebuildRows() {
+        for( u_int i=0; i<nrows; i++ ) {
+            rowView[i].convertToView( data, i*ncols, (i+1)*ncols );
+        }
+    };
+
     /*! Notify to viewers that 'data' is changed */
     virtual void notify( const NotifyEvent& event ) {
         switch( event.type() ) {
@@ -455,6 +521,13 @@ private:
 
 };
 
+
+/*! Exchange the data of two MatrixData without copying them (see MatrixData::swap) */
+template<class T, class Vec>
+inline void swap( MatrixData<T,Vec>& a, MatrixData<T,Vec>& b ) {
+    a.swap( b );
+}
+
 }
 
 #endif
@@ -76,13 +76,13 @@ public:
 
     /*!  Get the number of rows
      */
-    u_int rows() {
+    u_int rows() const {
         return nrows;
     };
 
     /*!  Get the number of cols
      */
-    u_int cols() {
+    u_int cols() const {
         return ncols;
     };
 
@@ -127,6 +127,11 @@ public:
      */
     bool setMatrix( const Variant& v );
 
+    /*!  Notify that the weights have been modified directly through matrix();
+     *   the subclasses caching values calculated from the weights (see DotLinker) recalculate them
+     */
+    virtual void weightsChanged() { /* Nothing to do */ };
+
     //@}
 
 private:
@@ -0,0 +1,137 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef MEMORYPOLICY_H
+#define MEMORYPOLICY_H
+
+/*! \file
+ *  \brief This file contains the MemoryPolicy Class; it places the big buffers on NUMA nodes and huge pages
+ */
+
+#include "types.h"
+#include "memutils.h"
+
+namespace nnfw {
+
+/*! \brief MemoryPolicy Class. Where and how the memory of big buffers is allocated
+ *
+ *  \par Motivation
+ *  On machines with more than one NUMA node the pages of a buffer are placed on the node of the
+ *  thread that touches them first, so the weights of a net created by one thread all live on a
+ *  single node; and the weight matrices of a big net cover so many 4K pages that the TLB can't
+ *  map them.
+ *  \par Description
+ *  A MemoryPolicy describes the placement of the pages and their size:
+ *  - FirstTouch leaves the placement to the operating system; OnNode prefers the node passed
+ *    (the pages go elsewhere only if the node is full); Interleaved spreads the pages over all
+ *    the nodes, which evens the bandwidth when all the nodes read the same buffer
+ *  - TransparentHugePages aligns the buffer to the huge page size and asks the kernel to back it
+ *    with huge pages; HugePages uses the huge pages reserved by the administrator
+ *    (vm.nr_hugepages) and falls back to TransparentHugePages when none is available
+ *
+ *  The buffers smaller than minBytes aren't worth a dedicated mapping and take aligned memory
+ *  from the system. The allocator returned by allocator() applies the policy and can be passed
+ *  to setMemoryAllocator or setThreadMemoryAllocator; BaseNeuralNet::setMemoryPolicy uses it to
+ *  move the free parameters of a net:
+ *  \code
+ *  net->setMemoryPolicy( MemoryPolicy( MemoryPolicy::Interleaved, 0, MemoryPolicy::TransparentHugePages ) );
+ *  \endcode
+ *  The static methods describe the topology of the machine and pin the threads to the processors
+ *  of a node, as the Evaluator does when setNumaPinning is enabled.
+ *  \par Warnings
+ *  The placement is available only on Linux; elsewhere, or when the kernel has no NUMA support,
+ *  numNodes() returns 1 and the policies fall back to aligned memory without any error.
+ */
+class NNFW_API MemoryPolicy {
+public:
+	/*! \name Nested Types */
+	//@{
+	/*! Placement of the pages on the NUMA nodes */
+	typedef enum { FirstTouch = 0, OnNode = 1, Interleaved = 2 } Placement;
+	/*! Size of the pages */
+	typedef enum { SmallPages = 0, TransparentHugePages = 1, HugePages = 2 } Pages;
+	//@}
+	/*! \name Constructors */
+	//@{
+
+	/*! Construct a policy; the default one is the same as not having a policy */
+	MemoryPolicy( Placement placement = FirstTouch, int node = 0, Pages pages = SmallPages, size_t minBytes = 1 << 20 );
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! placement of the pages */
+	Placement placement;
+	/*! the node used by OnNode */
+	int node;
+	/*! size of the pages */
+	Pages pages;
+	/*! the buffers smaller than this are allocated without applying the policy */
+	size_t minBytes;
+
+	/*! Return true if the policy doesn't change the placement nor the size of the pages */
+	bool isDefault() const {
+		return ( placement == FirstTouch && pages == SmallPages );
+	};
+
+	/*! Return true if the two policies are the same */
+	bool operator==( const MemoryPolicy& p ) const {
+		return ( placement == p.placement && node == p.node && pages == p.pages && minBytes == p.minBytes );
+	};
+
+	/*! Return the allocator applying this policy; the allocators are shared by the equal policies
+	 *  and never destroyed, so the buffers can outlive the MemoryPolicy
+	 */
+	MemoryAllocator* allocator() const;
+
+	//@}
+	/*! \name Topology of the machine */
+	//@{
+
+	/*! Return the number of NUMA nodes; 1 when NUMA is not supported */
+	static int numNodes();
+
+	/*! Return the node of the processor running the current thread */
+	static int currentNode();
+
+	/*! Return the number of processors of node */
+	static int numCpusOf( int node );
+
+	/*! Restrict the current thread to the processors of node; return false if it's not possible */
+	static bool bindThreadToNode( int node );
+
+	/*! Let the current thread run on all processors again */
+	static void unbindThread();
+
+	/*! Return the size in bytes of the huge pages; 2 MiB when it's not known */
+	static size_t hugePageSize();
+
+	/*! Return the number of huge pages reserved and not used yet */
+	static int freeHugePages();
+
+	/*! Return true if the kernel can back the memory with transparent huge pages */
+	static bool transparentHugePagesEnabled();
+
+	//@}
+};
+
+}
+
+#endif
@@ -25,6 +25,9 @@
 
 #include "types.h"
 #include <string.h>
+#if __cplusplus >= 201103L
+#include <utility>
+#endif
 
 namespace nnfw {
 
@@ -46,6 +49,21 @@ inline void memoryZeroing( T* data, unsigned int size ) {
     };
 };
 
+/*! template for moving data into a new memory: dest takes the values of src, which remain
+ *  valid but unspecified. With C++11 the elements are moved, otherwise they are copied unless an
+ *  overload for T exchanges the contents (like the ones for RealVec and Pattern)
+ */
+template<class T>
+inline void memoryMove( T* dest, T* src, unsigned int size ) {
+#if __cplusplus >= 201103L
+    for( unsigned int i=0; i<size; i++ ) {
+        dest[i] = std::move( src[i] );
+    };
+#else
+    memoryCopy( dest, src, size );
+#endif
+};
+
 /*! specialization of memoryCopy for float data
  */
 inline void memoryCopy( float* dest, const float* src, unsigned int size ) {
@@ -82,6 +100,89 @@ inline void memoryZeroing( bool* data, unsigned int size ) {
     memset( data, 0, sizeof(bool)*size );
 };
 
+/*! specialization of memoryMove for float data
+ */
+inline void memoryMove( float* dest, float* src, unsigned int size ) {
+    memcpy( dest, src, sizeof(float)*size );
+};
+
+/*! specialization of memoryMove for double data
+ */
+inline void memoryMove( double* dest, double* src, unsigned int size ) {
+    memcpy( dest, src, sizeof(double)*size );
+};
+
+/*! alignment in bytes of the memory returned by memoryAlloc; the blocks smaller than it are
+ *  aligned to 16 bytes only, so a vector of few elements doesn't take a whole cache line */
+#define NNFW_MEMORY_ALIGNMENT 64
+
+/*! \brief Interface of the allocators used for the data of VectorData
+ *
+ *  \par Description
+ *  The default allocator keeps, for each thread, a free list of blocks for each size class
+ *  (the powers of two from 32 bytes to 1 MiB), so the short-lived temporary vectors are
+ *  recycled without going through malloc; larger blocks are taken directly from the system.
+ *  Another allocator can be installed with setMemoryAllocator, for example one drawing from a
+ *  preallocated arena; the blocks are always released to the allocator that returned them.
+ */
+class NNFW_API MemoryAllocator {
+public:
+	/*! Destructor */
+	virtual ~MemoryAllocator() { };
+	/*! Return a block of bytes aligned to NNFW_MEMORY_ALIGNMENT, or zero if it's not possible;
+	 *  when bytes is smaller than NNFW_MEMORY_ALIGNMENT an alignment of 16 bytes is enough */
+	virtual void* allocate( size_t bytes ) = 0;
+	/*! Release a block returned by allocate; bytes is the size requested to allocate */
+	virtual void deallocate( void* block, size_t bytes ) = 0;
+};
+
+/*! \brief Statistics of the allocations made by memoryAlloc */
+class NNFW_API MemoryStats {
+public:
+	/*! number of blocks allocated */
+	unsigned long allocations;
+	/*! number of blocks released */
+	unsigned long deallocations;
+	/*! number of allocations served by the free lists of the default allocator */
+	unsigned long recycled;
+	/*! total bytes requested */
+	double bytesAllocated;
+	/*! bytes allocated and not released yet */
+	double bytesInUse;
+};
+
+/*! Install the allocator used by memoryAlloc; zero restores the default one.<br>
+ *  The allocator must remain valid until all its blocks are released
+ */
+NNFW_API void setMemoryAllocator( MemoryAllocator* allocator );
+
+/*! Install the allocator used by memoryAlloc in the current thread only; it takes precedence over
+ *  the one installed by setMemoryAllocator, and zero removes it. Return the previous one.<br>
+ *  It's used for creating some buffers with a different allocator without affecting the other
+ *  threads, as BaseNeuralNet::setMemoryPolicy does
+ */
+NNFW_API MemoryAllocator* setThreadMemoryAllocator( MemoryAllocator* allocator );
+
+/*! Return a block of bytes aligned to NNFW_MEMORY_ALIGNMENT, or to 16 bytes when it's smaller;
+ *  it's used for the data of VectorData
+ */
+NNFW_API void* memoryAlloc( size_t bytes );
+
+/*! Release a block returned by memoryAlloc; zero is ignored
+ */
+NNFW_API void memoryFree( void* block );
+
+/*! Return the statistics of the allocations of all threads.<br>
+ *  It can be called while the other threads allocate: each counter is read atomically, but the
+ *  counters aren't a single snapshot, so bytesInUse may be slightly off until the threads stop
+ */
+NNFW_API MemoryStats memoryStats();
+
+/*! Return the number of allocations made by the current thread; the real-time mode of
+ *  BaseNeuralNet uses it for detecting the allocations during step()
+ */
+NNFW_API unsigned long memoryAllocations();
+
 }
 
 #endif
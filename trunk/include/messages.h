@@ -75,82 +75,152 @@ private:
 	nnfwStringPrivate* prv;
 };
 
+/*! Levels of messages, in order of severity */
+enum nLogLevel {
+	/*! warnings */
+	nLogWarning = 1,
+	/*! errors */
+	nLogError = 2,
+	/*! fatal errors */
+	nLogFatal = 3,
+	/*! nothing is printed */
+	nLogNone = 4
+};
+
+/*! Messages with a level lower than NNFW_LOG_LEVEL are removed at compile-time;
+ *  for example, -DNNFW_LOG_LEVEL=2 removes all warnings */
+#ifndef NNFW_LOG_LEVEL
+#define NNFW_LOG_LEVEL 1
+#endif
+
+/*! maximum length of a message; longer messages are truncated */
+#define NNFW_MESSAGE_SIZE 480
+
 /*! Base class for printing messages<br>
+ *  \par Description
+ *  A message is composed into a fixed buffer, without allocating memory, and it's printed when
+ *  the statement ends. When the level of the message is filtered (see setLevel and NNFW_LOG_LEVEL)
+ *  the parts of the message are not converted at all.
+ *  \par
+ *  In asynchronous mode (see setAsync) the messages are put in a lock-free queue and a background
+ *  thread writes them; so a thread printing a message never waits for the output or for the
+ *  other threads. When the queue is full the message is discarded and counted (see dropped).
+ *  Fatal messages wait until all queued messages are written.
  */
 class NNFW_API nMessage {
 public:
 	/*! \name Constructors */
 	//@{
 	/*! Constructor */
-	nMessage();
+	nMessage() { /* nothing to do */ };
 	/*! Destructor */
 	~nMessage() { /* nothing to do */ };
 	//@}
+	/*! \name Static Interface */
+	//@{
+	/*! Messages with a level lower than level are not printed */
+	static void setLevel( nLogLevel level );
+	/*! Return the minimum level of messages printed */
+	static nLogLevel level() {
+		return (nLogLevel)threshold;
+	};
+	/*! Return true if a message of the level specified would be printed */
+	static bool isEnabled( nLogLevel level ) {
+		return ( level >= NNFW_LOG_LEVEL && level >= threshold );
+	};
+	/*! Enable or disable the asynchronous mode
+	 *  \param b true for enabling
+	 *  \param capacity the number of messages the queue can hold; it's rounded up to a power of two
+	 */
+	static void setAsync( bool b, unsigned int capacity = 1024 );
+	/*! Return true if the asynchronous mode is enabled */
+	static bool isAsync();
+	/*! Wait until all queued messages are written */
+	static void flush();
+	/*! Return the number of messages discarded because the queue was full */
+	static unsigned int dropped();
+	//@}
 protected:
 	//--- Helper class for printing messages
 	class NNFW_API msgLine {
 	public:
-		msgLine( nMessage* parent );
+		msgLine( nLogLevel level );
+		/*! the copy takes the message; the source will not print it */
+		msgLine( const msgLine& src );
 		~msgLine();
-		msgLine& operator<<( const nnfwString& part ) {
-			msg.append( part );
+		msgLine& operator<<( const nnfwString& part );
+		msgLine& operator<<( const char* part );
+		msgLine& operator<<( char part );
+		msgLine& operator<<( int part );
+		msgLine& operator<<( unsigned int part );
+		msgLine& operator<<( long part );
+		msgLine& operator<<( unsigned long part );
+		msgLine& operator<<( double part );
+		msgLine& operator<<( float part );
+	private:
+		void put( const char* str, unsigned int n );
+		nLogLevel lev;
+		/*! false when the message is filtered or taken by a copy */
+		mutable bool active;
+		unsigned int len;
+		char text[NNFW_MESSAGE_SIZE];
+	};
+	/*! A message removed at compile-time by NNFW_LOG_LEVEL: the parts are discarded inline */
+	class nullLine {
+	public:
+		template<class T>
+		nullLine& operator<<( const T& ) {
 			return (*this);
 		};
-		void set( const nnfwString& str ) {
-			msg = str;
-		};
-	private:
-		nMessage* parent;
-		nnfwString msg;
 	};
-	bool linePending;
-	msgLine* pending;
+	/*! minimum level printed at runtime */
+	static int threshold;
 };
 
-/*! Print Warning Messages
+/*! \brief Messages of a level
+ *
+ *  compiled is false when NNFW_LOG_LEVEL removes the messages of the level; then operator<<
+ *  does nothing and it's inlined away, so the filtered messages don't call the library at all.
+ *  The two cases are different types, so the code compiled with different NNFW_LOG_LEVEL can
+ *  be linked together
  */
-class NNFW_API nWarning : public nMessage {
+template<nLogLevel msgLevel, bool compiled>
+class nMessageOf : public nMessage {
 public:
 	/*! \name Interface */
 	//@{
 	/*! Operator for construting a message */
-    nMessage::msgLine operator<<( const nnfwString& part ) {
-		nMessage::msgLine line(this);
-		line.set( nnfwString("== WARNING: ").append(part) );
+	template<class T>
+	nMessage::msgLine operator<<( const T& part ) {
+		nMessage::msgLine line( msgLevel );
+		line << part;
 		return line;
 	};
 	//@}
 };
 
-/*! Print Error Messages
- */
-class NNFW_API nError : public nMessage {
+/*! Messages removed at compile-time */
+template<nLogLevel msgLevel>
+class nMessageOf<msgLevel, false> : public nMessage {
 public:
 	/*! \name Interface */
 	//@{
-	/*! Operator for construting a message */
-    nMessage::msgLine operator<<( const nnfwString& part ) {
-		nMessage::msgLine line(this);
-		line.set( nnfwString("== ERROR: ").append(part) );
-		return line;
+	/*! Operator for construting a message; the parts are discarded */
+	template<class T>
+	nMessage::nullLine operator<<( const T& ) {
+		return nMessage::nullLine();
 	};
 	//@}
 };
 
-/*! Print Fatal Messages
- */
-class NNFW_API nFatal : public nMessage {
-public:
-	/*! \name Interface */
-	//@{
-	/*! Operator for construting a message */
-    nMessage::msgLine operator<<( const nnfwString& part ) {
-		nMessage::msgLine line(this);
-		line.set( nnfwString("== FATAL: ").append(part) );
-		return line;
-	};
-	//@}
-};
+/*! Print Warning Messages */
+typedef nMessageOf< nLogWarning, ( NNFW_LOG_LEVEL <= nLogWarning ) > nWarning;
+
+/*! Print Error Messages */
+typedef nMessageOf< nLogError, ( NNFW_LOG_LEVEL <= nLogError ) > nError;
+
+/*! Print Fatal Messages */
+typedef nMessageOf< nLogFatal, ( NNFW_LOG_LEVEL <= nLogFatal ) > nFatal;
 
 }
 
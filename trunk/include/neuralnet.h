@@ -32,8 +32,12 @@
 #include "clonable.h"
 #include "cluster.h"
 #include "linker.h"
+#include "profiler.h"
+#include "latencyhistogram.h"
+#include "memorypolicy.h"
 #include <map>
 #include <string>
+#include <vector>
 
 namespace nnfw {
 
@@ -148,11 +152,33 @@ public:
     /*! Step
      */
     void step() {
+		if ( realtime ) {
+			stepRealTime();
+			return;
+		}
         for( u_int i=0; i<dimUps; i++ ) {
+			NNFW_PROFILE_SCOPE( ups[i] );
 			ups[i]->update();
         }
     };
 
+    /*! Return the part of the order needed for calculating the outputs of the Clusters passed:
+     *  the Clusters from which they can be reached backward through the incoming Linkers, and
+     *  the Linkers entering into these Clusters, in the same sequence of order().<br>
+     *  The result is calculated once for each set of Clusters and kept until the structure
+     *  of the net or the order change
+     */
+    const UpdatableVec& orderFor( const ClusterVec& outputs );
+
+    /*! Step only the part of the order needed for calculating the outputs of the Clusters passed
+     *  (see orderFor); the other Clusters and Linkers are not updated
+     */
+    void evaluate( const ClusterVec& outputs );
+
+    /*! Step only the part of the order needed for calculating the outputs of the Cluster passed
+     */
+    void evaluate( Cluster* output );
+
     /*! This randomize the free parameters of the all elements of the neural net<br>
      *  This method call randomize method of every Cluster and Linker inserted
      *  \param min is the lower-bound of random number generator desired
@@ -207,6 +233,101 @@ public:
 	BaseNeuralNet* clone() const;
 
 	//@}
+	/*! \name Direct access to free parameters */
+	//@{
+
+	/*! \brief A contiguous block of free parameters of an Updatable
+	 *
+	 *  Exactly one of vec and mat is not NULL; offset is the position of the block into
+	 *  the buffers used by gatherParameters and scatterParameters
+	 */
+	class NNFW_API ParameterBlock {
+	public:
+		Updatable* updatable;
+		RealVec* vec;
+		RealMat* mat;
+		u_int offset;
+		u_int length;
+	};
+	typedef VectorData<ParameterBlock> ParameterBlockVec;
+
+	/*! Return the ordered list of parameter blocks: the biases of each BiasedCluster and the biases
+	 *  and weights of each GatedCluster in the order of clusters() followed by the weights of each
+	 *  MatrixLinker in the order of linkers().
+	 *  The list is rebuilt only when Clusters or Linkers are added or removed
+	 */
+	const ParameterBlockVec& parameterBlocks();
+
+	/*! Return the total number of free parameters */
+	u_int parametersSize();
+
+	/*! Copy all free parameters into the buffer passed; it must be at least parametersSize() long.
+	 *  It doesn't allocate memory and doesn't use the property system
+	 */
+	void gatherParameters( Real* buffer );
+
+	/*! Set all free parameters from the buffer passed; it must be at least parametersSize() long.
+	 *  The weights of each GatedCluster are constrained again (see GatedCluster::constrainWeights),
+	 *  so the values of the missing connections are ignored
+	 *  \warning the masked weights of SparseMatrixLinker are also set
+	 */
+	void scatterParameters( const Real* buffer );
+
+	//@}
+	/*! \name Real-time mode */
+	//@{
+
+	/*! Enable or disable the real-time mode, for running step() inside a control loop with a
+	 *  bounded latency.<br>
+	 *  Enabling it touches every page of the inputs, the outputs, the free parameters of the net
+	 *  and the temporaries declared by Updatable::workingMemory, so no page fault happens during
+	 *  step(); if lockMemory is true these buffers are also locked into physical memory (mlock).
+	 *  While at least one net is in real-time mode the messages are filtered up to nLogFatal, so
+	 *  the debug checks don't print during step(); the previous level is restored when the last
+	 *  net leaves the real-time mode. Each step() is timed into latencies() and, as the
+	 *  memory must not be allocated during a real-time step, the steps allocating the data of a
+	 *  VectorData are counted as violations and reported when the real-time mode is disabled.<br>
+	 *  Return false if the memory can't be locked; the real-time mode is enabled anyway.
+	 *  \warning enable it after the net is completely built: the buffers of Clusters and Linkers
+	 *  added later are not touched nor locked
+	 */
+	bool setRealTime( bool enable, bool lockMemory = false );
+
+	/*! Return true if the real-time mode is enabled */
+	bool isRealTime() const {
+		return realtime;
+	};
+
+	/*! Return the latencies of step() measured in real-time mode */
+	LatencyHistogram& latencies() {
+		return stepLatencies;
+	};
+
+	/*! Return the number of steps that allocated memory in real-time mode */
+	unsigned long realTimeViolations() const {
+		return rtViolations;
+	};
+
+	//@}
+	/*! \name Placement of the memory */
+	//@{
+
+	/*! Move the free parameters of the net (see parameterBlocks) into memory allocated following
+	 *  policy, for example on a NUMA node or backed by huge pages (see MemoryPolicy). Only the
+	 *  blocks of at least policy.minBytes bytes are moved, and the views on external memory are
+	 *  left where they are; the values don't change and the MatrixLinkers are notified through
+	 *  weightsChanged. The clones of the net get the same policy.<br>
+	 *  Return the number of bytes moved.
+	 *  \warning the parameters of the Clusters and Linkers added later are allocated as usual
+	 */
+	size_t setMemoryPolicy( const MemoryPolicy& policy );
+
+	/*! Return the policy set by setMemoryPolicy */
+	const MemoryPolicy& memoryPolicy() const {
+		return memPolicy;
+	};
+
+	//@}
 
 protected:
     /*! Clusters */
@@ -248,6 +369,40 @@ protected:
     /*! Array of Updateables ordered as specified */
     UpdatableVec ups;
     unsigned int dimUps;
+
+	/*! parameter blocks */
+	ParameterBlockVec paramBlocks;
+	/*! total number of parameters */
+	u_int paramSize;
+	/*! true when paramBlocks has to be rebuilt */
+	bool paramDirty;
+
+	typedef std::map< std::vector<Cluster*>, UpdatableVec > SubOrdersMap;
+	/*! the parts of the order calculated by orderFor, indexed by the sorted set of Clusters */
+	SubOrdersMap subOrders;
+	/*! the key of the last request, reused for avoiding allocations */
+	std::vector<Cluster*> subKey;
+	/*! return the part of the order for the Clusters into subKey */
+	const UpdatableVec& subOrder();
+
+	/*! true in real-time mode */
+	bool realtime;
+	/*! the latencies of step() in real-time mode */
+	LatencyHistogram stepLatencies;
+	/*! number of steps that allocated memory in real-time mode */
+	unsigned long rtViolations;
+	/*! the memory locked by setRealTime: start and length of each buffer */
+	std::vector< std::pair<void*, size_t> > rtLocked;
+	/*! step in real-time mode */
+	void stepRealTime();
+	/*! touch every page of the buffers of the net and lock them if lock is true; return false if
+	 *  any lock fails */
+	bool prefault( bool lock );
+	/*! unlock the memory locked by prefault */
+	void unlockMemory();
+
+	/*! the policy set by setMemoryPolicy */
+	MemoryPolicy memPolicy;
 };
 
 }
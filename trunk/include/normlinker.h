@@ -29,6 +29,18 @@
 namespace nnfw {
 
 /*! \brief NormLinker Class
+ *
+ *  \par Description
+ *  Add to the inputs of to() the euclidean distances between the outputs of from() and the
+ *  columns of the weight matrix.
+ *  \par Motivation
+ *  The distances are calculated as sqrt( ||x||^2 - 2*x*W + ||w_j||^2 ), so the work is a single
+ *  vector-matrix product as in DotLinker; the squared norms of the columns are kept and
+ *  recalculated only after the weights change. With distances() many vectors are processed
+ *  with a single matrix product.
+ *  \par Warnings
+ *  After modifying the weights directly through matrix() it's necessary to call weightsChanged();
+ *  the learning algorithms of nnfw already do that.
  *
  *   <table class="proptable">
  *   <tr><td class="prophead" colspan="5">Properties</td></tr>
@@ -65,6 +77,26 @@ public:
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
+    /*! Append temp and wnorms, used by update() */
+    void workingMemory( std::vector<RealVec*>& buffers );
+
+    /*! Calculate the distances of many vectors at once: ys[k][j] = || xs[k] - w_j ||
+     *  for the first count rows of xs and ys
+     *  \param xs the vectors, count rows at least and as many columns as the neurons of from()
+     *  \param ys the results, count rows at least and as many columns as the neurons of to()
+     *  \param count the number of vectors
+     */
+    void distances( const RealMat& xs, RealMat& ys, u_int count );
+
+    /*! Return the squared norms of the columns of the weight matrix */
+    const RealVec& squaredNorms();
+
+    /*! The squared norms of the columns will be recalculated before their next use */
+    void weightsChanged();
+
 	/*! Clone this NormLinker */
 	virtual NormLinker* clone() const;
 
@@ -73,6 +105,12 @@ public:
 protected:
     // temp data
     RealVec temp;
+    /*! squared norms of the columns of the weight matrix */
+    RealVec wnorms;
+    /*! false when wnorms must be recalculated */
+    bool normsValid;
+    /*! recalculate wnorms */
+    void updateNorms();
 };
 
 }
@@ -54,6 +54,12 @@ public:
      */
     virtual void apply( RealVec& inputs, RealVec& outputs );
 
+    /*! Estimate the floating point operations of apply for each neuron; used by Profiler
+     */
+    virtual double applyCost() const {
+        return 1.0;
+    };
+
     /*! Calculate the outputs of a single neuron
      */
     Real apply( Real input ) {
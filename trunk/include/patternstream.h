@@ -0,0 +1,113 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef PATTERNSTREAM_H
+#define PATTERNSTREAM_H
+
+/*! \file
+ *  \brief This file contains the PatternStream Class; it reads patterns from a binary file that doesn't fit in memory
+ */
+
+#include "types.h"
+#include "learningalgorithm.h"
+
+namespace nnfw {
+
+class PatternStreamPrivate;
+
+/*! \brief PatternStream Class. Out-of-core source of patterns for the learning algorithms
+ *
+ *  \par Motivation
+ *  Training sets bigger than the available memory can't be loaded into a PatternSet or a DataSet.
+ *  \par Description
+ *  PatternStream reads patterns from a binary file written by PatternStream::save, batch by batch.
+ *  A background thread decodes the next batch into a DataSet while the previous one is used, so
+ *  the learning is not stalled waiting for the disk. The file can be read with buffered reads or
+ *  mapped in memory. The batches can be visited sequentially or in a shuffled order, different
+ *  for each epoch:
+ *  \code
+ *  PatternStream::save( "train.pat", aDataSet );
+ *  PatternStream stream( "train.pat", net, 4096 );
+ *  stream.setShuffle( true );
+ *  for( int epoch=0; epoch<100; epoch++ ) {
+ *      learnAlgo->learnOnSet( stream );
+ *  }
+ *  \endcode
+ *  The Clusters are saved by name, and when the file is opened they are searched into the net passed.
+ *  \par Warnings
+ *  The DataSet returned by nextBatch is valid until the following call of nextBatch or rewind.<br>
+ *  The binary file stores Real numbers in the native byte order; files written in single precision
+ *  can be read in double precision and viceversa.
+ */
+class NNFW_API PatternStream {
+public:
+	/*! \name Constructors */
+	//@{
+
+	/*! Open the file filename; the Clusters stored into file are searched into net by name
+	 *  \param batchSize is the number of patterns decoded at once
+	 *  \param useMap if true the file is mapped in memory instead of using buffered reads
+	 */
+	PatternStream( const char* filename, BaseNeuralNet* net, u_int batchSize = 1024, bool useMap = false );
+
+	/*! Destructor; it stops the background thread */
+	~PatternStream();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Return true if the file has been opened and all its Clusters exist */
+	bool isValid() const;
+
+	/*! Return the number of patterns into the file */
+	u_int size() const;
+
+	/*! Return the number of patterns of each batch */
+	u_int batchSize() const;
+
+	/*! Return the number of batches */
+	u_int numBatches() const;
+
+	/*! Enable/Disable the shuffling of batches' order; the order is changed at each rewind using Random */
+	void setShuffle( bool enable );
+
+	/*! Start a new epoch from the first batch */
+	void rewind();
+
+	/*! Return the next batch of the current epoch and set count to the number of valid patterns
+	 *  into it; it returns NULL when the epoch is finished */
+	const DataSet* nextBatch( u_int& count );
+
+	/*! Write the DataSet passed into a binary file readable by PatternStream */
+	static bool save( const char* filename, DataSet& set );
+
+	//@}
+
+private:
+	PatternStreamPrivate* prv;
+	/*! Forbidden copy-constructor */
+	PatternStream( const PatternStream& );
+	/*! Forbidden assignment */
+	PatternStream& operator=( const PatternStream& );
+};
+
+}
+
+#endif
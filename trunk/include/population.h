@@ -0,0 +1,197 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef POPULATION_H
+#define POPULATION_H
+
+/*! \file
+ *  \brief This file contains the Population Class; it evaluates many networks sharing the same topology
+ */
+
+#include "types.h"
+#include "neuralnet.h"
+#include <map>
+
+namespace nnfw {
+
+class MatrixLinker;
+
+/*! \brief Population Class. Evaluate many individuals with the same topology of a BaseNeuralNet
+ *
+ *  \par Motivation
+ *  Neuro-evolution and ensemble methods need to evaluate hundreds of networks that differ only
+ *  in their free parameters. Cloning the BaseNeuralNet for each individual scatters the parameters
+ *  in memory and pays a virtual call for each Updatable of each individual.
+ *  \par Description
+ *  The Population takes a BaseNeuralNet as template and holds the parameters of all individuals in
+ *  a structure-of-arrays layout: for each parameter block (the biases of a BiasedCluster or the
+ *  weights of a DotLinker) there is one RealMat with one row for each individual.
+ *  Also the inputs and the outputs of each Cluster are stored as RealMat with one row per individual.
+ *  Then step() updates all individuals at once following the order of the template net; the
+ *  DotLinker are evaluated with a single strided call to RealMat::batchMul.<br>
+ *  The genome of an individual is the concatenation of its parameter blocks in the order of
+ *  BaseNeuralNet::clusters() followed by BaseNeuralNet::linkers(), and it can be read and written
+ *  as a contiguous RealVec; so it has the same layout used by BaseNeuralNet::gatherParameters.
+ *  \par Warnings
+ *  Only SimpleCluster, BiasedCluster, FakeCluster and DotLinker are supported; if the template net
+ *  contains other kind of Updatable the Population is not valid and step() does nothing.<br>
+ *  The template net must not be modified after the Population has been created.
+ */
+class NNFW_API Population {
+public:
+	/*! \name Constructors */
+	//@{
+
+	/*! Construct a Population of size individuals with the topology of net;
+	 *  all individuals start with the parameters of net
+	 */
+	Population( BaseNeuralNet* net, u_int size );
+
+	/*! Destructor */
+	~Population();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Return the number of individuals */
+	u_int size() const {
+		return popsize;
+	};
+
+	/*! Return the length of the genome of one individual */
+	u_int genomeLength() const {
+		return glength;
+	};
+
+	/*! Return the template BaseNeuralNet */
+	BaseNeuralNet* net() const {
+		return tnet;
+	};
+
+	/*! Return true if all Updatable of the template net are supported */
+	bool isValid() const {
+		return valid;
+	};
+
+	/*! Copy the genome of the individual i into the RealVec passed (it must be genomeLength() long) */
+	void getGenome( u_int i, RealVec& genome ) const;
+
+	/*! Set the genome of the individual i */
+	void setGenome( u_int i, const RealVec& genome );
+
+	/*! Copy the genomes of all individuals, one per row, into the RealMat passed
+	 *  (size() x genomeLength())
+	 */
+	void getGenomes( RealMat& genomes ) const;
+
+	/*! Set the genomes of all individuals from the rows of RealMat passed */
+	void setGenomes( const RealMat& genomes );
+
+	/*! Copy the genome of the individual i into the template net */
+	void exportGenome( u_int i );
+
+	/*! Randomize the parameters of all individuals */
+	void randomize( Real min, Real max );
+
+	/*! Return the inputs of all individuals for the Cluster passed, one row for each individual */
+	RealMat& inputs( Cluster* cl );
+
+	/*! Return the outputs of all individuals for the Cluster passed, one row for each individual */
+	RealMat& outputs( Cluster* cl );
+
+	/*! Set the same inputs of Cluster passed to all individuals */
+	void setInputs( Cluster* cl, const RealVec& inputs );
+
+	/*! Return the parameters block of the Updatable passed, one row for each individual;
+	 *  It return NULL if the Updatable has not parameters
+	 */
+	RealMat* parameters( Updatable* up );
+
+	/*! Update all individuals following the order of the template net */
+	void step();
+
+	//@}
+
+private:
+	/*! The template net */
+	BaseNeuralNet* tnet;
+	/*! number of individuals */
+	u_int popsize;
+	/*! length of the genome */
+	u_int glength;
+	/*! true if the template net is supported */
+	bool valid;
+
+	/*! Data about one Cluster of the template net */
+	class NNFW_API cluster_block {
+	public:
+		Cluster* cluster;
+		bool isBiased;
+		bool isFake;
+		bool needReset;
+		/*! inputs of all individuals */
+		RealMat* inputs;
+		/*! outputs of all individuals */
+		RealMat* outputs;
+		/*! inputs minus biases of all individuals (only BiasedCluster) */
+		RealMat* temp;
+		/*! biases of all individuals (only BiasedCluster) */
+		RealMat* params;
+		/*! offset of biases into the genome */
+		u_int offset;
+		/*! one OutputFunction for each individual */
+		VectorData<OutputFunction*> functions;
+	};
+	/*! Data about one DotLinker of the template net */
+	class NNFW_API linker_block {
+	public:
+		MatrixLinker* linker;
+		int from;
+		int to;
+		/*! weights of all individuals */
+		RealMat* params;
+		/*! offset of weights into the genome */
+		u_int offset;
+	};
+	/*! Data about one entry of update order */
+	class NNFW_API order_entry {
+	public:
+		bool isCluster;
+		int index;
+	};
+	VectorData<cluster_block> cls;
+	VectorData<linker_block> lks;
+	VectorData<order_entry> ord;
+	std::map<Cluster*, int> clsIndex;
+	std::map<Linker*, int> lksIndex;
+
+	/*! update the Cluster block */
+	void updateCluster( cluster_block& );
+	/*! update the Linker block */
+	void updateLinker( linker_block& );
+	/*! Forbidden copy-constructor */
+	Population( const Population& );
+	/*! Forbidden assignment */
+	Population& operator=( const Population& );
+};
+
+}
+
+#endif
@@ -0,0 +1,162 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+/*! \file
+ *  \brief This file contains the Profiler Class
+ */
+
+#include "types.h"
+#include "tracer.h"
+#include <vector>
+#include <string>
+
+namespace nnfw {
+
+class Updatable;
+
+/*! \brief Profiler collects the time spent by each Updatable and by the learning algorithms
+ *
+ *  \par Description
+ *  When nnfw is compiled with NNFW_PROFILE defined (NNFW_CONFIG containing 'profile'),
+ *  BaseNeuralNet::step, BaseNeuralNet::evaluate and the learning algorithms measure each call
+ *  of update() and learn(): the number of calls, the total and the maximum time. For each
+ *  Updatable the floating point operations and the bytes of memory touched are estimated by
+ *  Updatable::updateCost, so the report shows the GFLOP/s and the bandwidth achieved by each
+ *  component, also compared to the peak of the machine measured by measurePeak.<br>
+ *  Without NNFW_PROFILE the instrumentation is not compiled at all and Profiler stays empty.
+ *  The same instrumentation feeds the timeline of Tracer, when it is active.
+ *  \par Warnings
+ *  BaseNeuralNet::step is inline, so NNFW_PROFILE must be defined also compiling the programs
+ *  using nnfw. The collection is protected by a mutex, so the measures of Evaluator threads
+ *  are correct but slower; when only the timeline of Tracer is needed, setCollecting(false)
+ *  skips the collection and its mutex.
+ */
+class NNFW_API Profiler {
+public:
+	/*! \brief The measures of an Updatable or of a learning algorithm */
+	class NNFW_API Entry {
+	public:
+		/*! the Updatable measured; zero for the learning algorithms */
+		const Updatable* updatable;
+		/*! name of the Updatable or of the algorithm */
+		std::string name;
+		/*! type of the Updatable, or empty */
+		std::string type;
+		/*! number of calls */
+		unsigned long calls;
+		/*! total time in seconds */
+		double total;
+		/*! maximum time of a call in seconds */
+		double max;
+		/*! estimated floating point operations of all calls */
+		double flops;
+		/*! estimated bytes read and written by all calls */
+		double bytes;
+	};
+
+	/*! \name Static Interface */
+	//@{
+
+	/*! Return true if nnfw is compiled with the instrumentation */
+	static bool isEnabled();
+
+	/*! Discard all measures */
+	static void reset();
+
+	/*! Enable or disable the collection of the measures (enabled by default); disabling it
+	 *  while Tracer records, the calls are only added to the timeline and the threads
+	 *  don't contend the mutex of Profiler */
+	static void setCollecting( bool collecting );
+
+	/*! Return true if the measures are being collected */
+	static bool isCollecting();
+
+	/*! Record a call of update() of u lasted the seconds specified */
+	static void record( const Updatable* u, double seconds );
+
+	/*! Record a call of a learning algorithm (or any other code) lasted the seconds specified */
+	static void record( const char* label, double seconds );
+
+	/*! Return the measures, in order of total time */
+	static std::vector<Entry> entries();
+
+	/*! Measure the peak speed of the machine on a matrix-vector product and on a copy of a
+	 *  large vector; the report shows the speed of each component as a fraction of them */
+	static void measurePeak();
+
+	/*! Return the peak GFLOP/s measured; zero if measurePeak has not been called */
+	static double peakGFlops();
+
+	/*! Return the peak bandwidth in GB/s measured; zero if measurePeak has not been called */
+	static double peakBandwidth();
+
+	/*! Print a table with the measures on the standard output */
+	static void report();
+
+	/*! Return the current time in seconds from an arbitrary origin */
+	static double now();
+
+	//@}
+};
+
+/*! \brief It records the time from its construction to its destruction in the Profiler and in the Tracer */
+class NNFW_API ProfileScope {
+public:
+	/*! Start measuring a call of update() of u */
+	ProfileScope( const Updatable* u ) : up(u), label(0), category(0), start( Profiler::now() ) { };
+	/*! Start measuring the code labeled; the category groups the events into the timeline */
+	ProfileScope( const char* label, const char* category = "learn" ) : up(0), label(label), category(category), start( Profiler::now() ) { };
+	/*! Record the time elapsed */
+	~ProfileScope() {
+		double end = Profiler::now();
+		if ( up ) {
+			Profiler::record( up, end-start );
+			Tracer::record( up, start, end );
+		} else {
+			Profiler::record( label, end-start );
+			Tracer::record( label, category, start, end );
+		}
+	};
+private:
+	const Updatable* up;
+	const char* label;
+	const char* category;
+	double start;
+};
+
+}
+
+/*! Measure the rest of the enclosing block; it expands to nothing without NNFW_PROFILE */
+#ifdef NNFW_PROFILE
+#define NNFW_PROFILE_SCOPE( what ) nnfw::ProfileScope nnfwProfileScope( what )
+#else
+#define NNFW_PROFILE_SCOPE( what )
+#endif
+
+/*! Measure the rest of the enclosing block with the category specified (like "io" or "eval") */
+#ifdef NNFW_PROFILE
+#define NNFW_PROFILE_SCOPE_IN( label, category ) nnfw::ProfileScope nnfwProfileScope( label, category )
+#else
+#define NNFW_PROFILE_SCOPE_IN( label, category )
+#endif
+
+#endif
@@ -178,36 +178,62 @@ private:
     void checkType( types t ) const;
 };
 
+/*! \brief Interned name of a property
+ *
+ *  Two PropertyKey constructed from equal strings hold the same pointer, so they are compared
+ *  by pointer and looking up a property with a PropertyKey never compares strings.
+ *  Construct the PropertyKey once (i.e. as a static variable) and reuse it.
+ */
+class NNFW_API PropertyKey {
+public:
+    /*! Construct the interned key of the name passed */
+    explicit PropertyKey( const char* name );
+    /*! Return the interned name */
+    const char* name() const {
+        return key;
+    };
+    /*! Comparison by pointer */
+    bool operator==( const PropertyKey& other ) const {
+        return key == other.key;
+    };
+    /*! Comparison by pointer */
+    bool operator!=( const PropertyKey& other ) const {
+        return key != other.key;
+    };
+private:
+    /*! the interned name */
+    const char* key;
+};
+
 /*! \brief Encapsulates methods for accessing property data
  *
- *  Details here
+ *  An AbstractPropertyAccess describes a property of a class (name, type and accessor methods) and it
+ *  is shared by all instances of that class; so the object on which the property is read or written
+ *  has to be passed to get/set methods
  */
 class NNFW_API AbstractPropertyAccess : public Clonable {
 public:
     /*! \name Constructors & Destructors */
     //@{
-    /*! Constructor */
+    /*! Constructor; the name is not copied, the property tables replace it with its interned version */
     AbstractPropertyAccess( const char* name ) {
-        u_int size = strlen(name);
-        this->namep = new char[size+1];
-        strcpy( this->namep, name );
+        this->namep = name;
     };
     /*! Destructor */
     virtual ~AbstractPropertyAccess() {
-        delete []namep;
     };
     //@}
     /*! \name Interface */
     //@{
-    /*! Set the value of property */
-    virtual bool set( const Variant& data ) = 0;
-    /*! Return the value of property */
-    virtual Variant get() const = 0;
+    /*! Set the value of property of obj */
+    virtual bool set( Propertized* obj, const Variant& data ) const = 0;
+    /*! Return the value of property of obj */
+    virtual Variant get( const Propertized* obj ) const = 0;
 
-    /*! Set the i-th value of Vector property */
-    virtual bool set( u_int i, const Variant& data ) = 0;
-    /*! Return the i-th value of Vector property */
-    virtual Variant get( u_int i ) const = 0;
+    /*! Set the i-th value of Vector property of obj */
+    virtual bool set( Propertized* obj, u_int i, const Variant& data ) const = 0;
+    /*! Return the i-th value of Vector property of obj */
+    virtual Variant get( const Propertized* obj, u_int i ) const = 0;
 
     /*! Return the name of property */
     const char* name() const {
@@ -225,21 +251,23 @@ public:
     Variant::types type() const {
         return typep;
     };
-    /*! Return the object whom this AbstractPropertyAccess is refered to */
-    virtual Propertized* object() = 0;
+    /*! Return true if other describes the same property (same name, type and accessor methods) */
+    virtual bool sameAs( const AbstractPropertyAccess& other ) const = 0;
     /*! Clone this */
     virtual AbstractPropertyAccess* clone() const = 0;
     //@}
 
 protected:
     /*! Name of property */
-    char* namep;
+    const char* namep;
     /*! Type of property */
     Variant::types typep;
     /*! True if the property is writable */
     bool writable;
     /*! True if the property is a Vector of values */
     bool vectorv;
+
+    friend class PropertyTable;
 };
 
 /*! \brief Template creation of actual PropertyAccess
@@ -252,10 +280,9 @@ public:
     /*! \name Constructors */
     //@{
     /*! Constructor */
-    PropertyAccess( const char* name, Variant::types t, T* o, Variant (T::*g)(), bool (T::*s)( const Variant& ) = 0 )
+    PropertyAccess( const char* name, Variant::types t, Variant (T::*g)(), bool (T::*s)( const Variant& ) = 0 )
         : AbstractPropertyAccess( name ) {
         typep = t;
-        obj = o;
         vectorv = false;
         if ( s == 0 ) {
             writable = false;
@@ -270,36 +297,37 @@ public:
     /*! \name Interface */
     //@{
     /*! return the value of property */
-    virtual Variant get() const {
-        return (obj->*getPtm)();
+    virtual Variant get( const Propertized* obj ) const {
+        return (const_cast<T*>( static_cast<const T*>(obj) )->*getPtm)();
     };
     /*! set the property
      *  \warning It doesn't check is the property is writable or not; before calling this 
 	 *  method check if the property is writable via isWritable() method
      */
-    virtual bool set( const Variant& data ) {
-        return (obj->*setPtm)( data );
+    virtual bool set( Propertized* obj, const Variant& data ) const {
+        return (static_cast<T*>(obj)->*setPtm)( data );
     };
     /*! It always return false */
-    virtual bool set( u_int, const Variant& ) {
+    virtual bool set( Propertized*, u_int, const Variant& ) const {
         return false;
     };
     /*! It always return a Null Variant */
-    virtual Variant get( u_int ) const {
+    virtual Variant get( const Propertized*, u_int ) const {
         return Variant();
     };
-
-    /*! Return the object whom this PropertyAccess is refered to */
-    virtual Propertized* object() {
-        return obj;
+    /*! Return true if other describes the same property */
+    virtual bool sameAs( const AbstractPropertyAccess& other ) const {
+        const PropertyAccess* o = dynamic_cast<const PropertyAccess*>( &other );
+        return ( o && typep == o->typep && getPtm == o->getPtm && setPtm == o->setPtm &&
+                 strcmp( namep, o->namep ) == 0 );
     };
     /*! Clone this */
     virtual PropertyAccess* clone() const {
-        return new PropertyAccess( name(), type(), obj, getPtm, setPtm );
+        PropertyAccess* p = new PropertyAccess( name(), type(), getPtm, setPtm );
+        return p;
     };
     //@}
 private:
-    T* obj;
     bool (T::*setPtm)( const Variant& );
     Variant (T::*getPtm)();
 };
@@ -314,10 +342,9 @@ public:
     /*! \name Constructors */
     //@{
     /*! Constructor */
-    VectorPropertyAccess( const char* name, Variant::types t, T* o, Variant (T::*g)(u_int), bool (T::*s)(u_int, const Variant&) = 0 )
+    VectorPropertyAccess( const char* name, Variant::types t, Variant (T::*g)(u_int), bool (T::*s)(u_int, const Variant&) = 0 )
         : AbstractPropertyAccess( name ) {
         typep = t;
-        obj = o;
         vectorv = true;
         if ( s == 0 ) {
             writable = false;
@@ -332,39 +359,79 @@ public:
     /*! \name Interface */
     //@{
     /*! It always return false */
-    virtual bool set( const Variant& ) {
+    virtual bool set( Propertized*, const Variant& ) const {
         return false;
     };
     /*! It always return a Null Variant */
-    virtual Variant get() const {
+    virtual Variant get( const Propertized* ) const {
         return Variant();
     };
     /*! return the value of property */
-    virtual Variant get( u_int i ) const {
-        return (obj->*getPtm)(i);
+    virtual Variant get( const Propertized* obj, u_int i ) const {
+        return (const_cast<T*>( static_cast<const T*>(obj) )->*getPtm)(i);
     };
     /*! set the property
      *  \warning It doesn't check is the property is writable or not; before calling this
 	 *  method check if the property is writable via isWritable() method
      */
-    virtual bool set( u_int i, const Variant& data ) {
-        return (obj->*setPtm)( i, data );
+    virtual bool set( Propertized* obj, u_int i, const Variant& data ) const {
+        return (static_cast<T*>(obj)->*setPtm)( i, data );
     };
-    /*! Return the object whom this PropertyAccess is refered to */
-    virtual Propertized* object() {
-        return obj;
+    /*! Return true if other describes the same property */
+    virtual bool sameAs( const AbstractPropertyAccess& other ) const {
+        const VectorPropertyAccess* o = dynamic_cast<const VectorPropertyAccess*>( &other );
+        return ( o && typep == o->typep && getPtm == o->getPtm && setPtm == o->setPtm &&
+                 strcmp( namep, o->namep ) == 0 );
     };
     /*! Clone this */
     virtual VectorPropertyAccess* clone() const {
-        return new VectorPropertyAccess( name(), type(), obj, getPtm, setPtm );
+        return new VectorPropertyAccess( name(), type(), getPtm, setPtm );
     };
     //@}
 private:
-    T* obj;
     bool (T::*setPtm)( u_int i, const Variant& );
     Variant (T::*getPtm)( u_int i );
 };
 
+/*! \brief The table of properties shared by all instances of a class
+ *
+ *  \par Motivation
+ *  Before, each instance allocated its own PropertyAccess objects and map entries at construction;
+ *  now the descriptors are stored once per class and each Propertized holds only a pointer to its table.
+ *  \par Description
+ *  The tables form a tree: adding a property to an object moves it from its current table to a child
+ *  table that contains the same properties plus the new one. The child is created the first time
+ *  and then reused by all objects that register the same sequence of properties (i.e. all instances
+ *  of the same class), so constructing an object doesn't allocate anything for its properties.
+ *  \par Warnings
+ *  Tables are never destroyed; building them is not thread-safe, so create the first instance of each
+ *  class before starting threads that construct objects.
+ */
+class NNFW_API PropertyTable {
+public:
+    /*! Return the empty table from which all tables derive */
+    static PropertyTable* root();
+    /*! Return the table with the properties of this plus the one passed; the child table will
+     *  contains a clone of access, so access can be a temporary object
+     */
+    PropertyTable* extend( const AbstractPropertyAccess& access );
+    /*! Search the property by name; when a property was added twice the last one is returned */
+    AbstractPropertyAccess* search( const char* name ) const;
+    /*! Search the property by interned name */
+    AbstractPropertyAccess* search( const PropertyKey& key ) const;
+    /*! Return all properties in order of registering */
+    PropertyAccessVec& properties() {
+        return props;
+    };
+private:
+    /*! Use root() and extend() */
+    PropertyTable();
+    /*! properties in order of registering */
+    PropertyAccessVec props;
+    /*! the tables that extend this one */
+    VectorData<PropertyTable*> children;
+};
+
 /*! \brief Simple Structure for describing a property in PropertySettings
  *
  *  ------- Experimental
@@ -419,13 +486,14 @@ public:
 
     /*! add a property
      *  \warning this method doesn't check if a property with name name already exist, so pay attention or
-     *  previous setting may be overwritten
+     *  previous setting may be overwritten<br>
+     *  The property descriptor is shared among all instances registering the same properties;
+     *  see PropertyTable
      */
     template<class T>
-    void addProperty( const char* name, Variant::types t, T* obj, Variant (T::*read)(), bool (T::*write)( const Variant& ) = 0 ) {
-        PropertyAccess<T>* access = new PropertyAccess<T>( name, t, obj, read, write );
-        props[name] = access;
-        vecProps.append( access );
+    void addProperty( const char* name, Variant::types t, T*, Variant (T::*read)(), bool (T::*write)( const Variant& ) = 0 ) {
+        PropertyAccess<T> access( name, t, read, write );
+        ptable = ptable->extend( access );
     };
 
     /*! add a property that holds a Vector of Variant
@@ -433,32 +501,44 @@ public:
      *  previous setting may be overwritten
      */
     template<class T>
-    void addVectorProperty( const char* name, Variant::types t, T* obj, Variant (T::*read)(u_int i), bool (T::*write)(u_int i, const Variant&) = 0 ) {
-        VectorPropertyAccess<T>* access = new VectorPropertyAccess<T>( name, t, obj, read, write );
-        props[name] = access;
-        vecProps.append( access );
+    void addVectorProperty( const char* name, Variant::types t, T*, Variant (T::*read)(u_int i), bool (T::*write)(u_int i, const Variant&) = 0 ) {
+        VectorPropertyAccess<T> access( name, t, read, write );
+        ptable = ptable->extend( access );
     };
 
-    /*! return the property setted
+    /*! return the property setted; if the property doesn't exist a Null Variant will be returned
      */
-    Variant property( const char* name ) {
-        return props[name]->get();
+    Variant property( const char* name ) const {
+        AbstractPropertyAccess* p = ptable->search( name );
+        return ( p ? p->get( this ) : Variant() );
+    };
+
+    /*! return the property setted (interned name version)
+     */
+    Variant property( const PropertyKey& key ) const {
+        AbstractPropertyAccess* p = ptable->search( key );
+        return ( p ? p->get( this ) : Variant() );
     };
 
     /*! set the property
      */
     bool setProperty( const char* name, const Variant& data ) {
-        if ( props.count( name ) == 0 ) return false;
-        AbstractPropertyAccess& p = *(props[name]);
-        return ( p.isWritable() ? p.set(data) : false );
+        AbstractPropertyAccess* p = ptable->search( name );
+        return ( p && p->isWritable() ? p->set( this, data ) : false );
+    };
+
+    /*! set the property (interned name version)
+     */
+    bool setProperty( const PropertyKey& key, const Variant& data ) {
+        AbstractPropertyAccess* p = ptable->search( key );
+        return ( p && p->isWritable() ? p->set( this, data ) : false );
     };
 
     /*! set the i-th Variant of the Vector property
      */
     bool setVectorProperty( const char* name, u_int i, const Variant& data ) {
-        if ( props.count( name ) == 0 ) return false;
-        AbstractPropertyAccess& p = *(props[name]);
-        return ( p.isWritable() ? p.set(i, data) : false );
+        AbstractPropertyAccess* p = ptable->search( name );
+        return ( p && p->isWritable() ? p->set( this, i, data ) : false );
     };
 
     /*! configure the properties by a PropertySettings
@@ -468,27 +548,31 @@ public:
 
     /*! Return all PropertyAccess in order of registering */
     PropertyAccessVec& properties() const {
-        return (PropertyAccessVec&)vecProps;
+        return ptable->properties();
     };
 
     /*! Set the PropertySettings reflecting the status of this Propertized */
     void propertySettings( PropertySettings& prop ) const {
+		PropertyAccessVec& vecProps = ptable->properties();
 		for( int i=0; i<(int)vecProps.size(); i++ ) {
 			if ( vecProps[i]->isVector() ) {
 				nWarning() << "propertySettings doesn't handle Vector-Property yet";
 				continue;
 			}
-			prop[ vecProps[i]->name() ] = vecProps[i]->get();
+			prop[ vecProps[i]->name() ] = vecProps[i]->get( this );
 		}
     };
 
     /*! Search for property and return it; if the property doesn't exists a NULL pointer will be returned
      */
     AbstractPropertyAccess* propertySearch( const char* name ) const {
-        if ( props.count( name ) > 0 ) {
-            return ((std::map< std::string, AbstractPropertyAccess* >) props)[name];
-        }
-        return 0;
+        return ptable->search( name );
+    };
+
+    /*! Search for property by interned name; if the property doesn't exists a NULL pointer will be returned
+     */
+    AbstractPropertyAccess* propertySearch( const PropertyKey& key ) const {
+        return ptable->search( key );
     };
 
     /*! Return the typename (i.e. the name of the Class)
@@ -515,17 +599,22 @@ public:
 
 protected:
     /*! Set the typename<br>
-     *  Use this function in all constructor of subclasses, and always set the appropriate typename
+     *  Use this function in all constructor of subclasses, and always set the appropriate typename;
+     *  pass a static PropertyKey, so the name is interned once per class and not for each instance:
+     *  \code
+     *  static const PropertyKey typeKey( "MyCluster" );
+     *  setTypename( typeKey );
+     *  \endcode
      */
+    void setTypename( const PropertyKey& type );
+    /*! Set the typename; it interns the name at each call, use the version with PropertyKey */
     void setTypename( const char* type );
 
 private:
-    /*! mapping name -> PropertyAccess */
-    std::map< std::string, AbstractPropertyAccess* > props;
-    /*! vector of all PropertyAccess in order of registering */
-    PropertyAccessVec vecProps;
-    /*! the name of the class */
-    char* vtypename;
+    /*! the table of properties shared with all instances of the same class */
+    PropertyTable* ptable;
+    /*! the name of the class (interned, shared among all instances) */
+    const char* vtypename;
 };
 
 }
@@ -31,9 +31,113 @@
 
 namespace nnfw {
 
+/*! \brief RandomStream is a counter-based random number generator
+ *
+ *  \par Description
+ *  RandomStream implements the Philox4x32-10 generator: the n-th block of four 32-bit values
+ *  is a function of the seed, of the stream number and of n only. So any position of the sequence
+ *  is reached without generating the previous values, and streams with the same seed and
+ *  different stream numbers are independent sequences.
+ *  \par
+ *  The bulk methods (flatRealVec, gaussRealMat, etc) take the values of the element i from
+ *  the block i/4 after the current position and then skip all the blocks used. Large matrices
+ *  are filled by many threads (see Random::setNumThreads) with the same results obtained by a
+ *  single thread.
+ *  \par Warnings
+ *  A RandomStream is not thread-safe: each thread must use its own RandomStream, for example
+ *  with the same seed and a different stream number.
+ */
+class NNFW_API RandomStream {
+public:
+	/*! \name Constructors */
+	//@{
+
+	/*! Construct the sequence identified by seed and stream */
+	RandomStream( unsigned long seed = 0, unsigned long stream = 0 );
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Restart from the beginning of the sequence identified by seed and stream */
+	void setSeed( unsigned long seed, unsigned long stream = 0 );
+
+	/*! Return the seed */
+	unsigned long seed() const {
+		return seedv;
+	};
+
+	/*! Return the stream number */
+	unsigned long stream() const {
+		return streamv;
+	};
+
+	/*! Skip the blocks used by a bulk method on n elements */
+	void skip( u_int n );
+
+	/*! Write in words the n-th block of values after the current position */
+	void block( u_int n, u_int words[4] ) const;
+
+	/*! Return a real number in [0;1) */
+	Real flatReal();
+
+	/*! Return a real number in range [min,max) */
+	Real flatReal( Real min, Real max );
+
+	/*! Return a random boolean value; True value appear with probability specified as paramater */
+	bool boolean( Real trueProb );
+
+	/*! Return a random integer value in between 0 and x-1 */
+	u_int flatInt( u_int x );
+
+	/*! Return a random real value with a gaussian distribution */
+	Real gauss( Real mean, Real stdev );
+
+	/*! Randomize all values of vec in the range [min,max) */
+	RealVec& flatRealVec( RealVec& vec, Real min, Real max );
+
+	/*! Randomize all values of mat in the range [min,max) */
+	RealMat& flatRealMat( RealMat& mat, Real min, Real max );
+
+	/*! Randomize all values of vec with a gaussian distribution */
+	RealVec& gaussRealVec( RealVec& vec, Real mean, Real stdev );
+
+	/*! Randomize all values of mat with a gaussian distribution */
+	RealMat& gaussRealMat( RealMat& mat, Real mean, Real stdev );
+
+	/*! Set each value of vec to true with probability trueProb */
+	BoolVec& booleanVec( BoolVec& vec, Real trueProb );
+
+	/*! Set each value of mat to true with probability trueProb */
+	MatrixData<bool>& booleanMat( MatrixData<bool>& mat, Real trueProb );
+
+	//@}
+
+private:
+	/*! return the next value for the scalar methods */
+	u_int nextWord();
+	/*! move the position forward of n blocks */
+	void advance( u_int n );
+
+	unsigned long seedv;
+	unsigned long streamv;
+	u_int key[2];
+	/*! the stream number occupies the high half of the counter */
+	u_int ctr[4];
+	/*! values of the current block not yet used by the scalar methods */
+	u_int buffer[4];
+	u_int used;
+	/*! the second value of the last Box-Muller transform */
+	bool hasSpare;
+	Real spare;
+};
+
 /*! \brief Random class define some static method for accessing the random number generator
  *
- *  Details
+ *  \par Description
+ *  The scalar methods use a global generator (GSL or rand) that is not thread-safe; the bulk
+ *  methods use a global RandomStream seeded together with it. Threads should use their own
+ *  RandomStream.
  */
 class NNFW_API Random {
 public:
@@ -44,6 +148,15 @@ public:
      */
     static void setSeed( long int seed );
 
+	/*! Return the global RandomStream used by the bulk methods */
+	static RandomStream& stream();
+
+	/*! Set the number of threads used for filling large matrices; zero means the number of processors */
+	static void setNumThreads( u_int n );
+
+	/*! Return the number of threads used for filling large matrices */
+	static u_int numThreads();
+
 	/*! Return a real number in [0;1)
      */
     static Real flatReal( );
@@ -60,6 +173,14 @@ public:
      */
     static RealMat& flatRealMat( RealMat& mat, Real min, Real max );
 
+    /*! Return a RealMat with all the values randomized with a gaussian distribution
+     */
+    static RealMat& gaussRealMat( RealMat& mat, Real mean, Real stdev );
+
+    /*! Return a mask with each value true with probability trueProb
+     */
+    static MatrixData<bool>& booleanMat( MatrixData<bool>& mat, Real trueProb );
+
     /*! Return a random boolean value; True value appear with probability specified as paramater
      */
     static bool boolean( Real trueProb );
@@ -53,6 +53,19 @@ public:
      */
     RealMat( RealVec& src, u_int rstart, u_int rend, u_int rows, u_int cols );
 
+#if __cplusplus >= 201103L
+    /*! Move-Constructor; see the Move-Constructor of MatrixData
+     */
+    RealMat( RealMat&& src ) : MatrixData<Real, RealVec>( std::move( src ) ) { };
+
+    /*! Move-Assignment; see the Move-Assignment of MatrixData
+     */
+    RealMat& operator=( RealMat&& src ) {
+        MatrixData<Real, RealVec>::operator=( std::move( src ) );
+        return (*this);
+    };
+#endif
+
     /*! Destructor
      */
     ~RealMat();
@@ -179,6 +192,25 @@ public:
      */
     static RealVec& mul( RealVec& y, const RealMat& m, const RealVec& x );
 
+	/*! Batched Right Multiplication: y[b] += x[b]*M_b for each row b<br>
+	 *  The b-th row of m contains the matrix M_b of dimension rows x cols stored row by row,
+	 *  so a population of same-shape matrices is multiplied with a single strided call
+	 *  \param y the results, one row for each matrix (cols columns)
+	 *  \param x the vectors, one row for each matrix (rows columns); if x has only one row
+	 *         the same vector is multiplied by all matrices
+	 *  \param m the matrices, one for each row (rows*cols columns)
+	 *  \return the matrix y
+	 */
+	static RealMat& batchMul( RealMat& y, const RealMat& x, const RealMat& m, u_int rows, u_int cols );
+
+	/*! Right Multiplication of many vectors: y[k] += rate * x[k]*m for the first count rows of x and y<br>
+	 *  It's equivalent to count calls of mul, but done as a single matrix product
+	 *  \param y the results, count rows at least and as many columns as m
+	 *  \param x the vectors, count rows at least and as many columns as the rows of m
+	 *  \return the matrix y
+	 */
+	static RealMat& mul( RealMat& y, Real rate, const RealMat& x, const RealMat& m, u_int count );
+
 	/*! Delta-Rule: m += rate * x * y<br>
 	 *  It return itself
 	 *  \param rate is the factor of multiplicaton
@@ -187,6 +219,14 @@ public:
 	 */
 	RealMat& deltarule( Real rate, const RealVec& x, const RealVec& y );
 
+	/*! Batched Delta-Rule: m += rate * sum_k x[k] * y[k] for the first count rows of x and y<br>
+	 *  It's equivalent to count calls of deltarule, but done as a single matrix product x' * y;
+	 *  it return itself
+	 *  \param x is a matrix with count rows at least and as many columns as the rows of this matrix
+	 *  \param y is a matrix with count rows at least and as many columns as the columns of this matrix
+	 */
+	RealMat& batchDeltarule( Real rate, const RealMat& x, const RealMat& y, u_int count );
+
     //@}
     /*! \name Matrix-Matrix Operators */
     //@{
@@ -233,11 +273,18 @@ public:
 
     //@}
 
+	//--- for bulk copying of parameters
+	friend class BaseNeuralNet;
 	//--- for accessing from C interface implementation
 	friend Real* getRawData( RealMat& );
 
 };
 
+/*! Exchange the data of two RealMat without copying them (see MatrixData::swap) */
+inline void swap( RealMat& a, RealMat& b ) {
+	a.swap( b );
+}
+
 }
 
 #endif
@@ -76,6 +76,19 @@ public:
 		return self;
 	};
 
+#if __cplusplus >= 201103L
+    /*! Move-Constructor; see the Move-Constructor of VectorData
+     */
+    RealVec( RealVec&& orig ) : VectorData<Real>( std::move( orig ) ) { };
+
+    /*! Move-Assignment; see the Move-Assignment of VectorData
+     */
+    RealVec& operator=( RealVec&& src ) {
+		VectorData<Real>::operator=( std::move( src ) );
+		return (*this);
+	};
+#endif
+
     //@}
     /*! \name Operations on RealVec */
     //@{
@@ -313,8 +326,13 @@ public:
 	/*! return the position of the maximum element in the vector */
 	int maxIndex() {
 		int mi = 0;
+		if ( vsize == 0 ) return mi;
+		Real mv = data[0];
 		for( u_int i=1; i<vsize; i++ ) {
-			if ( data[i] > data[mi] ) mi=i;
+			if ( data[i] > mv ) {
+				mv = data[i];
+				mi = i;
+			}
 		}
 		return mi;
 	}
@@ -327,8 +345,13 @@ public:
 	/*! return the position of the minimum element in the vector */
 	int minIndex() {
 		int mi = 0;
+		if ( vsize == 0 ) return mi;
+		Real mv = data[0];
 		for( u_int i=1; i<vsize; i++ ) {
-			if ( data[i] < data[mi] ) mi=i;
+			if ( data[i] < mv ) {
+				mv = data[i];
+				mi = i;
+			}
 		}
 		return mi;
 	}
@@ -393,11 +416,31 @@ protected:
         return VectorData<Real>::rawdata();
     };
 
+	//--- for bulk copying of parameters
+	friend class BaseNeuralNet;
 	//--- for accessing from C interface implementation
 	friend Real* getRawData( RealVec& );
 
 };
 
+/*! Exchange the data of two RealVec without copying them (see VectorData::swap) */
+inline void swap( RealVec& a, RealVec& b ) {
+	a.swap( b );
+}
+
+/*! specialization of memoryMove for RealVec: the data are exchanged instead of copied,
+ *  except for the views whose data are copied
+ */
+inline void memoryMove( RealVec* dest, RealVec* src, unsigned int size ) {
+	for( unsigned int i=0; i<size; i++ ) {
+		if ( dest[i].isView() || src[i].isView() ) {
+			dest[i] = src[i];
+		} else {
+			dest[i].swap( src[i] );
+		}
+	}
+}
+
 }
 
 #endif
@@ -0,0 +1,165 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef SHAREDTRAINING_H
+#define SHAREDTRAINING_H
+
+/*! \file
+ *  \brief This file contains the SharedTraining Class; several processes train the same net through shared memory
+ */
+
+#include "types.h"
+
+namespace nnfw {
+
+class BaseNeuralNet;
+class SharedTrainingPrivate;
+
+/*! \brief SharedTraining Class. Data-parallel training of several processes on the same machine
+ *
+ *  \par Motivation
+ *  Training with threads shares the fate of the process: a crash stops everything, and all the
+ *  threads use the same build of the library. Separated processes, each with its own copy of the
+ *  net and its own part of the data, isolate the failures and can be built with different
+ *  precisions.
+ *  \par Description
+ *  The processes of a group open the same POSIX shared memory segment, identified by a name, and
+ *  each one has a rank from 0 to numProcesses-1. When they are all connected the free parameters
+ *  of the net of rank 0 (see BaseNeuralNet::parameterBlocks) are copied into the others, so they
+ *  start from the same point. Then every syncEvery learning steps the processes exchange:
+ *  - Parameters: the parameters, which are averaged (model averaging)
+ *  - Updates: the changes of the parameters since the last exchange, which are summed; with
+ *    syncEvery equal to 1 it's the same as summing the gradients of a batch of numProcesses patterns
+ *
+ *  The exchange is like a ring all-reduce: each process writes its values into its own slot, then
+ *  each one reduces 1/numProcesses of the parameters over all the slots and finally every process
+ *  reads the whole result. The values are summed in the order of rank, so processes built with the
+ *  same precision of Real get exactly the same parameters. The segment stores double values, so
+ *  processes built with float and with double precision can train together, but the ones built
+ *  with float round the result and their parameters differ from the others in the last digits.<br>
+ *  BackPropagationAlgo calls stepDone after each learning step when a SharedTraining is set:
+ *  \code
+ *  // --- into each process, with rank from 0 to 3
+ *  SharedTraining shared( net, "/mytraining", rank, 4, SharedTraining::Parameters, 10 );
+ *  BackPropagationAlgo bp( net, order, 0.1 );
+ *  bp.setSharedTraining( &shared );
+ *  u_int first, count;
+ *  shared.shardRange( trainSet.size(), first, count );
+ *  for( u_int e=0; e<epochs; e++ ) {
+ *      for( u_int i=first; i<first+count; i++ ) bp.learn( trainSet[i] );
+ *  }
+ *  \endcode
+ *  \par Warnings
+ *  All the processes must do the same number of learning steps, otherwise the ones doing more
+ *  steps wait forever (or until the timeout); shardRange gives the same number of patterns to
+ *  each process for this reason.<br>
+ *  When a process dies, or the timeout expires, the others see it at the next exchange: they
+ *  print a warning, leave the group and go on training alone; the same happens when a process
+ *  connects with a different configuration or destroys its SharedTraining before the others.<br>
+ *  If a group terminates before all processes are connected, the segment remains in the system
+ *  and must be deleted with remove before using the same name again. It's available only on
+ *  systems supporting POSIX shared memory.
+ */
+class NNFW_API SharedTraining {
+public:
+	/*! \name Nested Types */
+	//@{
+	/*! What the processes exchange */
+	typedef enum { Parameters = 0, Updates = 1 } Exchange;
+	//@}
+	/*! \name Constructors */
+	//@{
+
+	/*! Connect to the group name as the process rank of numProcesses; it waits until all the
+	 *  processes are connected, then the parameters of net are set to the ones of rank 0.<br>
+	 *  All the processes must pass the same numProcesses, exchange and syncEvery and a net with the
+	 *  same number of parameters; if they differ, or the connection fails, an error is printed and
+	 *  isConnected returns false
+	 */
+	SharedTraining( BaseNeuralNet* net, const char* name, u_int rank, u_int numProcesses, Exchange exchange = Parameters, u_int syncEvery = 1 );
+
+	/*! Destructor; it leaves the group, and the other processes leave it too at the next exchange
+	 *  instead of waiting for this one
+	 */
+	~SharedTraining();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Return true while the process is into the group */
+	bool isConnected() const;
+
+	/*! Return the rank of this process */
+	u_int rank() const;
+
+	/*! Return the number of processes of the group */
+	u_int numProcesses() const;
+
+	/*! Return what the processes exchange */
+	Exchange exchange() const;
+
+	/*! Set the number of learning steps between two exchanges; zero means that the exchanges happen
+	 *  only when synchronize is called. All the processes must use the same value; only the one
+	 *  passed to the constructor is checked
+	 */
+	void setSyncEvery( u_int steps );
+
+	/*! Return the number of learning steps between two exchanges */
+	u_int syncEvery() const;
+
+	/*! Set the seconds waited for the other processes before leaving the group; zero, the default,
+	 *  waits forever (but the processes dead are detected anyway)
+	 */
+	void setTimeout( double seconds );
+
+	/*! Count a learning step and exchange the parameters every syncEvery steps; it's called by the
+	 *  learning algorithms. Return false if the process is not into the group anymore
+	 */
+	bool stepDone();
+
+	/*! Exchange the parameters now; all the processes must call it. Return false if the process is
+	 *  not into the group anymore
+	 */
+	bool synchronize();
+
+	/*! Return the number of exchanges done */
+	u_int numSynchronizations() const;
+
+	/*! Return the part of a set of size patterns to use into this process: all the processes get
+	 *  count patterns, starting from first; the last size % numProcesses patterns are not used
+	 */
+	void shardRange( u_int size, u_int& first, u_int& count ) const;
+
+	/*! Delete the shared memory segment of the group name left by a group terminated abnormally */
+	static bool remove( const char* name );
+
+	//@}
+
+private:
+	SharedTrainingPrivate* prv;
+	/*! Forbidden copy-constructor */
+	SharedTraining( const SharedTraining& );
+	/*! Forbidden assignment */
+	SharedTraining& operator=( const SharedTraining& );
+};
+
+}
+
+#endif
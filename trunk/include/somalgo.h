@@ -0,0 +1,207 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef SOMALGO_H
+#define SOMALGO_H
+
+/*! \file
+ *  \brief This file contains the SOMAlgo Class; Kohonen's Self-Organizing Map
+ */
+
+#include "types.h"
+#include "learningalgorithm.h"
+
+namespace nnfw {
+
+class MatrixLinker;
+
+/*! \brief Self-Organizing Map (Kohonen) and competitive learning
+ *
+ *  \par Motivation
+ *  NormLinker and WinnerTakeAllFunction allow to build a Self-Organizing Map, but nnfw had no
+ *  algorithm for training it.
+ *  \par Description
+ *  The prototypes of the units are the columns of the weights of a MatrixLinker (usually a
+ *  NormLinker from the input Cluster to the map Cluster); the units are placed on a grid
+ *  width x height, the unit j at column j%width and row j/width.<br>
+ *  The inputs are collected into batches: the squared distances of the whole batch from all
+ *  prototypes are calculated as ||x||^2 - 2*x*W + ||w||^2 with a single matrix product (see
+ *  RealMat::mul) and the squared norms of the prototypes calculated once for each batch; then,
+ *  for each input, the winner is the unit at minimum distance. The prototypes are moved toward
+ *  the inputs of the batch weighted by the neighborhood function of the grid distance from the
+ *  winners, with a single matrix product (see RealMat::batchDeltarule):<br>
+ *  w_j <- w_j + a_j * sum_k h(j, winner_k) * (x_k - w_j) <br>
+ *  where a_j is the learning rate, reduced to 1/sum_k h(j, winner_k) when the step would go
+ *  beyond the weighted mean of the inputs (as in the Batch SOM).<br>
+ *  The learning rate and the radius of neighborhood decay exponentially from their start values
+ *  to their end values during the given number of steps (one step for each input); with a radius
+ *  of zero the algorithm becomes the simple competitive learning.
+ *  \code
+ *  SOMAlgo som( net, normLinker, 100, 100 );
+ *  som.setRate( 0.5, 0.01 );
+ *  som.setRadius( 50.0, 0.5 );
+ *  som.setDuration( 20*trainSet.size() );
+ *  for( int epoch=0; epoch<20; epoch++ ) {
+ *      som.learnOnSet( trainSet );
+ *  }
+ *  \endcode
+ *  calculateMSE returns the quantization error: the mean square difference between the input
+ *  and the prototype of the winner.
+ *  \par Warnings
+ *  The inputs are taken from the Pattern as the inputs of from() of the MatrixLinker; learn( const Pattern& )
+ *  only collects the input, the prototypes are modified when the batch is full or calling learn()
+ */
+class NNFW_API SOMAlgo : public LearningAlgorithm {
+public:
+	/*! Neighborhood functions */
+	typedef enum { Gaussian = 0, Bubble = 1 } Neighborhood;
+
+	/*! \name Constructors */
+	//@{
+
+	/*! Constructor
+	 *  \param net the neural network
+	 *  \param prototypes the MatrixLinker whose columns are the prototypes of the units
+	 *  \param width the number of columns of the grid
+	 *  \param height the number of rows of the grid; width*height has to be the number of units
+	 *  \param batchSize the number of inputs processed together
+	 */
+	SOMAlgo( BaseNeuralNet* net, MatrixLinker* prototypes, u_int width, u_int height = 1, u_int batchSize = 64 );
+
+	/*! Destructor */
+	~SOMAlgo();
+
+	//@}
+	/*! \name Interface */
+	//@{
+
+	/*! Set the learning rate at the start and at the end of the learning */
+	void setRate( Real start, Real end );
+
+	/*! Set the radius of neighborhood (in units of the grid) at the start and at the end of the learning */
+	void setRadius( Real start, Real end );
+
+	/*! Set the number of steps during which the learning rate and the radius decay */
+	void setDuration( u_int steps );
+
+	/*! Set the neighborhood function */
+	void setNeighborhood( Neighborhood n ) {
+		nfun = n;
+	};
+
+	/*! Return the neighborhood function */
+	Neighborhood neighborhood() const {
+		return nfun;
+	};
+
+	/*! Return the current learning rate */
+	Real rate() const;
+
+	/*! Return the current radius of neighborhood */
+	Real radius() const;
+
+	/*! Return the number of steps done */
+	u_int steps() const {
+		return tsteps;
+	};
+
+	/*! Restart the decay of the learning rate and the radius */
+	void restart();
+
+	/*! Return the unit whose prototype is the nearest to the vector passed
+	 *  \warning the norms of the prototypes are recalculated only by learn and calculateMSEOnSet;
+	 *  after modifying the weights in other ways, call calculateMSEOnSet before */
+	u_int winner( const RealVec& x );
+
+	/*! Modify the prototypes with the inputs collected */
+	virtual void learn();
+
+	/*! Collect the input of Pattern passed; the prototypes are modified when the batch is full */
+	virtual void learn( const Pattern& );
+
+	/*! Return the quantization error respect to the input of Pattern passed */
+	virtual Real calculateMSE( const Pattern& );
+
+	/*! Learn the PatternSet and modify the prototypes with the last partial batch */
+	virtual void learnOnSet( const PatternSet& set );
+
+	/*! Learn the DataSet and modify the prototypes with the last partial batch */
+	virtual void learnOnSet( const DataSet& set );
+
+	/*! Learn the patterns of PatternStream and modify the prototypes with the last partial batch */
+	virtual void learnOnSet( PatternStream& stream );
+
+	/*! Return the mean quantization error on the PatternSet */
+	virtual Real calculateMSEOnSet( const PatternSet& set );
+
+	/*! Return the mean quantization error on the DataSet */
+	virtual Real calculateMSEOnSet( const DataSet& set );
+
+	/*! Return the mean quantization error on the patterns of PatternStream */
+	virtual Real calculateMSEOnSet( PatternStream& stream );
+
+	//@}
+
+private:
+	MatrixLinker* lk;
+	/*! number of inputs and of units */
+	u_int ninputs;
+	u_int nunits;
+	/*! coordinates of the units into the grid */
+	RealVec gridx;
+	RealVec gridy;
+	Neighborhood nfun;
+	Real rateStart;
+	Real rateEnd;
+	Real radiusStart;
+	Real radiusEnd;
+	u_int duration;
+	u_int tsteps;
+	/*! the inputs collected (batch x ninputs) */
+	RealMat xs;
+	/*! the distances and then the neighborhood weights (batch x nunits) */
+	RealMat hs;
+	/*! the number of inputs collected */
+	u_int pending;
+	/*! squared norms of the prototypes, and true if they are up to date */
+	RealVec norms;
+	bool normsValid;
+	/*! distances of one input */
+	RealVec dist;
+	/*! winners of the batch */
+	VectorData<u_int> winners;
+	/*! sum of the neighborhood weights of each unit */
+	RealVec hsum;
+
+	/*! calculate the squared norms of the prototypes */
+	void updateNorms();
+	/*! return the nearest unit to x and its squared distance */
+	u_int nearest( const RealVec& x, Real& d2 );
+	/*! return the current value of a parameter decaying from start to end */
+	Real decay( Real start, Real end ) const;
+
+	/*! Forbidden copy-constructor */
+	SOMAlgo( const SOMAlgo& );
+	/*! Forbidden assignment */
+	SOMAlgo& operator=( const SOMAlgo& );
+};
+
+}
+
+#endif
@@ -78,6 +78,9 @@ public:
      */
     void update();
 
+    /*! Estimate the floating point operations and the bytes of memory touched by update() */
+    void updateCost( double& flops, double& bytes ) const;
+
     /*! Connect two neurons
      */
     void connect( u_int from, u_int to );
@@ -0,0 +1,96 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#ifndef TRACER_H
+#define TRACER_H
+
+/*! \file
+ *  \brief This file contains the Tracer Class
+ */
+
+#include "types.h"
+
+namespace nnfw {
+
+class Updatable;
+
+/*! \brief Tracer records a timeline of the calls of each thread and exports it as Chrome trace events
+ *
+ *  \par Description
+ *  While Profiler aggregates the measures, Tracer keeps each single call with its start and its
+ *  duration, so the stalls and the imbalance among the threads of Evaluator, of PatternStream and
+ *  of the programs using nnfw become visible. The instrumentation points are the same of Profiler
+ *  (NNFW_PROFILE_SCOPE): each update() of an Updatable, the learning algorithms and their phases,
+ *  the evaluation of the blocks of patterns and the loading of the batches.<br>
+ *  The events are stored in a buffer owned by each thread and written only by it, so recording
+ *  doesn't need any lock; a buffer is assigned to a thread the first time it records something
+ *  and it's reused by another thread when the owner terminates. Profiler keeps collecting its
+ *  measures under a mutex; call Profiler::setCollecting(false) to record only the timeline.<br>
+ *  The file written by save can be loaded by chrome://tracing or by Perfetto:
+ *  \code
+ *  Tracer::start();
+ *  for( int i=0; i<epochs; i++ ) algo.learnOnSet( stream );
+ *  Tracer::stop();
+ *  Tracer::save( "train.json" );
+ *  \endcode
+ *  \par Warnings
+ *  The events are recorded only when nnfw is compiled with NNFW_PROFILE. start, stop, save and
+ *  numEvents can be called while other threads record: start waits for the events being written,
+ *  and save writes only the events completed when it reads each buffer. The labels passed to record
+ *  must be string constants, because only the pointer is stored.
+ */
+class NNFW_API Tracer {
+public:
+	/*! \name Static Interface */
+	//@{
+
+	/*! Discard the events recorded and start recording; each thread can record up to
+	 *  eventsPerThread events, the following ones are dropped */
+	static void start( u_int eventsPerThread = 1 << 16 );
+
+	/*! Stop recording; the events are kept until the next start */
+	static void stop();
+
+	/*! Return true if the events are being recorded */
+	static bool isActive();
+
+	/*! Name the current thread into the timeline */
+	static void setThreadName( const char* name );
+
+	/*! Record a call of update() of u from start to end seconds (Profiler::now) */
+	static void record( const Updatable* u, double start, double end );
+
+	/*! Record the code labeled from start to end seconds (Profiler::now) */
+	static void record( const char* label, const char* category, double start, double end );
+
+	/*! Return the number of events recorded */
+	static u_int numEvents();
+
+	/*! Return the number of events dropped because the buffer of a thread was full */
+	static u_int dropped();
+
+	/*! Write the events in the Chrome trace event format; return false on error */
+	static bool save( const char* filename );
+
+	//@}
+};
+
+}
+
+#endif
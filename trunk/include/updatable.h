@@ -30,13 +30,16 @@ namespace nnfw {
 
 /*! \brief Updatables objects
  *
- *  The Updatable objects has a name.
+ *  The Updatable objects has a name.<br>
+ *  An Updatable can be frozen: its free parameters (biases, weights) are not modified by the
+ *  learning algorithms, that also avoid the calculations needed only for modifying them.
  *
  *   <table class="proptable">
  *   <tr><td class="prophead" colspan="5">Properties</td></tr>
  *   <tr><th>Name</th> <th>Type [isVector]</th> <th>Access mode</th> <th>Description</th> <th>Class</th></tr>
  *   <tr><td>typename</td> <td>string</td> <td>read-only</td> <td> Class's type </td> <td>Propertized</td> </tr>
  *   <tr><td>name</td> <td>string</td> <td>read/write</td> <td> name of the object </td> <td>this</td> </tr>
+ *   <tr><td>frozen</td> <td>boolean</td> <td>read/write</td> <td> if the learning doesn't modify it </td> <td>this</td> </tr>
  *   </table>
  */
 class NNFW_API Updatable : public Propertized {
@@ -59,6 +62,16 @@ public:
 
     /*! Update the object */
     virtual void update() = 0;
+
+    /*! Estimate the floating point operations and the bytes of memory read and written by
+     *  a call of update(); the Profiler uses them for calculating the speed achieved */
+    virtual void updateCost( double& flops, double& bytes ) const {
+        flops = 0.0;
+        bytes = 0.0;
+    };
+    /*! Append the temporary vectors used by update() besides the inputs, the outputs and the
+     *  free parameters; BaseNeuralNet::setRealTime touches and locks them with the rest of the net */
+    virtual void workingMemory( std::vector<RealVec*>& ) { /* nothing to do */ };
     /*! Set the name of Updatable */
     void setName( const char* newname );
     /*! Set the name of Updatable (Varian version) */
@@ -68,10 +81,39 @@ public:
     /*! Return the name (version that use Variant for property) */
     Variant getNameV();
 
+    /*! Freeze (or unfreeze) the free parameters of this object */
+    void setFrozen( bool b );
+
+    /*! Return true if the free parameters are frozen */
+    bool isFrozen() const {
+        return frozen;
+    };
+
+    /*! Read Access to property 'frozen' */
+    Variant frozenP() {
+        return Variant( frozen );
+    };
+
+    /*! Write Access to property 'frozen' */
+    bool setFrozenP( const Variant& b ) {
+        setFrozen( b.getBool() );
+        return true;
+    };
+
+    //@}
+    /*! \name Static Interface */
+    //@{
+
+    /*! Return a counter incremented each time an Updatable is frozen or unfrozen; the learning
+     *  algorithms compare it with the value seen last time, so they look again at the frozen flags
+     *  only after a change */
+    static int frozenChanges();
+
     //@}
 
 protected:
     char* namev;
+    bool frozen;
 };
 
 }
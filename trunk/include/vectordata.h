@@ -36,6 +36,7 @@
 
 #include "memutils.h"
 #include <vector>
+#include <new>
 
 
 namespace nnfw {
@@ -44,6 +45,8 @@ namespace nnfw {
  *  \par Motivation
  *  Create a VectorData abstract type for storing data in dynamic and efficient way
  *  \par Description
+ *  The data are allocated by memoryAlloc, so they are aligned to NNFW_MEMORY_ALIGNMENT bytes (16 bytes
+ *  when they are smaller) and the short-lived vectors are recycled by the free lists of the allocator (see MemoryAllocator).
  *  \par Warnings
  */
 template<class T>
@@ -75,8 +78,7 @@ public:
         if ( vsize == 0 ) {
             data = 0;
         } else {
-            data = new T[vsize];
-            memoryZeroing( data, vsize );
+            data = allocData( vsize );
         }
         // --- view attribute
         view = false;
@@ -90,7 +92,7 @@ public:
         : Observer(), Observable() {
         vsize = size;
         allocated = size;
-        (vsize==0) ? (data = 0) : (data = new T[vsize]);
+        data = allocData( vsize );
         for(u_int i = 0; i<size; i++) {
             data[i] = value;
         }
@@ -123,7 +125,7 @@ public:
     /*! Construct by copying data from const T* vector */
     VectorData( const T* r, u_int dim )
         : Observer(), Observable() {
-        data = new T[dim];
+        data = allocData( dim );
         vsize = dim;
         allocated = dim;
         memoryCopy( data, r, dim );
@@ -145,7 +147,7 @@ public:
            --- the copy-constructor create a new fresh copy of data */
 		vsize = src.vsize;
 		allocated = vsize;
-		data = new T[allocated];
+		data = allocData( allocated );
 		memoryCopy( data, src.data, vsize );
 		view = false;
 		observed = 0;
@@ -164,14 +166,53 @@ public:
 		return self;
 	};
 
+#if __cplusplus >= 201103L
+    /*! The Move-Constructor takes the data of src without copying them and leaves src empty;
+	 *  if src is a view the data viewed are copied, like the Copy-Constructor does, so it may
+	 *  allocate and it's not declared noexcept
+     */
+    VectorData( VectorData&& src )
+        : Observer(), Observable() {
+        vsize = 0;
+        allocated = 0;
+        data = 0;
+        view = false;
+        observed = 0;
+        idstart = 0;
+        idend = 0;
+        if ( src.view ) {
+            data = allocData( src.vsize );
+            allocated = src.vsize;
+            vsize = src.vsize;
+            memoryCopy( data, src.data, vsize );
+        } else {
+            swapData( src );
+            src.notifyAll( NotifyEvent( datachanged ) );
+        }
+    };
+
+    /*! The Move-Assignment exchanges the data with src; when one of them is a view the data are
+	 *  copied, like the assignment operator does
+     */
+    VectorData& operator=( VectorData&& src ) {
+        if ( view || src.view ) {
+            return ( (*this) = (const VectorData&)src );
+        }
+        if ( this != &src ) {
+            swap( src );
+        }
+        return (*this);
+    };
+#endif
+
     /*! Destructor
      */
     ~VectorData() {
         notifyAll( NotifyEvent( datadestroying ) );
         if ( view ) {
-            observed->delObserver( this );
+            if ( observed ) observed->delObserver( this );
         } else {
-            delete []data;
+            freeData( data, allocated );
         }
     };
     //@}
@@ -380,16 +421,9 @@ public:
             return;
         }
         if ( allocated < newsize ) {
-            if ( allocated == 0 ) {
-                allocated = newsize+20;
-                data = new T[allocated];
-            } else {
-                allocated = newsize+20;
-                T* tmp = new T[allocated];
-                memoryCopy( tmp, data, vsize );
-                delete []data;
-                data = tmp;
-            }
+            // --- the space grows geometrically, so a sequence of appends takes linear time
+            u_int newspace = ( allocated == 0 ) ? newsize : 2*allocated;
+            reallocate( ( newspace < newsize ) ? newsize : newspace );
         }
         if ( newsize > vsize ) {
             memoryZeroing( data+vsize, newsize-vsize );
@@ -399,12 +433,55 @@ public:
         notifyAll( NotifyEvent( datachanged ) );
     };
 
+    /*! Allocate the space for n elements without changing the size, so the following resizes
+     *  and appends up to n elements don't allocate memory
+     */
+    void reserve( u_int n ) {
+        if ( view ) {
+            nError() << "It's not possible reserve space into RealVec views" ;
+            return;
+        }
+        if ( allocated < n ) {
+            reallocate( n );
+            // --- Notify the viewers
+            notifyAll( NotifyEvent( datachanged ) );
+        }
+    };
+
+    /*! Return the number of elements allocated */
+    u_int capacity() const {
+        return allocated;
+    };
+
     /*! Append an element; the dimesion increase by one */
     void append( const T& value ) {
         resize( vsize+1 );
         data[vsize-1] = value;
     };
 
+#if __cplusplus >= 201103L
+    /*! Append an element moving it; the dimesion increase by one */
+    void append( T&& value ) {
+        resize( vsize+1 );
+        data[vsize-1] = std::move( value );
+    };
+#endif
+
+    /*! Exchange the data with the ones of b without copying them. The views of both remain
+     *  attached to the same VectorData and they are notified of the change.<br>
+     *  Views can't be swapped
+     */
+    void swap( VectorData<T>& b ) {
+        if ( view || b.view ) {
+            nError() << "It's not possible swap VectorData views" ;
+            return;
+        }
+        swapData( b );
+        // --- Notify the viewers
+        notifyAll( NotifyEvent( datachanged ) );
+        b.notifyAll( NotifyEvent( datachanged ) );
+    };
+
     /*! Append Operator; the dimesion increase by one */
     VectorData<T>& operator<<( const T& value ) {
         append( value );
@@ -418,7 +495,7 @@ public:
      *  If VectorData is not a view, then it will shows an error message
      */
     void setView( u_int idStart, u_int idEnd ) {
-        if ( !view ) {
+        if ( !view || !observed ) {
             nError() << "setView can be called only if VectorData is a view" ;
             return;
         }
@@ -444,10 +521,10 @@ public:
         }
         if ( view ) {
             // detach previous view
-            observed->delObserver( this );
+            if ( observed ) observed->delObserver( this );
         } else if ( allocated > 0 ) {
             // remove previous data allocated
-            delete []data;
+            freeData( data, allocated );
         }
     
         if ( idStart > src.vsize || idEnd > src.vsize || idStart >= idEnd ) {
@@ -464,6 +541,31 @@ public:
         view = true;
         observed = &src;
         observed->addObserver( this );
+        // --- Propagate Notify to sub-viewers
+        notifyAll( NotifyEvent( datachanged ) );
+    };
+
+    /*! Convert this VectorData to a view of dim elements of memory not owned by any VectorData.<br>
+     *  The memory pointed by r is never deleted by this VectorData and it must remain valid
+     *  until this VectorData is converted back or destroyed. It can't be resized, like any other view.
+     */
+    void convertToView( T* r, u_int dim ) {
+        if ( view ) {
+            // detach previous view
+            if ( observed ) observed->delObserver( this );
+        } else if ( allocated > 0 ) {
+            // remove previous data allocated
+            freeData( data, allocated );
+        }
+        data = r;
+        vsize = dim;
+        allocated = 0;
+        view = true;
+        observed = 0;
+        idstart = 0;
+        idend = dim;
+        // --- Propagate Notify to sub-viewers
+        notifyAll( NotifyEvent( datachanged ) );
     };
 
     //@}
@@ -504,6 +606,13 @@ public:
         data[vsize-1] = value;
     };
 
+#if __cplusplus >= 201103L
+    /*! Append an element moving it */
+    void push_back( T&& value ) {
+        append( std::move( value ) );
+    };
+#endif
+
     /*! Iterator at initial position */
     iterator begin() {
         return vectordataIterator( *this );
@@ -631,6 +740,50 @@ protected:
     /*! Observed VectorData */
     VectorData* observed;
 
+    /*! Allocate n elements aligned as memoryAlloc does and construct them with T() */
+    static T* allocData( u_int n ) {
+        if ( n == 0 ) return 0;
+        T* d = (T*)( memoryAlloc( n*sizeof(T) ) );
+        for( u_int i=0; i<n; i++ ) {
+            new ( d+i ) T();
+        }
+        return d;
+    };
+
+    /*! Destroy the n elements allocated by allocData and release the memory */
+    static void freeData( T* d, u_int n ) {
+        if ( !d ) return;
+        for( u_int i=0; i<n; i++ ) {
+            d[i].~T();
+        }
+        memoryFree( d );
+    };
+
+    /*! Move the data into a new space of n elements; n must not be less than vsize */
+    void reallocate( u_int n ) {
+        T* tmp = allocData( n );
+        memoryMove( tmp, data, vsize );
+        freeData( data, allocated );
+        data = tmp;
+        allocated = n;
+    };
+
+    /*! Exchange the data with the ones of b, without notifying the viewers */
+    void swapData( VectorData<T>& b ) {
+        T* d = data;
+        data = b.data;
+        b.data = d;
+        u_int n = vsize;
+        vsize = b.vsize;
+        b.vsize = n;
+        n = allocated;
+        allocated = b.allocated;
+        b.allocated = n;
+    };
+
+    /*! MatrixData swaps its data and rebuilds the views of rows by itself */
+    template<class U, class V> friend class MatrixData;
+
     /*! Notify to viewers that 'data' is changed */
     virtual void notify( const NotifyEvent& event ) {
         switch( event.type() ) {
@@ -666,6 +819,13 @@ protected:
 
 };
 
+
+/*! Exchange the data of two VectorData without copying them (see VectorData::swap) */
+template<class T>
+inline void swap( VectorData<T>& a, VectorData<T>& b ) {
+    a.swap( b );
+}
+
 }
 
 #endif
@@ -23,13 +23,15 @@
 #include "derivableoutputfunction.h"
 #include "backpropagationalgo.h"
 #include "nnfwfactory.h"
+#include "sharedtraining.h"
 
 using namespace std;
 
 namespace nnfw {
 
 BackPropagationAlgo::BackPropagationAlgo( BaseNeuralNet *n_n, UpdatableVec up_order, Real l_r )
-	: LearningAlgorithm(n_n), learn_rate(l_r), update_order(up_order) {
+	: LearningAlgorithm(n_n), learn_rate(l_r), update_order(up_order), sharedTraining(0), keepBound(false),
+	  learnablesDirty(true), frozenSeen(0) {
 
 	Cluster *cluster_temp;
 	// pushing the info for output cluster
@@ -76,6 +78,59 @@ const RealVec& BackPropagationAlgo::getError( Cluster* cl ) {
 	return cluster_deltas_vec[index].deltas_outputs;
 }
 
+void BackPropagationAlgo::dontLearn( Cluster* cluster ) {
+	learnableClusters[cluster] = false;
+	learnablesDirty = true;
+}
+
+void BackPropagationAlgo::dontLearn( Linker* linker ) {
+	learnableLinkers[linker] = false;
+	learnablesDirty = true;
+}
+
+void BackPropagationAlgo::doLearn( Cluster* cluster ) {
+	learnableClusters.erase( cluster );
+	learnablesDirty = true;
+}
+
+void BackPropagationAlgo::doLearn( Linker* linker ) {
+	learnableLinkers.erase( linker );
+	learnablesDirty = true;
+}
+
+void BackPropagationAlgo::updateLearnables() {
+	learnablesDirty = false;
+	frozenSeen = Updatable::frozenChanges();
+	// --- what is modified
+	for ( u_int i=0; i<cluster_deltas_vec.size(); ++i ) {
+		cluster_deltas& cd = cluster_deltas_vec[i];
+		cd.learnCluster = cd.hasBiases && !cd.cluster->isFrozen() && learnableClusters.find( cd.cluster ) == learnableClusters.end();
+		cd.needDeltas = cd.learnCluster;
+		for ( u_int j=0; j<cd.incoming_linkers_vec.size(); ++j ) {
+			Linker* link = cd.incoming_linkers_vec[j];
+			cd.learnLinkers[j] = !link->isFrozen() && learnableLinkers.find( link ) == learnableLinkers.end();
+			cd.needDeltas = cd.needDeltas || cd.learnLinkers[j];
+		}
+	}
+	// --- the deltas are needed also where they reach a Cluster that needs them
+	bool changed = true;
+	while( changed ) {
+		changed = false;
+		for ( u_int i=0; i<cluster_deltas_vec.size(); ++i ) {
+			cluster_deltas& cd = cluster_deltas_vec[i];
+			if ( cd.needDeltas ) continue;
+			for ( u_int j=0; j<cd.incoming_linkers_vec.size(); ++j ) {
+				std::map<Cluster*, int>::iterator it = mapIndex.find( cd.incoming_linkers_vec[j]->from() );
+				if ( it != mapIndex.end() && cluster_deltas_vec[it->second].needDeltas ) {
+					cd.needDeltas = true;
+					changed = true;
+					break;
+				}
+			}
+		}
+	}
+}
+
 void BackPropagationAlgo::enableMomentum() {
 	for ( u_int i=0; i<cluster_deltas_vec.size(); ++i ) {
 		for ( u_int j=0;  j<cluster_deltas_vec[i].incoming_linkers_vec.size(); ++j ) {
@@ -88,9 +143,10 @@ void BackPropagationAlgo::enableMomentum() {
 }
 
 void BackPropagationAlgo::propagDeltas() {
+	NNFW_PROFILE_SCOPE( "BackPropagationAlgo::propagDeltas" );
 	RealVec diff_vec;
 	for( int i=0; i<(int)cluster_deltas_vec.size(); i++ ) {
-		cluster_deltas_vec[i].incoming_linkers_vec;
+		if ( !cluster_deltas_vec[i].needDeltas ) continue;
 		// --- propagate DeltaOutput to DeltaInputs
 		diff_vec.resize( cluster_deltas_vec[i].deltas_inputs.size() );
 		const DerivableOutputFunction* diff_output_function = dynamic_cast<const DerivableOutputFunction*>( cluster_deltas_vec[i].cluster->getFunction( ) );
@@ -113,6 +169,7 @@ void BackPropagationAlgo::propagDeltas() {
 				continue;
 			}
 			int from_index = mapIndex[ link->from() ];
+			if ( !cluster_deltas_vec[from_index].needDeltas ) continue;
 			RealMat::mul( cluster_deltas_vec[from_index].deltas_outputs, link->matrix(), cluster_deltas_vec[i].deltas_inputs );
 		}
 	}
@@ -120,14 +177,22 @@ void BackPropagationAlgo::propagDeltas() {
 }
 
 void BackPropagationAlgo::learn() {
+	NNFW_PROFILE_SCOPE( "BackPropagationAlgo::learn" );
+	if ( learnablesDirty || frozenSeen != Updatable::frozenChanges() ) {
+		updateLearnables();
+	}
     zeroingDeltas();
 	// --- propagating the error through the net
 	propagDeltas();
     applyDeltas();
+	if ( sharedTraining ) {
+		sharedTraining->stepDone();
+	}
 	return;
 }
 
 void BackPropagationAlgo::zeroingDeltas() {
+	NNFW_PROFILE_SCOPE( "BackPropagationAlgo::zeroingDeltas" );
 	// --- zeroing previous step delta information
 	for ( u_int i=0; i<cluster_deltas_vec.size(); ++i ) {
 		if ( cluster_deltas_vec[i].isOutput ) continue;
@@ -136,12 +201,15 @@ void BackPropagationAlgo::zeroingDeltas() {
 }
 
 void BackPropagationAlgo::applyDeltas() {
+	NNFW_PROFILE_SCOPE( "BackPropagationAlgo::applyDeltas" );
 	// --- make the learn !!
 	for ( u_int i=0; i<cluster_deltas_vec.size(); ++i ) {
-		RealVec minus_ones( cluster_deltas_vec[i].cluster->outputs().size( ), -1.0f );
-		cluster_deltas_vec[i].modcluster->rule( -learn_rate, minus_ones, cluster_deltas_vec[i].deltas_inputs );
+		if ( cluster_deltas_vec[i].learnCluster ) {
+			cluster_deltas_vec[i].modcluster->rule( -learn_rate, cluster_deltas_vec[i].minus_ones, cluster_deltas_vec[i].deltas_inputs );
+		}
 
 		for ( u_int j=0;  j<cluster_deltas_vec[i].incoming_linkers_vec.size(); ++j ) {
+			if ( !cluster_deltas_vec[i].learnLinkers[j] ) continue;
 			cluster_deltas_vec[i].incoming_modlinkers[j]->rule(
 				-learn_rate,
 				cluster_deltas_vec[i].incoming_linkers_vec[j]->from()->outputs(),
@@ -163,26 +231,21 @@ void BackPropagationAlgo::applyDeltas() {
 
 void BackPropagationAlgo::learn( const Pattern& pat ) {
 	// --- set the inputs of the net
-	const ClusterVec& clins = net()->inputClusters();
-	for( u_int i=0; i<clins.size(); i++ ) {
-		clins[i]->inputs().assign( pat.inputsOf( clins[i] ) );
-	}
+	bindInputs( pat );
 	// --- spread the net
 	net()->step();
-	// --- set the teaching input
+	// --- set the teaching input (targets are read in place)
 	const ClusterVec& clout = net()->outputClusters();
 	for( u_int i=0; i<clout.size(); i++ ) {
 		setTeachingInput( clout[i], pat.outputsOf( clout[i] ) );
 	}
 	learn();
+	if ( !keepBound ) unbindInputs();
 }
 
 Real BackPropagationAlgo::calculateMSE( const Pattern& pat ) {
 	// --- set the inputs of the net
-	const ClusterVec& clins = net()->inputClusters();
-	for( u_int i=0; i<clins.size(); i++ ) {
-		clins[i]->inputs().assign( pat.inputsOf( clins[i] ) );
-	}
+	bindInputs( pat );
 	// --- spread the net
 	net()->step();
 	// --- calculate the MSE
@@ -192,46 +255,95 @@ Real BackPropagationAlgo::calculateMSE( const Pattern& pat ) {
 	for( int i=0; i<dim; i++ ) {
 		mseacc += RealVec::mse( clout[i]->outputs(), pat.outputsOf( clout[i] ) );
 	}
+	if ( !keepBound ) unbindInputs();
 	return mseacc/dim;
 }
 
+void BackPropagationAlgo::learnOnSet( const DataSet& set ) {
+	keepBound = true;
+	LearningAlgorithm::learnOnSet( set );
+	keepBound = false;
+	unbindInputs();
+}
+
+Real BackPropagationAlgo::calculateMSEOnSet( const DataSet& set ) {
+	keepBound = true;
+	Real mse = LearningAlgorithm::calculateMSEOnSet( set );
+	keepBound = false;
+	unbindInputs();
+	return mse;
+}
+
+void BackPropagationAlgo::learnOnSet( PatternStream& stream ) {
+	keepBound = true;
+	LearningAlgorithm::learnOnSet( stream );
+	keepBound = false;
+	unbindInputs();
+}
+
+Real BackPropagationAlgo::calculateMSEOnSet( PatternStream& stream ) {
+	keepBound = true;
+	Real mse = LearningAlgorithm::calculateMSEOnSet( stream );
+	keepBound = false;
+	unbindInputs();
+	return mse;
+}
+
+void BackPropagationAlgo::bindInputs( const Pattern& pat ) {
+	const ClusterVec& clins = net()->inputClusters();
+	for( u_int i=0; i<clins.size(); i++ ) {
+		const RealVec& ins = pat.inputsOf( clins[i] );
+		// --- an input Cluster reached by Linkers would write into the Pattern, so it gets a copy
+		if ( ins.size() == clins[i]->numNeurons() && net()->linkers( clins[i], false ).size() == 0 ) {
+			// --- binding again to the same RealVec (the rows of a DataSet) only moves the view;
+			// --- the Pattern is never written, as only the Linkers write the inputs of a Cluster
+			clins[i]->bindInputs( const_cast<RealVec&>( ins ) );
+		} else {
+			// --- while learning a set the Cluster may be still bound to the previous Pattern
+			clins[i]->unbindInputs();
+			clins[i]->inputs().assign( ins );
+		}
+	}
+}
+
+void BackPropagationAlgo::unbindInputs() {
+	const ClusterVec& clins = net()->inputClusters();
+	for( u_int i=0; i<clins.size(); i++ ) {
+		clins[i]->unbindInputs();
+	}
+}
+
 void BackPropagationAlgo::addCluster( Cluster* cl, bool isOut ) {
 	if( mapIndex.count( cl ) == 0 ) {
-		cluster_deltas temp;
+		// --- the entry is filled in place instead of copying a temporary into the vector
+		u_int id = cluster_deltas_vec.size();
+		cluster_deltas_vec.resize( id+1 );
+		cluster_deltas& cd = cluster_deltas_vec[id];
 		int size = cl->numNeurons();
-		temp.cluster = cl;
-		temp.modcluster = Factory::createModifierFor( temp.cluster );
-		temp.isOutput = isOut;
-		temp.deltas_outputs.resize( size );
-		temp.deltas_inputs.resize( size );
-		temp.last_deltas_inputs.resize( size );
-		cluster_deltas_vec.push_back( temp );
-		mapIndex[cl] = cluster_deltas_vec.size()-1;
+		cd.cluster = cl;
+		cd.modcluster = Factory::createModifierFor( cd.cluster );
+		cd.isOutput = isOut;
+		cd.hasBiases = ( dynamic_cast<BiasedCluster*>( cl ) != 0 );
+		cd.learnCluster = cd.hasBiases;
+		cd.needDeltas = true;
+		cd.deltas_outputs.resize( size );
+		cd.deltas_inputs.resize( size );
+		cd.last_deltas_inputs.resize( size );
+		cd.minus_ones.resize( size );
+		cd.minus_ones.setAll( -1.0f );
+		mapIndex[cl] = id;
 	}
 }
 
 void BackPropagationAlgo::addLinker( Linker* link ) {
-	if ( mapIndex.count( link->to() ) == 0 ) {
-		cluster_deltas temp;
-		int size = link->to()->numNeurons();
-		temp.cluster = link->to();
-		temp.modcluster = Factory::createModifierFor( temp.cluster );
-		temp.isOutput = false;
-		temp.deltas_outputs.resize( size );
-		temp.deltas_inputs.resize( size );
-		temp.last_deltas_inputs.resize( size );
-		temp.incoming_linkers_vec.push_back( link );
-		temp.incoming_modlinkers.push_back( Factory::createModifierFor( link ) );
-		temp.incoming_last_outputs.push_back( RealVec( link->from()->numNeurons() ) );
-		cluster_deltas_vec.push_back( temp );
-		mapIndex[temp.cluster] = cluster_deltas_vec.size()-1;
-	}
-	else {
-		int tmp = mapIndex[link->to()];
-		cluster_deltas_vec[ tmp ].incoming_linkers_vec.push_back( link );
-		cluster_deltas_vec[ tmp ].incoming_modlinkers.push_back( Factory::createModifierFor( link ) );
-		cluster_deltas_vec[ tmp ].incoming_last_outputs.push_back( RealVec( link->from()->numNeurons() ) );
-	}
+	addCluster( link->to(), false );
+	cluster_deltas& cd = cluster_deltas_vec[ mapIndex[link->to()] ];
+	cd.incoming_linkers_vec.push_back( link );
+	cd.incoming_modlinkers.push_back( Factory::createModifierFor( link ) );
+	VectorData<RealVec>& lasts = cd.incoming_last_outputs;
+	lasts.resize( lasts.size()+1 );
+	lasts[ lasts.size()-1 ].resize( link->from()->numNeurons() );
+	cd.learnLinkers.push_back( true );
 }
 
 }
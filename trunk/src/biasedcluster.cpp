@@ -31,7 +31,8 @@ BiasedCluster::BiasedCluster( u_int numNeurons, const char* name )
     biasesdata.zeroing();
     tempdata.zeroing();
     propdefs();
-    setTypename( "BiasedCluster" );
+    static const PropertyKey typeKey( "BiasedCluster" );
+    setTypename( typeKey );
 }
 
 BiasedCluster::BiasedCluster( PropertySettings& prop )
@@ -43,7 +44,8 @@ BiasedCluster::BiasedCluster( PropertySettings& prop )
         setBiases( v );
     }
     propdefs();
-    setTypename( "BiasedCluster" );
+    static const PropertyKey typeKey( "BiasedCluster" );
+    setTypename( typeKey );
 }
 
 BiasedCluster::~BiasedCluster() {
@@ -55,6 +57,18 @@ void BiasedCluster::update() {
     setNeedReset( true );
 }
 
+void BiasedCluster::updateCost( double& flops, double& bytes ) const {
+    Cluster::updateCost( flops, bytes );
+    // --- subtraction of biases into tempdata
+    const double n = numNeurons();
+    flops += n;
+    bytes += 2.0*n*sizeof(Real);
+}
+
+void BiasedCluster::workingMemory( std::vector<RealVec*>& buffers ) {
+    buffers.push_back( &tempdata );
+}
+
 void BiasedCluster::setBias( u_int neuron, Real bias ) {
 #ifdef NNFW_DEBUG
     if ( neuron >= numNeurons() ) {
@@ -84,9 +98,7 @@ Real BiasedCluster::getBias( u_int neuron ) {
 }
 
 void BiasedCluster::randomize( Real min, Real max ) {
-    for ( u_int i = 0; i < numNeurons(); i++ ) {
-        biasesdata[i] = Random::flatReal( min, max );
-    }
+    Random::flatRealVec( biasesdata, min, max );
 }
 
 BiasedCluster* BiasedCluster::clone() const {
@@ -0,0 +1,452 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "bpttalgo.h"
+#include "neuralnet.h"
+#include "biasedcluster.h"
+#include "fakecluster.h"
+#include "ddecluster.h"
+#include "gatedcluster.h"
+#include "dotlinker.h"
+#include "copylinker.h"
+#include "derivableoutputfunction.h"
+#include "liboutputfunctions.h"
+
+namespace nnfw {
+
+BPTTAlgo::BPTTAlgo( BaseNeuralNet* net, u_int window, Real rate )
+	: LearningAlgorithm(net), learn_rate(rate), winsize(window), hsize(window+1), tnext(0), nsteps(0),
+	  cls(), lks(), clsIndex(), lksIndex(), ordCls(), ordLks() {
+	if ( winsize == 0 ) {
+		nWarning() << "The window of BPTTAlgo can't be zero; it will be one step";
+		winsize = 1;
+		hsize = 2;
+	}
+	// --- history and deltas of all Clusters
+	const ClusterVec& clv = net->clusters();
+	for( u_int i=0; i<clv.size(); i++ ) {
+		Cluster* cl = clv[i];
+		u_int n = cl->numNeurons();
+		clusterInfo ci;
+		ci.cluster = cl;
+		ci.pos = -1;
+		ci.ins = new RealMat( hsize, n );
+		ci.outs = new RealMat( hsize, n );
+		ci.dOuts = new RealMat( winsize, n );
+		ci.dIns = new RealMat( winsize, n );
+		ci.errs = 0;
+		ci.diff = new RealVec( n );
+		ci.biased = dynamic_cast<BiasedCluster*>( cl );
+		ci.bgrad = ( ci.biased ) ? new RealVec( n ) : 0;
+		ci.deriv = dynamic_cast<const DerivableOutputFunction*>( cl->getFunction() );
+		ci.leaky = dynamic_cast<LeakyIntegratorFunction*>( cl->getFunction() );
+		ci.identity = ( dynamic_cast<FakeCluster*>( cl ) != 0 );
+		ci.isDDE = false;
+		ci.ddeF = 0.0;
+		ci.ddeX = 0.0;
+		ci.ddePast = 0;
+		ci.fx = 0;
+		DDECluster* dde = dynamic_cast<DDECluster*>( cl );
+		if ( dde ) {
+			// --- y(t) = a0 + a1*f(x) + a2*x + sum_j pastCoeff[j] * y(t-1-j)
+			const RealVec& coeff = dde->getCoeff();
+			u_int csize = coeff.size();
+			ci.isDDE = true;
+			ci.leaky = 0;
+			ci.ddeF = ( csize > 1 ) ? coeff[1] : 0.0;
+			ci.ddeX = ( csize > 2 ) ? coeff[2] : 0.0;
+			ci.ddePast = new RealVec( dde->pastCoeff().size() );
+			ci.ddePast->assign( dde->pastCoeff() );
+			ci.fx = new RealVec( n );
+		}
+		ci.gated = dynamic_cast<GatedCluster*>( cl );
+		ci.states = 0;
+		ci.xhs = 0;
+		ci.dzs = 0;
+		ci.dState = 0;
+		ci.dxh = 0;
+		if ( ci.gated ) {
+			u_int gn = ci.gated->numGates()*n;
+			ci.leaky = 0;
+			ci.bgrad = new RealVec( gn );
+			ci.states = new RealMat( hsize, ci.gated->stateSize() );
+			ci.xhs = new RealMat( winsize, 2*n );
+			ci.dzs = new RealMat( winsize, gn );
+			ci.dState = new RealVec( ci.gated->stateSize() );
+			ci.dxh = new RealVec( 2*n );
+		}
+		if ( !ci.identity && !ci.isDDE && !ci.gated && !ci.leaky && !ci.deriv ) {
+			nWarning() << "No derivative for the activation function of " << cl->name() << "; the identity will be used";
+		}
+		clsIndex[cl] = cls.size();
+		cls.append( ci );
+	}
+	const ClusterVec& outv = net->outputClusters();
+	for( u_int i=0; i<outv.size(); i++ ) {
+		clusterInfo& ci = cls[ clsIndex[outv[i]] ];
+		ci.errs = new RealMat( winsize, outv[i]->numNeurons() );
+	}
+	// --- positions into the order and the Linkers propagating the deltas
+	const UpdatableVec& ord = net->order();
+	ordCls.resize( ord.size() );
+	ordLks.resize( ord.size() );
+	for( u_int p=0; p<ord.size(); p++ ) {
+		ordCls[p] = -1;
+		ordLks[p] = -1;
+		Cluster* cl = dynamic_cast<Cluster*>( ord[p] );
+		if ( cl && clsIndex.count( cl ) ) {
+			ordCls[p] = clsIndex[cl];
+			cls[ ordCls[p] ].pos = p;
+			continue;
+		}
+		Linker* lk = dynamic_cast<Linker*>( ord[p] );
+		if ( !lk || !clsIndex.count( lk->from() ) || !clsIndex.count( lk->to() ) ) continue;
+		linkerInfo li;
+		li.linker = lk;
+		li.pos = p;
+		li.from = clsIndex[ lk->from() ];
+		li.to = clsIndex[ lk->to() ];
+		li.dot = dynamic_cast<DotLinker*>( lk );
+		li.copyFromIns = false;
+		li.copySize = 0;
+		li.xs = 0;
+		li.ds = 0;
+		if ( li.dot ) {
+			li.xs = new RealMat( winsize, lk->from()->numNeurons() );
+			li.ds = new RealMat( winsize, lk->to()->numNeurons() );
+		} else {
+			CopyLinker* cp = dynamic_cast<CopyLinker*>( lk );
+			if ( cp && ( cp->getMode() == CopyLinker::In2In || cp->getMode() == CopyLinker::Out2In ) ) {
+				li.copyFromIns = ( cp->getMode() == CopyLinker::In2In );
+				li.copySize = cp->size();
+			} else {
+				nWarning() << "The Linker " << lk->name() << " doesn't propagate the gradient in BPTTAlgo";
+				continue;
+			}
+		}
+		ordLks[p] = lks.size();
+		lksIndex[lk] = lks.size();
+		lks.append( li );
+	}
+	reset();
+}
+
+BPTTAlgo::~BPTTAlgo() {
+	for( u_int i=0; i<cls.size(); i++ ) {
+		delete cls[i].ins;
+		delete cls[i].outs;
+		delete cls[i].dOuts;
+		delete cls[i].dIns;
+		delete cls[i].errs;
+		delete cls[i].diff;
+		delete cls[i].bgrad;
+		delete cls[i].ddePast;
+		delete cls[i].fx;
+		delete cls[i].states;
+		delete cls[i].xhs;
+		delete cls[i].dzs;
+		delete cls[i].dState;
+		delete cls[i].dxh;
+	}
+	for( u_int i=0; i<lks.size(); i++ ) {
+		delete lks[i].xs;
+		delete lks[i].ds;
+	}
+}
+
+void BPTTAlgo::dontLearn( Cluster* cluster ) {
+	if ( clsIndex.count( cluster ) == 0 ) return;
+	clusterInfo& ci = cls[ clsIndex[cluster] ];
+	delete ci.bgrad;
+	ci.bgrad = 0;
+}
+
+void BPTTAlgo::dontLearn( Linker* linker ) {
+	if ( lksIndex.count( linker ) == 0 ) return;
+	linkerInfo& li = lks[ lksIndex[linker] ];
+	delete li.xs;
+	delete li.ds;
+	li.xs = 0;
+	li.ds = 0;
+}
+
+void BPTTAlgo::record( int i, u_int row ) {
+	(*cls[i].ins)[row].assign( cls[i].cluster->inputs() );
+	(*cls[i].outs)[row].assign( cls[i].cluster->outputs() );
+	if ( cls[i].gated ) {
+		(*cls[i].states)[row].assign( cls[i].gated->state() );
+	}
+}
+
+void BPTTAlgo::reset() {
+	nsteps = 0;
+	// --- the current state is the step before the first one of the new sequence
+	u_int row = ( tnext + hsize - 1 ) % hsize;
+	for( u_int i=0; i<cls.size(); i++ ) {
+		record( i, row );
+	}
+}
+
+void BPTTAlgo::step() {
+	if ( nsteps == winsize ) {
+		learn();
+	}
+	u_int row = tnext;
+	// --- the Clusters not updated by the net are recorded before the step
+	for( u_int i=0; i<cls.size(); i++ ) {
+		if ( cls[i].pos < 0 ) record( i, row );
+	}
+	const UpdatableVec& ord = net()->order();
+	for( u_int p=0; p<ord.size(); p++ ) {
+		{
+			NNFW_PROFILE_SCOPE( ord[p] );
+			ord[p]->update();
+		}
+		if ( ordCls[p] >= 0 ) {
+			record( ordCls[p], row );
+		}
+	}
+	for( u_int i=0; i<cls.size(); i++ ) {
+		if ( cls[i].errs ) (*cls[i].errs)[nsteps].zeroing();
+	}
+	nsteps++;
+	tnext = ( tnext + 1 ) % hsize;
+}
+
+void BPTTAlgo::setTeachingInput( Cluster* output, const RealVec& ti ) {
+	if ( nsteps == 0 || clsIndex.count( output ) == 0 ) return;
+	clusterInfo& ci = cls[ clsIndex[output] ];
+	if ( !ci.errs || ti.size() != output->numNeurons() ) return;
+	u_int row = ( tnext + hsize - 1 ) % hsize;
+	(*ci.errs)[nsteps-1].assign_xminusy( (*ci.outs)[row], ti );
+}
+
+void BPTTAlgo::backwardCluster( clusterInfo& ci, int k, u_int row ) {
+	RealVec& dout = (*ci.dOuts)[k];
+	RealVec& diff = *ci.diff;
+	RealVec& in = (*ci.ins)[row];
+	RealVec& out = (*ci.outs)[row];
+	if ( ci.gated ) {
+		// --- xh <- inputs of step k followed by the outputs of step k-1
+		u_int n = ci.cluster->numNeurons();
+		u_int prow = ( row + hsize - 1 ) % hsize;
+		RealVec& xh = (*ci.xhs)[k];
+		RealVec& prevOut = (*ci.outs)[prow];
+		for( u_int i=0; i<n; i++ ) {
+			xh[i] = in[i];
+			xh[n+i] = prevOut[i];
+		}
+		RealVec& dz = (*ci.dzs)[k];
+		RealVec& dxh = *ci.dxh;
+		ci.gated->backward( xh, (*ci.states)[prow], (*ci.states)[row], dout, *ci.dState, dxh, dz );
+		RealVec& din = (*ci.dIns)[k];
+		for( u_int i=0; i<n; i++ ) {
+			din[i] += dxh[i];
+		}
+		if ( k > 0 ) {
+			RealVec& dprev = (*ci.dOuts)[k-1];
+			for( u_int i=0; i<n; i++ ) {
+				dprev[i] += dxh[n+i];
+			}
+		}
+		if ( ci.bgrad ) {
+			*ci.bgrad += dz;
+		}
+		return;
+	}
+	// --- diff <- derivative of outputs respect to inputs
+	if ( ci.identity ) {
+		diff.assign( diff.size(), 1.0 );
+	} else if ( ci.isDDE ) {
+		if ( ci.deriv && ci.ddeF != 0.0 ) {
+			ci.cluster->getFunction()->apply( in, *ci.fx );
+			ci.deriv->derivate( in, *ci.fx, diff );
+			diff *= ci.ddeF;
+		} else {
+			diff.assign( diff.size(), ci.ddeF );
+		}
+		diff += ci.ddeX;
+		// --- the past outputs
+		for( u_int j=0; j<ci.ddePast->size() && (int)j<k; j++ ) {
+			RealVec& past = (*ci.dOuts)[k-1-j];
+			Real c = (*ci.ddePast)[j];
+			for( u_int i=0; i<past.size(); i++ ) {
+				past[i] += c * dout[i];
+			}
+		}
+	} else if ( ci.leaky ) {
+		// --- y(t) = delta*y(t-1) + (1-delta)*x
+		diff.assign( diff.size(), 1.0 );
+		diff -= ci.leaky->delta;
+		if ( k > 0 ) {
+			(*ci.dOuts)[k-1].deltarule( 1.0, dout, ci.leaky->delta );
+		}
+	} else if ( ci.deriv ) {
+		ci.deriv->derivate( in, out, diff );
+	} else {
+		diff.assign( diff.size(), 1.0 );
+	}
+	// --- diff <- deltas of inputs due to outputs
+	diff *= dout;
+	(*ci.dIns)[k] += diff;
+	if ( ci.bgrad ) {
+		*ci.bgrad += diff;
+	}
+}
+
+void BPTTAlgo::backwardLinker( linkerInfo& li, int k, u_int start ) {
+	clusterInfo& src = cls[li.from];
+	clusterInfo& dst = cls[li.to];
+	// --- the step of the data read from source and the step in which destination uses the data written
+	int ka = ( src.pos < li.pos ) ? k : k-1;
+	int kb = ( dst.pos > li.pos ) ? k : k+1;
+	bool hasDelta = ( dst.pos >= 0 && kb < (int)nsteps );
+	if ( li.dot ) {
+		if ( li.xs ) {
+			(*li.xs)[k].assign( (*src.outs)[ ( start + hsize + ka ) % hsize ] );
+			if ( hasDelta ) {
+				(*li.ds)[k].assign( (*dst.dIns)[kb] );
+			} else {
+				(*li.ds)[k].zeroing();
+			}
+		}
+		if ( hasDelta && ka >= 0 ) {
+			RealMat::mul( (*src.dOuts)[ka], li.dot->matrix(), (*dst.dIns)[kb] );
+		}
+		return;
+	}
+	if ( !hasDelta || ka < 0 ) return;
+	RealVec& to = ( li.copyFromIns ) ? (*src.dIns)[ka] : (*src.dOuts)[ka];
+	const RealVec& from = (*dst.dIns)[kb];
+	for( u_int i=0; i<li.copySize; i++ ) {
+		to[i] += from[i];
+	}
+}
+
+void BPTTAlgo::learn() {
+	if ( nsteps == 0 ) return;
+	NNFW_PROFILE_SCOPE( "BPTTAlgo::learn" );
+	u_int start = ( tnext + hsize - nsteps ) % hsize;
+	{
+		NNFW_PROFILE_SCOPE( "BPTTAlgo::zeroingDeltas" );
+		for( u_int i=0; i<cls.size(); i++ ) {
+			if ( cls[i].errs ) {
+				cls[i].dOuts->assign( *(cls[i].errs) );
+			} else {
+				cls[i].dOuts->zeroing();
+			}
+			cls[i].dIns->zeroing();
+			if ( cls[i].bgrad ) cls[i].bgrad->zeroing();
+			if ( cls[i].dState ) cls[i].dState->zeroing();
+		}
+	}
+	// --- propagate the deltas backward through steps and through the order
+	{
+		NNFW_PROFILE_SCOPE( "BPTTAlgo::propagDeltas" );
+		for( int k=nsteps-1; k>=0; k-- ) {
+			u_int row = ( start + k ) % hsize;
+			for( int p=(int)ordCls.size()-1; p>=0; p-- ) {
+				if ( ordCls[p] >= 0 ) {
+					backwardCluster( cls[ ordCls[p] ], k, row );
+				} else if ( ordLks[p] >= 0 ) {
+					backwardLinker( lks[ ordLks[p] ], k, start );
+				}
+			}
+		}
+	}
+	// --- modify the net with the gradients of the whole window
+	{
+		NNFW_PROFILE_SCOPE( "BPTTAlgo::applyDeltas" );
+		for( u_int i=0; i<cls.size(); i++ ) {
+			if ( !cls[i].bgrad || cls[i].cluster->isFrozen() ) continue;
+			if ( cls[i].gated ) {
+				GatedCluster* gc = cls[i].gated;
+				gc->weights().batchDeltarule( -learn_rate, *cls[i].xhs, *cls[i].dzs, nsteps );
+				*cls[i].bgrad *= learn_rate;
+				gc->biases() -= *cls[i].bgrad;
+				gc->constrainWeights();
+				continue;
+			}
+			*cls[i].bgrad *= learn_rate;
+			cls[i].biased->biases() += *cls[i].bgrad;
+		}
+		for( u_int i=0; i<lks.size(); i++ ) {
+			if ( !lks[i].xs || lks[i].linker->isFrozen() ) continue;
+			lks[i].dot->matrix().batchDeltarule( -learn_rate, *lks[i].xs, *lks[i].ds, nsteps );
+			lks[i].dot->weightsChanged();
+		}
+	}
+	nsteps = 0;
+}
+
+void BPTTAlgo::learn( const Pattern& pat ) {
+	const ClusterVec& clins = net()->inputClusters();
+	for( u_int i=0; i<clins.size(); i++ ) {
+		const RealVec& ins = pat.inputsOf( clins[i] );
+		if ( ins.size() != clins[i]->numNeurons() ) continue;
+		clins[i]->inputs().assign( ins );
+	}
+	step();
+	const ClusterVec& clout = net()->outputClusters();
+	for( u_int i=0; i<clout.size(); i++ ) {
+		setTeachingInput( clout[i], pat.outputsOf( clout[i] ) );
+	}
+	if ( nsteps == winsize ) {
+		learn();
+	}
+}
+
+Real BPTTAlgo::calculateMSE( const Pattern& pat ) {
+	const ClusterVec& clins = net()->inputClusters();
+	for( u_int i=0; i<clins.size(); i++ ) {
+		const RealVec& ins = pat.inputsOf( clins[i] );
+		if ( ins.size() != clins[i]->numNeurons() ) continue;
+		clins[i]->inputs().assign( ins );
+	}
+	net()->step();
+	const ClusterVec& clout = net()->outputClusters();
+	Real mseacc = 0.0;
+	int dim = (int)clout.size();
+	for( int i=0; i<dim; i++ ) {
+		mseacc += RealVec::mse( clout[i]->outputs(), pat.outputsOf( clout[i] ) );
+	}
+	// --- the recorded steps are not contiguous anymore
+	reset();
+	return mseacc/dim;
+}
+
+void BPTTAlgo::learnOnSet( const PatternSet& set ) {
+	reset();
+	LearningAlgorithm::learnOnSet( set );
+	learn();
+}
+
+void BPTTAlgo::learnOnSet( const DataSet& set ) {
+	reset();
+	LearningAlgorithm::learnOnSet( set );
+	learn();
+}
+
+void BPTTAlgo::learnOnSet( PatternStream& stream ) {
+	reset();
+	LearningAlgorithm::learnOnSet( stream );
+	learn();
+}
+
+}
@@ -30,8 +30,12 @@ namespace nnfw {
  **********************************************/
 
 Cluster::Cluster( u_int numNeurons, const char* name )
-    : Updatable(name), inputdata(numNeurons), outputdata(numNeurons) {
+    : Updatable(name), inputstore(numNeurons), outputstore(numNeurons), inputdata(), outputdata() {
     this->numneurons = numNeurons;
+    insBound = true;
+    outsBound = true;
+    Cluster::unbindInputs();
+    Cluster::unbindOutputs();
     outputdata.zeroing();
     inputdata.zeroing();
     accOff = true;
@@ -46,7 +50,7 @@ Cluster::Cluster( u_int numNeurons, const char* name )
 }
 
 Cluster::Cluster( PropertySettings& prop )
-    : Updatable(prop), inputdata(0), outputdata(0) {
+    : Updatable(prop), inputstore(0), outputstore(0), inputdata(), outputdata() {
     // --- Configuring Name
     Variant& v = prop["name"];
     if ( !v.isNull() ) {
@@ -64,8 +68,14 @@ Cluster::Cluster( PropertySettings& prop )
 		nFatal() << "the dimension of Cluster is mandatory";
 		exit(1);
 	}
-    inputdata.resize( numneurons );
-    outputdata.resize( numneurons );
+    inputstore.resize( numneurons );
+    outputstore.resize( numneurons );
+    inputstore.zeroing();
+    outputstore.zeroing();
+    insBound = true;
+    outsBound = true;
+    Cluster::unbindInputs();
+    Cluster::unbindOutputs();
     // --- Configuring Accumulate modality
     v = prop["accumulate"];
     if ( v.isNull() ) {
@@ -154,6 +164,52 @@ Real Cluster::getOutput( u_int neuron ) const {
     return outputdata[neuron];
 }
 
+bool Cluster::bindInputs( RealVec& src ) {
+    if ( src.size() != numneurons ) {
+        nError() << "The size of the vector to bind differs from the number of neurons; the inputs will not be bound";
+        return false;
+    }
+    if ( numneurons > 0 ) {
+        inputdata.convertToView( src, 0, numneurons );
+    }
+    insBound = true;
+    return true;
+}
+
+void Cluster::unbindInputs() {
+    if ( !insBound ) return;
+    if ( numneurons > 0 ) {
+        inputdata.convertToView( inputstore, 0, numneurons );
+    }
+    insBound = false;
+}
+
+bool Cluster::bindOutputs( RealVec& src ) {
+    if ( src.size() != numneurons ) {
+        nError() << "The size of the vector to bind differs from the number of neurons; the outputs will not be bound";
+        return false;
+    }
+    if ( numneurons > 0 ) {
+        outputdata.convertToView( src, 0, numneurons );
+    }
+    outsBound = true;
+    return true;
+}
+
+void Cluster::unbindOutputs() {
+    if ( !outsBound ) return;
+    if ( numneurons > 0 ) {
+        outputdata.convertToView( outputstore, 0, numneurons );
+    }
+    outsBound = false;
+}
+
+void Cluster::updateCost( double& flops, double& bytes ) const {
+    const double n = numNeurons();
+    flops = n*updater->applyCost();
+    bytes = 2.0*n*sizeof(Real);
+}
+
 Cluster* Cluster::clone() const {
 	nError() << "The clone() method has to implemented by subclasses";
 	return 0;
@@ -41,7 +41,8 @@ CopyLinker::CopyLinker( Cluster* from, Cluster* to, CopyMode mode, const char* n
     setMode( mode );
 
     addProperty( "mode", Variant::t_string, this, &CopyLinker::getModeP, &CopyLinker::setMode );
-    setTypename( "CopyLinker" );
+    static const PropertyKey typeKey( "CopyLinker" );
+    setTypename( typeKey );
 }
 
 CopyLinker::CopyLinker( PropertySettings& prop )
@@ -59,7 +60,8 @@ CopyLinker::CopyLinker( PropertySettings& prop )
         setMode( v );
     };
     addProperty( "mode", Variant::t_string, this, &CopyLinker::getModeP, &CopyLinker::setMode );
-    setTypename( "CopyLinker" );
+    static const PropertyKey typeKey( "CopyLinker" );
+    setTypename( typeKey );
 }
 
 CopyLinker::~CopyLinker() {
@@ -139,6 +141,12 @@ void CopyLinker::update() {
     return;
 }
 
+void CopyLinker::updateCost( double& flops, double& bytes ) const {
+    const double n = dimData;
+    flops = n;
+    bytes = 3.0*n*sizeof(Real);
+}
+
 u_int CopyLinker::size() const {
     return dimData;
 }
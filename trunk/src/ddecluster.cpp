@@ -23,14 +23,15 @@
 namespace nnfw {
 
 DDECluster::DDECluster( const RealVec& c, u_int numNeurons, const char* name )
-    : Cluster( numNeurons, name ), tmpdata(numNeurons), tmpdata2(numNeurons) {
+    : Cluster( numNeurons, name ), tmpdata(numNeurons) {
     setCoeff( c );
     propdefs();
-    setTypename( "DDECluster" );
+    static const PropertyKey typeKey( "DDECluster" );
+    setTypename( typeKey );
 }
 
 DDECluster::DDECluster( PropertySettings& prop )
-    : Cluster( prop ), tmpdata( numNeurons() ), tmpdata2( numNeurons() ) {
+    : Cluster( prop ), tmpdata( numNeurons() ) {
     Variant& v = prop["coeff"];
     if ( v.isNull() ) {
         setCoeff( RealVec() );
@@ -38,7 +39,8 @@ DDECluster::DDECluster( PropertySettings& prop )
         setCoeff( v );
     }
     propdefs();
-    setTypename( "DDECluster" );
+    static const PropertyKey typeKey( "DDECluster" );
+    setTypename( typeKey );
 }
 
 DDECluster::~DDECluster() {
@@ -52,10 +54,23 @@ void DDECluster::propdefs() {
 void DDECluster::setCoeff( const RealVec& c ) {
     coeff.resize( c.size() );
     coeff.assign( c );
-    ds.resize( (c.size()>3) ? c.size()-3 : 0 );
-    for( u_int i=0; i<ds.size(); i++ ) {
-        ds[i].resize( numNeurons() );
-        ds[i].zeroing();
+    // --- the i-th derivative at t-1 is sum_j (-1)^j * C(i,j) * y(t-1-j)
+    u_int m = (c.size()>3) ? c.size()-3 : 0;
+    pcoeff.resize( m );
+    pcoeff.zeroing();
+    for( u_int d=0; d<m; d++ ) {
+        Real binom = 1.0;
+        for( u_int j=0; j<=d; j++ ) {
+            pcoeff[j] += ( (j%2==0) ? 1.0 : -1.0 ) * binom * coeff[d+3];
+            binom = binom * (d-j) / (j+1);
+        }
+    }
+    history.resize( m );
+    ring.resize( m );
+    for( u_int i=0; i<m; i++ ) {
+        history[i].resize( numNeurons() );
+        history[i].zeroing();
+        ring[i] = &history[i];
     }
 }
 
@@ -70,81 +85,63 @@ Variant DDECluster::getCoeffP() {
 
 void DDECluster::update() {
     u_int csize = coeff.size();
+    RealVec& outs = outputs();
     if ( csize == 0 ) {
         // uscita un po' strana!
-        outputs().zeroing();
+        outs.zeroing();
         setNeedReset( true );
         return;
     }
-
-    // --- tmp <- a0
-    tmpdata.assign( tmpdata.size(), coeff[0] );
-    if ( csize == 1 ) {
-        breakUpdate();
-        return;
-    }
-
-    // --- tmp <- a0 + a1*f(x)
-    getFunction()->apply( inputs(), tmpdata2 );
-    tmpdata2 *= coeff[1];
-    tmpdata += tmpdata2;
-    if ( csize == 2 ) {
-        breakUpdate();
-        return;
+    const RealVec& ins = inputs();
+    const Real a0 = coeff[0];
+    const Real a1 = ( csize > 1 ) ? coeff[1] : 0.0;
+    const Real a2 = ( csize > 2 ) ? coeff[2] : 0.0;
+    if ( a1 != 0.0 ) {
+        getFunction()->apply( inputs(), tmpdata );
     }
-
-    // --- tmp <- a0 + a1*f(x) + a2*x
-    tmpdata2.assign_amulx( coeff[2], inputs() );
-    tmpdata += tmpdata2;
-    if ( csize == 3 ) {
-        breakUpdate();
-        return;
+    const u_int m = ring.size();
+    const u_int n = numNeurons();
+    RealVec* oldest = ( m > 0 ) ? ring[m-1] : 0;
+    // --- y(t) <- a0 + a1*f(x) + a2*x + sum_j pc[j]*y(t-1-j), and y(t) replaces the oldest output
+    for( u_int i=0; i<n; i++ ) {
+        Real y = a0 + a2*ins[i];
+        if ( a1 != 0.0 ) {
+            y += a1*tmpdata[i];
+        }
+        for( u_int j=0; j<m; j++ ) {
+            y += pcoeff[j] * (*ring[j])[i];
+        }
+        outs[i] = y;
+        if ( oldest ) {
+            (*oldest)[i] = y;
+        }
     }
-
-    // --- tmp <- a0 + a1*f(x) + a2*x + a3*y ... aN*y^(n-3)
-    for( u_int i=0; i<ds.size(); i++ ) {
-        tmpdata2.assign_amulx( coeff[i+3], ds[i] );
-        tmpdata += tmpdata2;
+    // --- rotate the ring: the oldest slot becomes y(t-1)
+    if ( m > 0 ) {
+        for( u_int j=m-1; j>0; j-- ) {
+            ring[j] = ring[j-1];
+        }
+        ring[0] = oldest;
     }
-    breakUpdate();
-    return;
+    setNeedReset( true );
 }
 
-void DDECluster::breakUpdate() {
-    outputs().assign( tmpdata );
-    updateDs();
-    setNeedReset( true );
+void DDECluster::updateCost( double& flops, double& bytes ) const {
+    const double n = numNeurons();
+    const double m = ring.size();
+    flops = n*( 2.0 + 2.0*m );
+    bytes = n*( 2.0 + m )*sizeof(Real);
+    if ( coeff.size() > 1 && coeff[1] != 0.0 ) {
+        flops += n*( 2.0 + getFunction()->applyCost() );
+        bytes += 2.0*n*sizeof(Real);
+    }
 }
 
-void DDECluster::updateDs() {
-    if ( ds.size() == 0 ) return;
-    // --- Le derivate sono semplici differenze:
-    // --- y'  = y(t) - y(t-1)
-    // --- y'' = y'(t) - y'(t-1)
-    // ---  ... and so on
-    if ( ds.size() == 1 ) {
-        ds[0].assign( outputs() );
-    } else if ( ds.size() == 2 ) {
-        ds[1].assign_xminusy( outputs(), ds[0] );
-        ds[0].assign( outputs() );
-    } else {
-        // ----- Problemi di questo tipo di calcolo:
-        // *** calcola, cmq, anche la derivata ds.size()+1... l'ultimo tmpdata calcolato prima di uscire.
-        tmpdata.assign( outputs() );
-        for( u_int i=0; i<ds.size(); i++ ) {
-            if ( i%2 == 0 ) {
-                // calcola la derivata i+1 per il ciclo successivo
-                tmpdata2.assign_xminusy( tmpdata, ds[i] );
-                // memorizza il valore della derivata i calcolata al ciclo precedente i-1
-                ds[i].assign( tmpdata );
-            } else {
-                // calcola la derivata i+1 per il ciclo successivo
-                tmpdata.assign_xminusy( tmpdata2, ds[i] );
-                // memorizza il valore della derivata i calcolata al ciclo precedente i-1
-                ds[i].assign( tmpdata2 );
-            }
-        }
+void DDECluster::workingMemory( std::vector<RealVec*>& buffers ) {
+    for( u_int i=0; i<history.size(); i++ ) {
+        buffers.push_back( &history[i] );
     }
+    buffers.push_back( &tmpdata );
 }
 
 DDECluster* DDECluster::clone() const {
@@ -27,13 +27,17 @@
 namespace nnfw {
 
 DotLinker::DotLinker( Cluster* from, Cluster* to, const char* name )
-    : MatrixLinker(from, to, name) {
-    setTypename( "DotLinker" );
+    : MatrixLinker(from, to, name), incremental(false), tolerance(0.0), fullEvery(1000), countdown(0),
+      changes(0), lastx(), contrib() {
+    static const PropertyKey typeKey( "DotLinker" );
+    setTypename( typeKey );
 }
 
 DotLinker::DotLinker( PropertySettings& prop )
-    : MatrixLinker( prop ) {
-    setTypename( "DotLinker" );
+    : MatrixLinker( prop ), incremental(false), tolerance(0.0), fullEvery(1000), countdown(0),
+      changes(0), lastx(), contrib() {
+    static const PropertyKey typeKey( "DotLinker" );
+    setTypename( typeKey );
 }
 
 DotLinker::~DotLinker() {
@@ -44,13 +48,74 @@ void DotLinker::update() {
     if ( to()->needReset() ) {
         to()->resetInputs();
     }
-    RealMat::mul( to()->inputs(), from()->outputs(), matrix() );
+    if ( !incremental ) {
+        RealMat::mul( to()->inputs(), from()->outputs(), matrix() );
+        changes = from()->numNeurons();
+        return;
+    }
+    const RealVec& x = from()->outputs();
+    RealMat& w = matrix();
+    if ( countdown == 0 ) {
+        contrib.zeroing();
+        RealMat::mul( contrib, x, w );
+        lastx.assign( x );
+        changes = x.size();
+        countdown = fullEvery;
+    } else {
+        // --- only the rows of changed outputs
+        const u_int cols = contrib.size();
+        changes = 0;
+        for( u_int j=0; j<x.size(); j++ ) {
+            Real dx = x[j] - lastx[j];
+            if ( dx <= tolerance && dx >= -tolerance ) continue;
+            const RealVec& row = w[j];
+            for( u_int c=0; c<cols; c++ ) {
+                contrib[c] += dx * row[c];
+            }
+            lastx[j] = x[j];
+            changes++;
+        }
+        countdown--;
+    }
+    to()->inputs() += contrib;
     return;
 }
 
+void DotLinker::updateCost( double& flops, double& bytes ) const {
+    // --- in incremental mode only the rows of the changed outputs are used
+    const double r = changes;
+    const double c = cols();
+    flops = 2.0*r*c;
+    bytes = ( r*c + r + 2.0*c )*sizeof(Real);
+}
+
+void DotLinker::workingMemory( std::vector<RealVec*>& buffers ) {
+    buffers.push_back( &lastx );
+    buffers.push_back( &contrib );
+}
+
+void DotLinker::setIncremental( bool b, Real tol, u_int every ) {
+    incremental = b;
+    tolerance = ( tol < 0.0 ) ? -tol : tol;
+    fullEvery = ( every == 0 ) ? 1 : every;
+    if ( incremental ) {
+        lastx.resize( from()->numNeurons() );
+        contrib.resize( to()->numNeurons() );
+    } else {
+        lastx.resize( 0 );
+        contrib.resize( 0 );
+    }
+    countdown = 0;
+}
+
+void DotLinker::weightsChanged() {
+    countdown = 0;
+}
+
 DotLinker* DotLinker::clone() const {
 	DotLinker* newclone = new DotLinker( this->from(), this->to(), name() );
 	newclone->setMatrix( this->matrix() );
+	newclone->setIncremental( incremental, tolerance, fullEvery );
 	return newclone;
 }
 
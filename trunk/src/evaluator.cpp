@@ -0,0 +1,363 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "evaluator.h"
+#include "neuralnet.h"
+#include "matrixlinker.h"
+#include "profiler.h"
+#include "memorypolicy.h"
+#include <QThread>
+#include <vector>
+#include <cmath>
+#include <cstring>
+
+namespace nnfw {
+
+/*! number of patterns of each block of partial results */
+static const u_int evalBlockSize = 64;
+
+/*! partial results of a block of patterns */
+class evalPartial {
+public:
+	Real mse;
+	Real maxError;
+	u_int correct;
+};
+
+class EvaluatorPrivate;
+
+/*! a thread spreading its own clone of the net over a range of blocks */
+class evalWorker : public QThread {
+public:
+	evalWorker( EvaluatorPrivate* owner, BaseNeuralNet* clone );
+	~evalWorker() {
+		wait();
+		unbind();
+		// --- BaseNeuralNet doesn't own its Clusters and Linkers
+		const LinkerVec& lks = net->linkers();
+		for( u_int i=0; i<lks.size(); i++ ) {
+			delete lks[i];
+		}
+		const ClusterVec& cls = net->clusters();
+		for( u_int i=0; i<cls.size(); i++ ) {
+			delete cls[i];
+		}
+		delete net;
+	};
+	/*! copy the free parameters from the net evaluated */
+	void synchronize( const BaseNeuralNet::ParameterBlockVec& src );
+	/*! bind the input Clusters to the rows of the DataSet, if any */
+	void bind();
+	/*! restore the input Clusters and release the views on the DataSet */
+	void unbind();
+	/*! evaluate the blocks from firstBlock to lastBlock (excluded) */
+	void evaluateBlocks();
+
+	EvaluatorPrivate* owner;
+	BaseNeuralNet* net;
+	/*! input and output Clusters of the clone, in the same order of the net evaluated */
+	ClusterVec ins;
+	ClusterVec outs;
+	/*! parameter blocks of the clone, in the same order of the net evaluated */
+	std::vector<BaseNeuralNet::ParameterBlock> blocks;
+	/*! the Pattern viewing the current row of the DataSet */
+	Pattern cursor;
+	u_int firstBlock;
+	u_int lastBlock;
+	/*! the NUMA node where the parameters of the clone live and the thread runs; -1 if not pinned */
+	int node;
+protected:
+	void run() {
+		Tracer::setThreadName( "Evaluator worker" );
+		if ( node >= 0 ) {
+			MemoryPolicy::bindThreadToNode( node );
+		}
+		evaluateBlocks();
+	};
+};
+
+class EvaluatorPrivate {
+public:
+	EvaluatorPrivate( BaseNeuralNet* n, u_int nt )
+		: net(n), nthreads(nt), pinning(false), workers(), pset(0), dset(0), npat(0), partials() {
+		if ( nthreads == 0 ) {
+			int ideal = QThread::idealThreadCount();
+			nthreads = ( ideal > 0 ) ? ideal : 1;
+		}
+	};
+	~EvaluatorPrivate() {
+		destroyWorkers();
+	};
+	void destroyWorkers() {
+		for( u_int i=0; i<workers.size(); i++ ) {
+			delete workers[i];
+		}
+		workers.clear();
+	};
+	/*! create the clones, if they don't exist yet, and copy the parameters into them */
+	void prepare();
+	/*! evaluate all the patterns of pset or dset */
+	Evaluator::Metrics run();
+
+	BaseNeuralNet* net;
+	u_int nthreads;
+	bool pinning;
+	std::vector<evalWorker*> workers;
+	const PatternSet* pset;
+	const DataSet* dset;
+	u_int npat;
+	std::vector<evalPartial> partials;
+};
+
+evalWorker::evalWorker( EvaluatorPrivate* o, BaseNeuralNet* clone )
+	: QThread(), owner(o), net(clone), ins(), outs(), blocks(), cursor(), firstBlock(0), lastBlock(0), node(-1) {
+	// --- the Clusters are cloned with their current inputs, which would be accumulated at the first step
+	const ClusterVec& cls = net->clusters();
+	for( u_int i=0; i<cls.size(); i++ ) {
+		cls[i]->resetInputs();
+	}
+	const ClusterVec& srcins = owner->net->inputClusters();
+	for( u_int i=0; i<srcins.size(); i++ ) {
+		ins.append( dynamic_cast<Cluster*>( net->getByName( srcins[i]->name() ) ) );
+	}
+	const ClusterVec& srcouts = owner->net->outputClusters();
+	for( u_int i=0; i<srcouts.size(); i++ ) {
+		outs.append( dynamic_cast<Cluster*>( net->getByName( srcouts[i]->name() ) ) );
+	}
+	const BaseNeuralNet::ParameterBlockVec& srcblocks = owner->net->parameterBlocks();
+	const BaseNeuralNet::ParameterBlockVec& myblocks = net->parameterBlocks();
+	for( u_int i=0; i<srcblocks.size(); i++ ) {
+		for( u_int j=0; j<myblocks.size(); j++ ) {
+			if ( strcmp( myblocks[j].updatable->name(), srcblocks[i].updatable->name() ) == 0 ) {
+				blocks.push_back( myblocks[j] );
+				break;
+			}
+		}
+	}
+}
+
+void evalWorker::synchronize( const BaseNeuralNet::ParameterBlockVec& src ) {
+	for( u_int i=0; i<blocks.size(); i++ ) {
+		if ( src[i].vec ) {
+			blocks[i].vec->assign( *(src[i].vec) );
+		} else {
+			blocks[i].mat->assign( *(src[i].mat) );
+			MatrixLinker* ml = dynamic_cast<MatrixLinker*>( blocks[i].updatable );
+			if ( ml ) ml->weightsChanged();
+		}
+	}
+}
+
+void evalWorker::bind() {
+	const DataSet* set = owner->dset;
+	if ( !set || set->size() == 0 ) return;
+	// --- the views are created here, before starting the threads, because they
+	// --- register themselves as observers of the data shared by all workers
+	set->viewPattern( 0, cursor );
+	const ClusterVec& srcins = owner->net->inputClusters();
+	for( u_int i=0; i<ins.size(); i++ ) {
+		const RealVec& row = cursor.inputsOf( srcins[i] );
+		if ( row.size() == ins[i]->numNeurons() && net->linkers( ins[i], false ).size() == 0 ) {
+			// --- moving the cursor to another row moves also the inputs of the Cluster
+			ins[i]->bindInputs( const_cast<RealVec&>( row ) );
+		}
+	}
+}
+
+void evalWorker::unbind() {
+	for( u_int i=0; i<ins.size(); i++ ) {
+		ins[i]->unbindInputs();
+	}
+	cursor.clear();
+}
+
+void evalWorker::evaluateBlocks() {
+	NNFW_PROFILE_SCOPE_IN( "Evaluator::evaluateBlocks", "eval" );
+	const ClusterVec& srcins = owner->net->inputClusters();
+	const ClusterVec& srcouts = owner->net->outputClusters();
+	const PatternSet* pset = owner->pset;
+	const DataSet* dset = owner->dset;
+	u_int npat = owner->npat;
+	u_int nouts = outs.size();
+	for( u_int b=firstBlock; b<lastBlock; b++ ) {
+		evalPartial& part = owner->partials[b];
+		part.mse = 0.0;
+		part.maxError = 0.0;
+		part.correct = 0;
+		u_int end = ( (b+1)*evalBlockSize < npat ) ? (b+1)*evalBlockSize : npat;
+		for( u_int p=b*evalBlockSize; p<end; p++ ) {
+			const Pattern* pat;
+			if ( pset ) {
+				pat = &( (*pset)[p] );
+			} else {
+				dset->viewPattern( p, cursor );
+				pat = &cursor;
+			}
+			// --- set the inputs not bound
+			for( u_int i=0; i<ins.size(); i++ ) {
+				if ( ins[i]->isInputsBound() ) continue;
+				const RealVec& src = pat->inputsOf( srcins[i] );
+				if ( src.size() != ins[i]->numNeurons() ) continue;
+				ins[i]->inputs().assign( src );
+			}
+			net->step();
+			// --- accumulate all metrics in a single pass
+			Real mseacc = 0.0;
+			bool correct = true;
+			for( u_int i=0; i<nouts; i++ ) {
+				const RealVec& target = pat->outputsOf( srcouts[i] );
+				const RealVec& actual = outs[i]->outputs();
+				u_int n = actual.size();
+				if ( target.size() != n || n == 0 ) continue;
+				Real se = 0.0;
+				u_int tmax = 0;
+				u_int amax = 0;
+				for( u_int k=0; k<n; k++ ) {
+					Real diff = target[k] - actual[k];
+					se += diff*diff;
+					diff = fabs( diff );
+					if ( diff > part.maxError ) part.maxError = diff;
+					if ( target[k] > target[tmax] ) tmax = k;
+					if ( actual[k] > actual[amax] ) amax = k;
+				}
+				mseacc += se/n;
+				if ( n == 1 ) {
+					correct = correct && ( ( target[0] >= 0.5 ) == ( actual[0] >= 0.5 ) );
+				} else {
+					correct = correct && ( tmax == amax );
+				}
+			}
+			if ( nouts > 0 ) {
+				part.mse += mseacc/nouts;
+			}
+			if ( correct ) part.correct++;
+		}
+	}
+}
+
+void EvaluatorPrivate::prepare() {
+	const BaseNeuralNet::ParameterBlockVec& src = net->parameterBlocks();
+	if ( !workers.empty() && workers[0]->blocks.size() != src.size() ) {
+		// --- the structure of the net is changed
+		destroyWorkers();
+	}
+	int nodes = MemoryPolicy::numNodes();
+	while( workers.size() < nthreads ) {
+		u_int i = workers.size();
+		BaseNeuralNet* clone = net->clone();
+		int node = -1;
+		if ( pinning && nodes > 1 ) {
+			// --- contiguous workers share a node; the first one is the calling thread, placed where it runs
+			node = ( i == 0 ) ? MemoryPolicy::currentNode() : (int)( ( i*nodes )/nthreads );
+			MemoryPolicy policy = net->memoryPolicy();
+			policy.placement = MemoryPolicy::OnNode;
+			policy.node = node;
+			clone->setMemoryPolicy( policy );
+		}
+		workers.push_back( new evalWorker( this, clone ) );
+		// --- the calling thread is never pinned
+		workers[i]->node = ( i == 0 ) ? -1 : node;
+	}
+	for( u_int i=0; i<workers.size(); i++ ) {
+		workers[i]->synchronize( src );
+	}
+}
+
+Evaluator::Metrics EvaluatorPrivate::run() {
+	Evaluator::Metrics m;
+	m.mse = 0.0;
+	m.maxError = 0.0;
+	m.accuracy = 0.0;
+	m.count = npat;
+	if ( npat == 0 ) return m;
+	prepare();
+	u_int nblocks = ( npat + evalBlockSize - 1 ) / evalBlockSize;
+	if ( partials.size() < nblocks ) {
+		partials.resize( nblocks );
+	}
+	// --- contiguous ranges of blocks, the first one is evaluated by the calling thread
+	u_int nw = ( nthreads < nblocks ) ? nthreads : nblocks;
+	for( u_int i=0; i<nw; i++ ) {
+		workers[i]->firstBlock = ( nblocks*i )/nw;
+		workers[i]->lastBlock = ( nblocks*(i+1) )/nw;
+		workers[i]->bind();
+	}
+	for( u_int i=1; i<nw; i++ ) {
+		workers[i]->start();
+	}
+	workers[0]->evaluateBlocks();
+	for( u_int i=1; i<nw; i++ ) {
+		workers[i]->wait();
+	}
+	for( u_int i=0; i<nw; i++ ) {
+		workers[i]->unbind();
+	}
+	// --- reduce in order of blocks, independently from the number of threads
+	u_int correct = 0;
+	for( u_int b=0; b<nblocks; b++ ) {
+		m.mse += partials[b].mse;
+		if ( partials[b].maxError > m.maxError ) m.maxError = partials[b].maxError;
+		correct += partials[b].correct;
+	}
+	m.mse /= npat;
+	m.accuracy = (Real)correct / npat;
+	return m;
+}
+
+Evaluator::Evaluator( BaseNeuralNet* net, u_int numThreads ) {
+	prv = new EvaluatorPrivate( net, numThreads );
+}
+
+Evaluator::~Evaluator() {
+	delete prv;
+}
+
+u_int Evaluator::numThreads() const {
+	return prv->nthreads;
+}
+
+Evaluator::Metrics Evaluator::evaluate( const PatternSet& set ) {
+	prv->pset = &set;
+	prv->dset = 0;
+	prv->npat = set.size();
+	return prv->run();
+}
+
+Evaluator::Metrics Evaluator::evaluate( const DataSet& set ) {
+	prv->pset = 0;
+	prv->dset = &set;
+	prv->npat = set.size();
+	return prv->run();
+}
+
+void Evaluator::rebuild() {
+	prv->destroyWorkers();
+}
+
+void Evaluator::setNumaPinning( bool enable ) {
+	if ( prv->pinning == enable ) return;
+	prv->pinning = enable;
+	prv->destroyWorkers();
+}
+
+bool Evaluator::numaPinning() const {
+	return prv->pinning;
+}
+
+}
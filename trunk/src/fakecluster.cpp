@@ -30,14 +30,16 @@ FakeCluster::FakeCluster( u_int size, const char* name )
     : Cluster( size, name) {
     // Set the outputs as a View of inputs
     outputs().convertToView( inputs(), 0, numNeurons() );
-    setTypename( "FakeCluster" );
+    static const PropertyKey typeKey( "FakeCluster" );
+    setTypename( typeKey );
 }
 
 FakeCluster::FakeCluster( PropertySettings& prop )
     : Cluster( prop ) {
     // Set the outputs as a View of inputs
     outputs().convertToView( inputs(), 0, numNeurons() );
-    setTypename( "FakeCluster" );
+    static const PropertyKey typeKey( "FakeCluster" );
+    setTypename( typeKey );
 }
     
 
@@ -49,10 +51,23 @@ void FakeCluster::update() {
     return;
 }
 
+void FakeCluster::updateCost( double& flops, double& bytes ) const {
+    flops = 0.0;
+    bytes = 0.0;
+}
+
 void FakeCluster::randomize( Real , Real ) {
     return;
 }
 
+bool FakeCluster::bindOutputs( RealVec& src ) {
+    return bindInputs( src );
+}
+
+void FakeCluster::unbindOutputs() {
+    unbindInputs();
+}
+
 FakeCluster* FakeCluster::clone() const {
 	FakeCluster* newclone = new FakeCluster( numNeurons(), name() );
 	newclone->setAccumulate( this->isAccumulate() );
@@ -0,0 +1,132 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "gatedcluster.h"
+#include "random.h"
+
+
+namespace nnfw {
+
+GatedCluster::GatedCluster( u_int numNeurons, u_int numGates, u_int numStates, const char* name )
+    : Cluster( numNeurons, name ), ngates( numGates ), w( 2*numNeurons, numGates*numNeurons ),
+      b( numGates*numNeurons ), xh( 2*numNeurons ), z( numGates*numNeurons ), st( numStates*numNeurons ) {
+    w.zeroing();
+    b.zeroing();
+    st.zeroing();
+    propdefs();
+    static const PropertyKey typeKey( "GatedCluster" );
+    setTypename( typeKey );
+}
+
+GatedCluster::GatedCluster( PropertySettings& prop, u_int numGates, u_int numStates )
+    : Cluster( prop ), ngates( numGates ), w( 2*numNeurons(), numGates*numNeurons() ),
+      b( numGates*numNeurons() ), xh( 2*numNeurons() ), z( numGates*numNeurons() ), st( numStates*numNeurons() ) {
+    w.zeroing();
+    b.zeroing();
+    st.zeroing();
+    Variant& v = prop["weights"];
+    if ( ! v.isNull() ) {
+        setWeights( v );
+    }
+    Variant& vb = prop["biases"];
+    if ( ! vb.isNull() ) {
+        setBiases( vb );
+    }
+    propdefs();
+    static const PropertyKey typeKey( "GatedCluster" );
+    setTypename( typeKey );
+}
+
+GatedCluster::~GatedCluster() {
+}
+
+void GatedCluster::update() {
+    const u_int n = numNeurons();
+    RealVec& ins = inputs();
+    RealVec& outs = outputs();
+    for( u_int i=0; i<n; i++ ) {
+        xh[i] = ins[i];
+        xh[n+i] = outs[i];
+    }
+    // --- the preactivations of all gates with a single matrix-vector product
+    z.assign( b );
+    RealMat::mul( z, xh, w );
+    pointwise( z, xh, st, outs );
+    setNeedReset( true );
+}
+
+void GatedCluster::setWeights( const RealMat& mat ) {
+    if ( mat.rows() != w.rows() || mat.cols() != w.cols() ) {
+        nError() << "Wrong dimension of the weights of " << name() << "; passed: " << mat.rows() << "x" << mat.cols()
+                 << "; expected: " << w.rows() << "x" << w.cols();
+        return;
+    }
+    w.assign( mat );
+    constrainWeights();
+}
+
+void GatedCluster::setBiases( const RealVec& bias ) {
+    if ( bias.size() != b.size() ) {
+        nError() << "Wrong dimension of the biases of " << name() << "; passed: " << bias.size()
+                 << "; expected: " << b.size();
+        return;
+    }
+    b.assign( bias );
+}
+
+void GatedCluster::updateCost( double& flops, double& bytes ) const {
+    // --- the product of [inputs; outputs] and the gate weights, and the pointwise part
+    const double r = w.rows();
+    const double c = w.cols();
+    flops = 2.0*r*c + 10.0*c;
+    bytes = ( r*c + 3.0*c + 2.0*r + 2.0*st.size() )*sizeof(Real);
+}
+
+void GatedCluster::workingMemory( std::vector<RealVec*>& buffers ) {
+    buffers.push_back( &xh );
+    buffers.push_back( &z );
+    buffers.push_back( &st );
+}
+
+void GatedCluster::randomize( Real min, Real max ) {
+    Random::flatRealMat( w, min, max );
+    Random::flatRealVec( b, min, max );
+    constrainWeights();
+}
+
+void GatedCluster::resetState() {
+    outputs().zeroing();
+    st.zeroing();
+}
+
+void GatedCluster::copyInto( GatedCluster* clone ) const {
+    clone->setAccumulate( isAccumulate() );
+    clone->w.assign( w );
+    clone->b.assign( b );
+    clone->st.assign( st );
+    clone->inputs().assign( inputs() );
+    clone->outputs().assign( outputs() );
+}
+
+void GatedCluster::propdefs() {
+    addProperty( "weights", Variant::t_realmat, this, &GatedCluster::getWeightsP, &GatedCluster::setWeights );
+    addProperty( "biases", Variant::t_realvec, this, &GatedCluster::getBiasesP, &GatedCluster::setBiases );
+}
+
+}
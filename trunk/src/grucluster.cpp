@@ -0,0 +1,97 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "grucluster.h"
+#include <cmath>
+
+
+namespace nnfw {
+
+GRUCluster::GRUCluster( u_int numNeurons, const char* name )
+    : GatedCluster( numNeurons, 4, 4, name ) {
+    static const PropertyKey typeKey( "GRUCluster" );
+    setTypename( typeKey );
+}
+
+GRUCluster::GRUCluster( PropertySettings& prop )
+    : GatedCluster( prop, 4, 4 ) {
+    constrainWeights();
+    static const PropertyKey typeKey( "GRUCluster" );
+    setTypename( typeKey );
+}
+
+GRUCluster::~GRUCluster() {
+}
+
+void GRUCluster::constrainWeights() {
+    const u_int n = numNeurons();
+    RealMat& w = weights();
+    for( u_int j=0; j<n; j++ ) {
+        for( u_int i=0; i<n; i++ ) {
+            // --- from inputs to h
+            w[j][3*n+i] = 0.0;
+            // --- from y(t-1) to x
+            w[n+j][2*n+i] = 0.0;
+        }
+    }
+}
+
+void GRUCluster::pointwise( const RealVec& z, const RealVec& xh, RealVec& state, RealVec& outputs ) {
+    const u_int n = numNeurons();
+    for( u_int j=0; j<n; j++ ) {
+        Real u = 1.0/( 1.0 + exp( -z[j] ) );
+        Real r = 1.0/( 1.0 + exp( -z[n+j] ) );
+        Real zh = z[3*n+j];
+        Real c = tanh( z[2*n+j] + r*zh );
+        state[j] = u;
+        state[n+j] = r;
+        state[2*n+j] = c;
+        state[3*n+j] = zh;
+        outputs[j] = ( 1.0 - u )*c + u*xh[n+j];
+    }
+}
+
+void GRUCluster::backward( const RealVec& xh, const RealVec& /*statePrev*/, const RealVec& state,
+                           const RealVec& dOut, RealVec& /*dState*/, RealVec& dxh, RealVec& dz ) const {
+    const u_int n = numNeurons();
+    for( u_int j=0; j<n; j++ ) {
+        Real u = state[j];
+        Real r = state[n+j];
+        Real c = state[2*n+j];
+        Real dc = dOut[j]*( 1.0 - u )*( 1.0 - c*c );
+        dz[j] = dOut[j]*( xh[n+j] - c )*u*( 1.0 - u );
+        dz[n+j] = dc*state[3*n+j]*r*( 1.0 - r );
+        dz[2*n+j] = dc;
+        dz[3*n+j] = dc*r;
+    }
+    dxh.zeroing();
+    RealMat::mul( dxh, weights(), dz );
+    // --- direct contribution of y(t-1) to y(t)
+    for( u_int j=0; j<n; j++ ) {
+        dxh[n+j] += dOut[j]*state[j];
+    }
+}
+
+GRUCluster* GRUCluster::clone() const {
+    GRUCluster* newclone = new GRUCluster( numNeurons(), name() );
+    copyInto( newclone );
+    return newclone;
+}
+
+}
@@ -92,7 +92,7 @@ std::ostream& operator<<(std::ostream& stream, const Propertized& p) {
         if ( ps[i]->isVector() ) {
             stream << "Printing of Vector Property not yet implemented" << std::endl;
         } else {
-            Variant v = ps[i]->get();
+            Variant v = ps[i]->get( &p );
             if ( v.type() == Variant::t_propertized ||
                 v.type() == Variant::t_outfunction ||
                 v.type() == Variant::t_cluster ||
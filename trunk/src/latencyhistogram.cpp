@@ -0,0 +1,105 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "latencyhistogram.h"
+#include <cmath>
+
+namespace nnfw {
+
+/*! number of sub-buckets of each power of two */
+static const u_int histSubBuckets = 128;
+/*! number of powers of two covered, from 1 nanosecond */
+static const u_int histPowers = 44;
+
+LatencyHistogram::LatencyHistogram()
+	: buckets( histSubBuckets*histPowers, 0 ), total(0), minv(0.0), maxv(0.0), sum(0.0) {
+}
+
+u_int LatencyHistogram::bucketOf( double ns ) {
+	if ( ns < 1.0 ) return 0;
+	int e;
+	// --- ns = m * 2^e with 0.5 <= m < 1
+	double m = std::frexp( ns, &e );
+	u_int power = e-1;
+	if ( power >= histPowers ) {
+		return histSubBuckets*histPowers - 1;
+	}
+	u_int sub = (u_int)( ( 2.0*m - 1.0 ) * histSubBuckets );
+	if ( sub >= histSubBuckets ) sub = histSubBuckets-1;
+	return power*histSubBuckets + sub;
+}
+
+double LatencyHistogram::upperBound( u_int i ) {
+	u_int power = i / histSubBuckets;
+	u_int sub = i % histSubBuckets;
+	return std::ldexp( 1.0 + (double)(sub+1)/histSubBuckets, power );
+}
+
+void LatencyHistogram::record( double seconds ) {
+	if ( seconds < 0.0 ) seconds = 0.0;
+	buckets[ bucketOf( seconds*1e9 ) ]++;
+	if ( total == 0 || seconds < minv ) minv = seconds;
+	if ( total == 0 || seconds > maxv ) maxv = seconds;
+	sum += seconds;
+	total++;
+}
+
+void LatencyHistogram::reset() {
+	for( u_int i=0; i<buckets.size(); i++ ) {
+		buckets[i] = 0;
+	}
+	total = 0;
+	minv = 0.0;
+	maxv = 0.0;
+	sum = 0.0;
+}
+
+double LatencyHistogram::min() const {
+	return minv;
+}
+
+double LatencyHistogram::max() const {
+	return maxv;
+}
+
+double LatencyHistogram::mean() const {
+	return ( total > 0 ) ? sum/total : 0.0;
+}
+
+double LatencyHistogram::percentile( double p ) const {
+	if ( total == 0 ) return 0.0;
+	if ( p <= 0.0 ) return minv;
+	if ( p >= 100.0 ) return maxv;
+	unsigned long rank = (unsigned long)std::ceil( p/100.0*total );
+	if ( rank == 0 ) rank = 1;
+	unsigned long acc = 0;
+	for( u_int i=0; i<buckets.size(); i++ ) {
+		acc += buckets[i];
+		if ( acc >= rank ) {
+			double v = upperBound( i )*1e-9;
+			// --- the bounds of the bucket may exceed the values really counted
+			if ( v > maxv ) v = maxv;
+			if ( v < minv ) v = minv;
+			return v;
+		}
+	}
+	return maxv;
+}
+
+}
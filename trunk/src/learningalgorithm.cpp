@@ -19,6 +19,9 @@
 
 #include "neuralnet.h"
 #include "learningalgorithm.h"
+#include "patternstream.h"
+#include "evaluator.h"
+#include <algorithm>
 
 namespace nnfw {
 
@@ -55,11 +58,171 @@ Pattern::PatternInfo& Pattern::operator[]( Cluster* cl ) {
 	return pinfo[cl];
 };
 
+DataSet::DataSet( u_int size )
+	: dim(size), ins(), outs(), inscl(), outscl(), cursor() {
+}
+
+DataSet::DataSet( const PatternSet& set, BaseNeuralNet* net )
+	: dim(set.size()), ins(), outs(), inscl(), outscl(), cursor() {
+	const ClusterVec& clins = net->inputClusters();
+	for( u_int i=0; i<clins.size(); i++ ) {
+		addInputsOf( clins[i] );
+	}
+	const ClusterVec& clout = net->outputClusters();
+	for( u_int i=0; i<clout.size(); i++ ) {
+		addOutputsOf( clout[i] );
+	}
+	for( u_int i=0; i<dim; i++ ) {
+		setPattern( i, set[i] );
+	}
+}
+
+DataSet::~DataSet() {
+	// --- the cursor views have to be destroyed before the data
+	cursor.clear();
+	std::map<Cluster*, block>::iterator it;
+	for( it = ins.begin(); it != ins.end(); it++ ) {
+		delete (it->second.mat);
+		delete (it->second.data);
+	}
+	for( it = outs.begin(); it != outs.end(); it++ ) {
+		delete (it->second.mat);
+		delete (it->second.data);
+	}
+}
+
+DataSet::block DataSet::createBlock( Cluster* cl ) {
+	block b;
+	u_int n = cl->numNeurons();
+	b.data = new RealVec( dim*n );
+	b.data->zeroing();
+	b.mat = 0;
+	return b;
+}
+
+RealMat& DataSet::matrixOf( block& b, Cluster* cl ) {
+	if ( !b.mat ) {
+		u_int n = cl->numNeurons();
+		b.mat = new RealMat( *(b.data), 0, dim*n, dim, n );
+	}
+	return *(b.mat);
+}
+
+void DataSet::addInputsOf( Cluster* cl ) {
+	if ( ins.count( cl ) ) return;
+	ins[cl] = createBlock( cl );
+	inscl.append( cl );
+}
+
+void DataSet::addOutputsOf( Cluster* cl ) {
+	if ( outs.count( cl ) ) return;
+	outs[cl] = createBlock( cl );
+	outscl.append( cl );
+}
+
+void DataSet::setPattern( u_int i, const Pattern& pat ) {
+	std::map<Cluster*, block>::iterator it;
+	for( it = ins.begin(); it != ins.end(); it++ ) {
+		const RealVec& src = pat.inputsOf( it->first );
+		if ( src.size() == 0 ) continue;
+		RealVec& data = *( it->second.data );
+		const u_int n = it->first->numNeurons();
+		const u_int len = std::min( n, src.size() );
+		for( u_int k=0; k<len; k++ ) {
+			data[i*n+k] = src[k];
+		}
+	}
+	for( it = outs.begin(); it != outs.end(); it++ ) {
+		const RealVec& src = pat.outputsOf( it->first );
+		if ( src.size() == 0 ) continue;
+		RealVec& data = *( it->second.data );
+		const u_int n = it->first->numNeurons();
+		const u_int len = std::min( n, src.size() );
+		for( u_int k=0; k<len; k++ ) {
+			data[i*n+k] = src[k];
+		}
+	}
+}
+
+void DataSet::viewPattern( u_int i, Pattern& pat ) const {
+	std::map<Cluster*, block>::const_iterator it;
+	for( it = ins.begin(); it != ins.end(); it++ ) {
+		u_int n = it->first->numNeurons();
+		pat[it->first].inputs.convertToView( *(it->second.data), i*n, (i+1)*n );
+	}
+	for( it = outs.begin(); it != outs.end(); it++ ) {
+		u_int n = it->first->numNeurons();
+		pat[it->first].outputs.convertToView( *(it->second.data), i*n, (i+1)*n );
+	}
+}
+
 LearningAlgorithm::LearningAlgorithm( BaseNeuralNet* net ) {
 	this->netp = net;
+	evalp = 0;
 }
 
 LearningAlgorithm::~LearningAlgorithm() {
+	delete evalp;
+}
+
+Real LearningAlgorithm::calculateMSEOnSet( const PatternSet& set ) {
+	if ( evalp ) {
+		return evalp->evaluate( set ).mse;
+	}
+	Real mseacc = 0.0;
+	int dim = (int)set.size();
+	for( int i=0; i<dim; i++ ) {
+		mseacc += calculateMSE( set[i] );
+	}
+	return mseacc/dim;
+}
+
+Real LearningAlgorithm::calculateMSEOnSet( const DataSet& set ) {
+	if ( evalp ) {
+		return evalp->evaluate( set ).mse;
+	}
+	Real mseacc = 0.0;
+	int dim = (int)set.size();
+	for( int i=0; i<dim; i++ ) {
+		mseacc += calculateMSE( set[i] );
+	}
+	return mseacc/dim;
+}
+
+void LearningAlgorithm::enableParallelEvaluation( u_int numThreads ) {
+	delete evalp;
+	evalp = new Evaluator( netp, numThreads );
+}
+
+void LearningAlgorithm::disableParallelEvaluation() {
+	delete evalp;
+	evalp = 0;
+}
+
+void LearningAlgorithm::learnOnSet( PatternStream& stream ) {
+	stream.rewind();
+	u_int count;
+	const DataSet* batch;
+	while( ( batch = stream.nextBatch( count ) ) != 0 ) {
+		for( u_int i=0; i<count; i++ ) {
+			learn( (*batch)[i] );
+		}
+	}
+}
+
+Real LearningAlgorithm::calculateMSEOnSet( PatternStream& stream ) {
+	stream.rewind();
+	Real mseacc = 0.0;
+	u_int dim = 0;
+	u_int count;
+	const DataSet* batch;
+	while( ( batch = stream.nextBatch( count ) ) != 0 ) {
+		for( u_int i=0; i<count; i++ ) {
+			mseacc += calculateMSE( (*batch)[i] );
+		}
+		dim += count;
+	}
+	return ( dim > 0 ) ? mseacc/dim : 0.0;
 }
 
 }
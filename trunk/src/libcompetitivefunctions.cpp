@@ -27,7 +27,8 @@ WinnerTakeAllFunction::WinnerTakeAllFunction( Real value )
 	valuev = value;
 	
 	addProperty( "value", Variant::t_real, this, &WinnerTakeAllFunction::value, &WinnerTakeAllFunction::setValue );
-	setTypename( "WinnerTakeAllFunction" );
+	static const PropertyKey typeKey( "WinnerTakeAllFunction" );
+	setTypename( typeKey );
 }
 
 WinnerTakeAllFunction::WinnerTakeAllFunction( PropertySettings& prop )
@@ -35,7 +36,8 @@ WinnerTakeAllFunction::WinnerTakeAllFunction( PropertySettings& prop )
 	valuev = 1.0;
 	addProperty( "value", Variant::t_real, this, &WinnerTakeAllFunction::value, &WinnerTakeAllFunction::setValue );
 	setProperties( prop );
-	setTypename( "WinnerTakeAllFunction" );
+	static const PropertyKey typeKey( "WinnerTakeAllFunction" );
+	setTypename( typeKey );
 }
 
 bool WinnerTakeAllFunction::setValue( const Variant& v ) {
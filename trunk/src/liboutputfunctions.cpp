@@ -32,13 +32,15 @@ namespace nnfw {
 
 IdentityFunction::IdentityFunction()
     : DerivableOutputFunction() {
-    setTypename( "IdentityFunction" );
+    static const PropertyKey typeKey( "IdentityFunction" );
+    setTypename( typeKey );
 }
 
 IdentityFunction::IdentityFunction( PropertySettings& )
     : DerivableOutputFunction() {
     // --- non ha proprieta'
-    setTypename( "IdentityFunction" );
+    static const PropertyKey typeKey( "IdentityFunction" );
+    setTypename( typeKey );
 }
 
 void IdentityFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -57,7 +59,8 @@ ScaleFunction::ScaleFunction( Real rate )
     : OutputFunction() {
 	this->rate = rate;
     addProperty( "rate", Variant::t_real, this, &ScaleFunction::getRate, &ScaleFunction::setRate );
-    setTypename( "ScaleFunction" );
+    static const PropertyKey typeKey( "ScaleFunction" );
+    setTypename( typeKey );
 }
 
 ScaleFunction::ScaleFunction( PropertySettings& prop )
@@ -65,7 +68,8 @@ ScaleFunction::ScaleFunction( PropertySettings& prop )
 	rate = 1.0;
     addProperty( "rate", Variant::t_real, this, &ScaleFunction::getRate, &ScaleFunction::setRate );
     setProperties( prop );
-    setTypename( "ScaleFunction" );
+    static const PropertyKey typeKey( "ScaleFunction" );
+    setTypename( typeKey );
 }
 
 bool ScaleFunction::setRate( const Variant& v ) {
@@ -89,7 +93,8 @@ GainFunction::GainFunction( Real gain )
     : OutputFunction() {
 	gainv = gain;
     addProperty( "gain", Variant::t_real, this, &GainFunction::gain, &GainFunction::setGain );
-    setTypename( "GainFunction" );
+    static const PropertyKey typeKey( "GainFunction" );
+    setTypename( typeKey );
 }
 
 GainFunction::GainFunction( PropertySettings& prop )
@@ -97,7 +102,8 @@ GainFunction::GainFunction( PropertySettings& prop )
 	gainv = 1.0;
     addProperty( "gain", Variant::t_real, this, &GainFunction::gain, &GainFunction::setGain );
     setProperties( prop );
-    setTypename( "GainFunction" );
+    static const PropertyKey typeKey( "GainFunction" );
+    setTypename( typeKey );
 }
 
 bool GainFunction::setGain( const Variant& v ) {
@@ -121,7 +127,8 @@ GainFunction* GainFunction::clone() const {
 SigmoidFunction::SigmoidFunction( Real l ) : DerivableOutputFunction() {
     lambda = l;
     addProperty( "lambda", Variant::t_real, this, &SigmoidFunction::getLambda, &SigmoidFunction::setLambda );
-    setTypename( "SigmoidFunction" );
+    static const PropertyKey typeKey( "SigmoidFunction" );
+    setTypename( typeKey );
 }
 
 SigmoidFunction::SigmoidFunction( PropertySettings& prop )
@@ -129,7 +136,8 @@ SigmoidFunction::SigmoidFunction( PropertySettings& prop )
     lambda = 1.0;
     addProperty( "lambda", Variant::t_real, this, &SigmoidFunction::getLambda, &SigmoidFunction::setLambda );
     setProperties( prop );
-    setTypename( "SigmoidFunction" );
+    static const PropertyKey typeKey( "SigmoidFunction" );
+    setTypename( typeKey );
 }
 
 void SigmoidFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -169,7 +177,8 @@ FakeSigmoidFunction::FakeSigmoidFunction( Real l )
     : DerivableOutputFunction() {
     lambda = l;
     addProperty( "lambda", Variant::t_real, this, &FakeSigmoidFunction::getLambda, &FakeSigmoidFunction::setLambda );
-    setTypename( "FakeSigmoidFunction" );
+    static const PropertyKey typeKey( "FakeSigmoidFunction" );
+    setTypename( typeKey );
 }
 
 FakeSigmoidFunction::FakeSigmoidFunction( PropertySettings& prop )
@@ -177,7 +186,8 @@ FakeSigmoidFunction::FakeSigmoidFunction( PropertySettings& prop )
     lambda = 1.0;
     addProperty( "lambda", Variant::t_real, this, &FakeSigmoidFunction::getLambda, &FakeSigmoidFunction::setLambda );
     setProperties( prop );
-    setTypename( "FakeSigmoidFunction" );
+    static const PropertyKey typeKey( "FakeSigmoidFunction" );
+    setTypename( typeKey );
 }
 
 void FakeSigmoidFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -235,7 +245,8 @@ ScaledSigmoidFunction::ScaledSigmoidFunction( Real l, Real min, Real max )
     addProperty( "lambda", Variant::t_real, this, &ScaledSigmoidFunction::getLambda, &ScaledSigmoidFunction::setLambda );
     addProperty( "min", Variant::t_real, this, &ScaledSigmoidFunction::getMin, &ScaledSigmoidFunction::setMin );
     addProperty( "max", Variant::t_real, this, &ScaledSigmoidFunction::getMax, &ScaledSigmoidFunction::setMax );
-    setTypename( "ScaledSigmoidFunction" );
+    static const PropertyKey typeKey( "ScaledSigmoidFunction" );
+    setTypename( typeKey );
 }
 
 ScaledSigmoidFunction::ScaledSigmoidFunction( PropertySettings& prop )
@@ -247,7 +258,8 @@ ScaledSigmoidFunction::ScaledSigmoidFunction( PropertySettings& prop )
     addProperty( "min", Variant::t_real, this, &ScaledSigmoidFunction::getMin, &ScaledSigmoidFunction::setMin );
     addProperty( "max", Variant::t_real, this, &ScaledSigmoidFunction::getMax, &ScaledSigmoidFunction::setMax );
     setProperties( prop );
-    setTypename( "FakeSigmoidFunction" );
+    static const PropertyKey typeKey( "FakeSigmoidFunction" );
+    setTypename( typeKey );
 }
 
 void ScaledSigmoidFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -313,7 +325,8 @@ RampFunction::RampFunction( Real minX, Real maxX, Real minY, Real maxY )
 	addProperty( "maxX", Variant::t_real, this, &RampFunction::maxX, &RampFunction::setMaxX );
 	addProperty( "minY", Variant::t_real, this, &RampFunction::minY, &RampFunction::setMinY );
 	addProperty( "maxY", Variant::t_real, this, &RampFunction::maxY, &RampFunction::setMaxY );
-	setTypename( "RampFunction" );
+	static const PropertyKey typeKey( "RampFunction" );
+	setTypename( typeKey );
 }
 
 RampFunction::RampFunction( PropertySettings& prop )
@@ -327,7 +340,8 @@ RampFunction::RampFunction( PropertySettings& prop )
 	addProperty( "minY", Variant::t_real, this, &RampFunction::minY, &RampFunction::setMinY );
 	addProperty( "maxY", Variant::t_real, this, &RampFunction::maxY, &RampFunction::setMaxY );
 	setProperties( prop );
-	setTypename( "RampFunction" );
+	static const PropertyKey typeKey( "RampFunction" );
+	setTypename( typeKey );
 }
 
 void RampFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -410,7 +424,8 @@ LinearFunction::LinearFunction( Real m, Real b )
 	bv = b;
     addProperty( "m", Variant::t_real, this, &LinearFunction::m, &LinearFunction::setM );
     addProperty( "b", Variant::t_real, this, &LinearFunction::b, &LinearFunction::setB );
-    setTypename( "LinearFunction" );
+    static const PropertyKey typeKey( "LinearFunction" );
+    setTypename( typeKey );
 }
 
 LinearFunction::LinearFunction( PropertySettings& prop )
@@ -420,7 +435,8 @@ LinearFunction::LinearFunction( PropertySettings& prop )
     addProperty( "m", Variant::t_real, this, &LinearFunction::m, &LinearFunction::setM );
     addProperty( "b", Variant::t_real, this, &LinearFunction::b, &LinearFunction::setB );
     setProperties( prop );
-    setTypename( "LinearFunction" );
+    static const PropertyKey typeKey( "LinearFunction" );
+    setTypename( typeKey );
 }
 
 void LinearFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -468,7 +484,8 @@ StepFunction::StepFunction( Real min, Real max, Real threshold )
     addProperty( "min", Variant::t_real, this, &StepFunction::getMin, &StepFunction::setMin );
     addProperty( "max", Variant::t_real, this, &StepFunction::getMax, &StepFunction::setMax );
     addProperty( "threshold", Variant::t_real, this, &StepFunction::getThreshold, &StepFunction::setThreshold );
-    setTypename( "StepFunction" );
+    static const PropertyKey typeKey( "StepFunction" );
+    setTypename( typeKey );
 }
 
 StepFunction::StepFunction( PropertySettings& prop )
@@ -480,7 +497,8 @@ StepFunction::StepFunction( PropertySettings& prop )
     addProperty( "max", Variant::t_real, this, &StepFunction::getMax, &StepFunction::setMax );
     addProperty( "threshold", Variant::t_real, this, &StepFunction::getThreshold, &StepFunction::setThreshold );
     setProperties( prop );
-    setTypename( "StepFunction" );
+    static const PropertyKey typeKey( "StepFunction" );
+    setTypename( typeKey );
 }
 
 void StepFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -542,7 +560,8 @@ LeakyIntegratorFunction::LeakyIntegratorFunction( const RealVec& d )
 	outprev.resize( delta.size() );
 	outprev.zeroing();
     addProperty( "delta", Variant::t_realvec, this, &LeakyIntegratorFunction::getDeltaV, &LeakyIntegratorFunction::setDeltaV );
-    setTypename( "LeakyIntegratorFunction" );
+    static const PropertyKey typeKey( "LeakyIntegratorFunction" );
+    setTypename( typeKey );
 }
 
 LeakyIntegratorFunction::LeakyIntegratorFunction( PropertySettings& prop )
@@ -551,7 +570,8 @@ LeakyIntegratorFunction::LeakyIntegratorFunction( PropertySettings& prop )
 	outprev[0] = 0.0f;
     addProperty( "delta", Variant::t_realvec, this, &LeakyIntegratorFunction::getDeltaV, &LeakyIntegratorFunction::setDeltaV );
     setProperties( prop );
-    setTypename( "LeakyIntegratorFunction" );
+    static const PropertyKey typeKey( "LeakyIntegratorFunction" );
+    setTypename( typeKey );
 }
 
 void LeakyIntegratorFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -602,7 +622,8 @@ LogLikeFunction::LogLikeFunction( Real A, Real B )
 	b = B;
 	addProperty( "A", Variant::t_real, this, &LogLikeFunction::getAV, &LogLikeFunction::setBV );
 	addProperty( "B", Variant::t_real, this, &LogLikeFunction::getAV, &LogLikeFunction::setBV );
-	setTypename( "LogLikeFunction" );
+	static const PropertyKey typeKey( "LogLikeFunction" );
+	setTypename( typeKey );
 }
 
 LogLikeFunction::LogLikeFunction( PropertySettings& prop )
@@ -612,7 +633,8 @@ LogLikeFunction::LogLikeFunction( PropertySettings& prop )
 	addProperty( "A", Variant::t_real, this, &LogLikeFunction::getAV, &LogLikeFunction::setBV );
 	addProperty( "B", Variant::t_real, this, &LogLikeFunction::getAV, &LogLikeFunction::setBV );
 	setProperties( prop );
-	setTypename( "LogLikeFunction" );
+	static const PropertyKey typeKey( "LogLikeFunction" );
+	setTypename( typeKey );
 }
 
 void LogLikeFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -666,7 +688,8 @@ PoolFunction::PoolFunction( const OutputFunction& prototype, u_int dim )
     }
     addProperty( "size", Variant::t_uint, this, &PoolFunction::sizeV );
     addVectorProperty( "functions", Variant::t_outfunction, this, &PoolFunction::getOutputFunctionV, &PoolFunction::setOutputFunction );
-    setTypename( "PoolFunction" );
+    static const PropertyKey typeKey( "PoolFunction" );
+    setTypename( typeKey );
 }
 
 PoolFunction::PoolFunction( u_int dim )
@@ -680,7 +703,8 @@ PoolFunction::PoolFunction( u_int dim )
     }
     addProperty( "size", Variant::t_uint, this, &PoolFunction::sizeV );
     addVectorProperty( "functions", Variant::t_outfunction, this, &PoolFunction::getOutputFunctionV, &PoolFunction::setOutputFunction );
-    setTypename( "PoolFunction" );
+    static const PropertyKey typeKey( "PoolFunction" );
+    setTypename( typeKey );
 }
 
 PoolFunction::PoolFunction( PropertySettings& prop )
@@ -696,7 +720,8 @@ PoolFunction::PoolFunction( PropertySettings& prop )
     addProperty( "size", Variant::t_uint, this, &PoolFunction::sizeV );
     addVectorProperty( "functions", Variant::t_outfunction, this, &PoolFunction::getOutputFunctionV, &PoolFunction::setOutputFunction );
     setProperties( prop );
-    setTypename( "StepFunction" );
+    static const PropertyKey typeKey( "StepFunction" );
+    setTypename( typeKey );
 }
 
 PoolFunction::~PoolFunction() {
@@ -782,7 +807,8 @@ CompositeFunction::CompositeFunction( const OutputFunction& f, const OutputFunct
 
     addProperty( "first", Variant::t_outfunction, this, &CompositeFunction::getFirstFunction, &CompositeFunction::setFirstFunction );
     addProperty( "second", Variant::t_outfunction, this, &CompositeFunction::getSecondFunction, &CompositeFunction::setSecondFunction );
-    setTypename( "CompositeFunction" );
+    static const PropertyKey typeKey( "CompositeFunction" );
+    setTypename( typeKey );
 }
 
 CompositeFunction::CompositeFunction( PropertySettings& prop )
@@ -792,7 +818,8 @@ CompositeFunction::CompositeFunction( PropertySettings& prop )
     addProperty( "first", Variant::t_outfunction, this, &CompositeFunction::getFirstFunction, &CompositeFunction::setFirstFunction );
     addProperty( "second", Variant::t_outfunction, this, &CompositeFunction::getSecondFunction, &CompositeFunction::setSecondFunction );
     setProperties( prop );
-    setTypename( "CompositeFunction" );
+    static const PropertyKey typeKey( "CompositeFunction" );
+    setTypename( typeKey );
 }
 
 CompositeFunction::~CompositeFunction() {
@@ -855,7 +882,8 @@ LinearComboFunction::LinearComboFunction( Real w1, const OutputFunction& f, Real
     addProperty( "second", Variant::t_outfunction, this, &LinearComboFunction::getSecondFunction, &LinearComboFunction::setSecondFunction );
     addProperty( "w1", Variant::t_real, this, &LinearComboFunction::getFirstWeight, &LinearComboFunction::setFirstWeight );
     addProperty( "w2", Variant::t_real, this, &LinearComboFunction::getSecondWeight, &LinearComboFunction::setSecondWeight );
-    setTypename( "LinearComboFunction" );
+    static const PropertyKey typeKey( "LinearComboFunction" );
+    setTypename( typeKey );
 }
 
 LinearComboFunction::LinearComboFunction( PropertySettings& prop )
@@ -868,7 +896,8 @@ LinearComboFunction::LinearComboFunction( PropertySettings& prop )
     addProperty( "w1", Variant::t_real, this, &LinearComboFunction::getFirstWeight, &LinearComboFunction::setFirstWeight );
     addProperty( "w2", Variant::t_real, this, &LinearComboFunction::getSecondWeight, &LinearComboFunction::setSecondWeight );
     setProperties( prop );
-    setTypename( "LinearComboFunction" );
+    static const PropertyKey typeKey( "LinearComboFunction" );
+    setTypename( typeKey );
 }
 
 LinearComboFunction::~LinearComboFunction() {
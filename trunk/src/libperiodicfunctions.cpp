@@ -75,12 +75,14 @@ Variant PeriodicFunction::amplitude() {
 
 SawtoothFunction::SawtoothFunction( Real phase, Real span, Real amplitude )
     : PeriodicFunction(phase,span,amplitude) {
-	setTypename( "SawtoothFunction" );
+	static const PropertyKey typeKey( "SawtoothFunction" );
+	setTypename( typeKey );
 }
 
 SawtoothFunction::SawtoothFunction( PropertySettings& prop )
     : PeriodicFunction(prop) {
-	setTypename( "SawtoothFunction" );
+	static const PropertyKey typeKey( "SawtoothFunction" );
+	setTypename( typeKey );
 }
 
 void SawtoothFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -96,12 +98,14 @@ SawtoothFunction* SawtoothFunction::clone() const {
 
 TriangleFunction::TriangleFunction( Real phase, Real span, Real amplitude )
     : PeriodicFunction(phase,span,amplitude) {
-	setTypename( "TriangleFunction" );
+	static const PropertyKey typeKey( "TriangleFunction" );
+	setTypename( typeKey );
 }
 
 TriangleFunction::TriangleFunction( PropertySettings& prop )
     : PeriodicFunction(prop) {
-	setTypename( "TriangleFunction" );
+	static const PropertyKey typeKey( "TriangleFunction" );
+	setTypename( typeKey );
 }
 
 void TriangleFunction::apply( RealVec& inputs, RealVec& outputs ) {
@@ -120,12 +124,14 @@ TriangleFunction* TriangleFunction::clone() const {
 
 SinFunction::SinFunction( Real phase, Real span, Real amplitude )
     : PeriodicFunction(phase,span,amplitude) {
-	setTypename( "SinFunction" );
+	static const PropertyKey typeKey( "SinFunction" );
+	setTypename( typeKey );
 }
 
 SinFunction::SinFunction( PropertySettings& prop )
     : PeriodicFunction(prop) {
-	setTypename( "SinFunction" );
+	static const PropertyKey typeKey( "SinFunction" );
+	setTypename( typeKey );
 }
 
 Real SinFunction::frequency() {
@@ -144,12 +150,14 @@ SinFunction* SinFunction::clone() const {
 
 PseudoGaussFunction::PseudoGaussFunction( Real phase, Real span, Real amplitude )
     : PeriodicFunction(phase,span,amplitude) {
-	setTypename( "PseudoGaussFunction" );
+	static const PropertyKey typeKey( "PseudoGaussFunction" );
+	setTypename( typeKey );
 }
 
 PseudoGaussFunction::PseudoGaussFunction( PropertySettings& prop )
     : PeriodicFunction(prop) {
-	setTypename( "PseudoGaussFunction" );
+	static const PropertyKey typeKey( "PseudoGaussFunction" );
+	setTypename( typeKey );
 }
 
 void PseudoGaussFunction::apply( RealVec& inputs, RealVec& outputs ) {
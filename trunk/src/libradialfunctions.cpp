@@ -30,7 +30,8 @@ GaussFunction::GaussFunction( Real centre, Real variance, Real maxvalue )
     addProperty( "centre", Variant::t_real, this, &GaussFunction::getCentre, &GaussFunction::setCentre );
     addProperty( "variance", Variant::t_real, this, &GaussFunction::getVariance, &GaussFunction::setVariance );
     addProperty( "max", Variant::t_real, this, &GaussFunction::getMax, &GaussFunction::setMax );
-    setTypename( "GaussFunction" );
+    static const PropertyKey typeKey( "GaussFunction" );
+    setTypename( typeKey );
 }
 
 GaussFunction::GaussFunction( PropertySettings& prop )
@@ -42,7 +43,8 @@ GaussFunction::GaussFunction( PropertySettings& prop )
     addProperty( "variance", Variant::t_real, this, &GaussFunction::getVariance, &GaussFunction::setVariance );
     addProperty( "max", Variant::t_real, this, &GaussFunction::getMax, &GaussFunction::setMax );
     setProperties( prop );
-    setTypename( "GaussFunction" );
+    static const PropertyKey typeKey( "GaussFunction" );
+    setTypename( typeKey );
     msqrvar = -( variance*variance );
 }
 
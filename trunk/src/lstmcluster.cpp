@@ -0,0 +1,84 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "lstmcluster.h"
+#include <cmath>
+
+
+namespace nnfw {
+
+LSTMCluster::LSTMCluster( u_int numNeurons, const char* name )
+    : GatedCluster( numNeurons, 4, 5, name ) {
+    static const PropertyKey typeKey( "LSTMCluster" );
+    setTypename( typeKey );
+}
+
+LSTMCluster::LSTMCluster( PropertySettings& prop )
+    : GatedCluster( prop, 4, 5 ) {
+    static const PropertyKey typeKey( "LSTMCluster" );
+    setTypename( typeKey );
+}
+
+LSTMCluster::~LSTMCluster() {
+}
+
+void LSTMCluster::pointwise( const RealVec& z, const RealVec& /*xh*/, RealVec& state, RealVec& outputs ) {
+    const u_int n = numNeurons();
+    for( u_int j=0; j<n; j++ ) {
+        Real i = 1.0/( 1.0 + exp( -z[j] ) );
+        Real f = 1.0/( 1.0 + exp( -z[n+j] ) );
+        Real g = tanh( z[2*n+j] );
+        Real o = 1.0/( 1.0 + exp( -z[3*n+j] ) );
+        Real c = f*state[j] + i*g;
+        state[j] = c;
+        state[n+j] = i;
+        state[2*n+j] = f;
+        state[3*n+j] = g;
+        state[4*n+j] = o;
+        outputs[j] = o*tanh( c );
+    }
+}
+
+void LSTMCluster::backward( const RealVec& /*xh*/, const RealVec& statePrev, const RealVec& state,
+                            const RealVec& dOut, RealVec& dState, RealVec& dxh, RealVec& dz ) const {
+    const u_int n = numNeurons();
+    for( u_int j=0; j<n; j++ ) {
+        Real i = state[n+j];
+        Real f = state[2*n+j];
+        Real g = state[3*n+j];
+        Real o = state[4*n+j];
+        Real tc = tanh( state[j] );
+        Real dc = dState[j] + dOut[j]*o*( 1.0 - tc*tc );
+        dz[j] = dc*g*i*( 1.0 - i );
+        dz[n+j] = dc*statePrev[j]*f*( 1.0 - f );
+        dz[2*n+j] = dc*i*( 1.0 - g*g );
+        dz[3*n+j] = dOut[j]*tc*o*( 1.0 - o );
+        dState[j] = dc*f;
+    }
+    dxh.zeroing();
+    RealMat::mul( dxh, weights(), dz );
+}
+
+LSTMCluster* LSTMCluster::clone() const {
+    LSTMCluster* newclone = new LSTMCluster( numNeurons(), name() );
+    copyInto( newclone );
+    return newclone;
+}
+
+}
@@ -30,7 +30,8 @@ namespace nnfw {
 MatrixLinker::MatrixLinker( Cluster* from, Cluster* to, const char* name )
     : Linker(from, to, name), nrows(from->numNeurons()), ncols(to->numNeurons()), w(nrows, ncols) {
     addProperty( "weights", Variant::t_realmat, this, &MatrixLinker::matrixP, &MatrixLinker::setMatrix );
-    setTypename( "MatrixLinker" );
+    static const PropertyKey typeKey( "MatrixLinker" );
+    setTypename( typeKey );
 }
 
 MatrixLinker::MatrixLinker( PropertySettings& prop )
@@ -40,7 +41,8 @@ MatrixLinker::MatrixLinker( PropertySettings& prop )
         setMatrix( v );
     }
     addProperty( "weights", Variant::t_realmat, this, &MatrixLinker::matrixP, &MatrixLinker::setMatrix );
-    setTypename( "MatrixLinker" );
+    static const PropertyKey typeKey( "MatrixLinker" );
+    setTypename( typeKey );
 }
 
 MatrixLinker::~MatrixLinker() {
@@ -51,11 +53,8 @@ u_int MatrixLinker::size() const {
 }
 
 void MatrixLinker::randomize( Real min, Real max ) {
-    for ( u_int i = 0; i<nrows; i++ ) {
-        for ( u_int j = 0; j<ncols; j++ ) {
-            w[i][j] = Random::flatReal( min, max );
-        }
-    }
+    Random::flatRealMat( w, min, max );
+    weightsChanged();
 }
 
 void MatrixLinker::setWeight( u_int from, u_int to, Real weight ) {
@@ -70,6 +69,7 @@ void MatrixLinker::setWeight( u_int from, u_int to, Real weight ) {
     }
 #endif
     w[from][to] = weight;
+    weightsChanged();
 }
 
 Real MatrixLinker::getWeight( u_int from, u_int to ) {
@@ -88,10 +88,12 @@ Real MatrixLinker::getWeight( u_int from, u_int to ) {
 
 void MatrixLinker::setMatrix( const RealMat& mat ) {
     w.assign( mat );
+    weightsChanged();
 }
 
 bool MatrixLinker::setMatrix( const Variant& v ) {
     w.assign( *( v.getRealMat() ) );
+    weightsChanged();
     return true;
 }
 
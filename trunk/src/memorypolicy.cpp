@@ -0,0 +1,359 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "memorypolicy.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <vector>
+#include <cstdio>
+#include <cstring>
+#include <cstdlib>
+#ifdef WIN32
+	#include <malloc.h>
+#else
+	#include <sys/mman.h>
+	#include <unistd.h>
+#endif
+#ifdef __linux__
+	#include <sched.h>
+	#include <sys/syscall.h>
+#endif
+
+#ifndef MPOL_PREFERRED
+	#define MPOL_PREFERRED 1
+#endif
+#ifndef MPOL_INTERLEAVE
+	#define MPOL_INTERLEAVE 3
+#endif
+
+namespace nnfw {
+
+/*! the nodes handled by the masks passed to mbind */
+static const int numaMaxNodes = 256;
+static const int numaMaskWords = numaMaxNodes/( 8*sizeof(unsigned long) );
+
+/*! read the first line of a file of /sys or /proc; return false if it doesn't exist */
+static bool readLine( const char* filename, char* line, int size ) {
+	FILE* f = fopen( filename, "r" );
+	if ( !f ) return false;
+	bool ok = ( fgets( line, size, f ) != 0 );
+	fclose( f );
+	return ok;
+}
+
+/*! parse a list like "0-3,8,10-11" into the ids; return the highest id, or -1 if empty */
+static int parseList( const char* list, std::vector<int>& ids ) {
+	int highest = -1;
+	const char* p = list;
+	while( *p ) {
+		char* end;
+		long first = strtol( p, &end, 10 );
+		if ( end == p ) break;
+		long last = first;
+		p = end;
+		if ( *p == '-' ) {
+			last = strtol( p+1, &end, 10 );
+			p = end;
+		}
+		for( long i=first; i<=last; i++ ) {
+			ids.push_back( (int)i );
+		}
+		if ( last > highest ) highest = (int)last;
+		if ( *p == ',' ) p++;
+	}
+	return highest;
+}
+
+/*! the topology read once from /sys */
+class numaTopology {
+public:
+	numaTopology() : nodes(1), cpus(), allCpus() {
+		char line[4096];
+		std::vector<int> ids;
+		if ( readLine( "/sys/devices/system/node/online", line, sizeof(line) ) ) {
+			int highest = parseList( line, ids );
+			if ( highest >= 0 ) {
+				nodes = ( highest < numaMaxNodes ) ? highest+1 : numaMaxNodes;
+			}
+		}
+		cpus.resize( nodes );
+		for( int n=0; n<nodes; n++ ) {
+			char name[64];
+			sprintf( name, "/sys/devices/system/node/node%d/cpulist", n );
+			if ( readLine( name, line, sizeof(line) ) ) {
+				parseList( line, cpus[n] );
+			}
+		}
+		if ( readLine( "/sys/devices/system/cpu/online", line, sizeof(line) ) ) {
+			parseList( line, allCpus );
+		}
+	};
+	int nodes;
+	/*! the processors of each node */
+	std::vector< std::vector<int> > cpus;
+	/*! all the processors online */
+	std::vector<int> allCpus;
+};
+
+static const numaTopology& topology() {
+	static numaTopology* t = new numaTopology();
+	return *t;
+}
+
+/*! warn only the first time that a kind of fallback happens */
+static void warnOnce( bool& warned, const char* text ) {
+	if ( warned ) return;
+	warned = true;
+	nWarning() << text;
+}
+
+/*! the header at the start of each mapping, before the block returned by allocate */
+class placedHeader {
+public:
+	void* base;
+	size_t length;
+};
+static const size_t placedHeaderSize = NNFW_MEMORY_ALIGNMENT;
+
+/*! the allocator applying a MemoryPolicy */
+class memPlacedAllocator : public MemoryAllocator {
+public:
+	memPlacedAllocator( const MemoryPolicy& p ) : policy(p) { };
+	void* allocate( size_t bytes );
+	void deallocate( void* block, size_t bytes );
+	MemoryPolicy policy;
+private:
+	/*! map length bytes following the policy; return zero if it fails */
+	void* mapPages( size_t length, size_t& mapped );
+	/*! apply the placement to the pages mapped, before they are touched */
+	void placePages( void* base, size_t length );
+};
+
+#ifdef WIN32
+
+void* memPlacedAllocator::allocate( size_t bytes ) {
+	return _aligned_malloc( bytes, NNFW_MEMORY_ALIGNMENT );
+}
+
+void memPlacedAllocator::deallocate( void* block, size_t ) {
+	_aligned_free( block );
+}
+
+#else
+
+static size_t roundUp( size_t bytes, size_t unit ) {
+	return ( ( bytes + unit - 1 )/unit )*unit;
+}
+
+void* memPlacedAllocator::mapPages( size_t length, size_t& mapped ) {
+	static bool noHuge = false;
+	static bool noTransparent = false;
+	const int prot = PROT_READ | PROT_WRITE;
+	const int flags = MAP_PRIVATE | MAP_ANONYMOUS;
+	size_t huge = MemoryPolicy::hugePageSize();
+#ifdef MAP_HUGETLB
+	if ( policy.pages == MemoryPolicy::HugePages ) {
+		mapped = roundUp( length, huge );
+		void* base = mmap( 0, mapped, prot, flags | MAP_HUGETLB, -1, 0 );
+		if ( base != MAP_FAILED ) return base;
+		warnOnce( noHuge, "No huge page available; transparent huge pages are used instead" );
+	}
+#endif
+	if ( policy.pages != MemoryPolicy::SmallPages ) {
+		// --- a mapping aligned to the huge pages, so the kernel can back it with them
+		mapped = roundUp( length, huge );
+		char* raw = (char*)mmap( 0, mapped + huge, prot, flags, -1, 0 );
+		if ( raw == (char*)MAP_FAILED ) return 0;
+		char* base = (char*)roundUp( (size_t)raw, huge );
+		if ( base > raw ) munmap( raw, base - raw );
+		munmap( base + mapped, ( raw + huge ) - base );
+#ifdef MADV_HUGEPAGE
+		if ( madvise( base, mapped, MADV_HUGEPAGE ) != 0 ) {
+			warnOnce( noTransparent, "Transparent huge pages are not available; small pages are used instead" );
+		}
+#else
+		warnOnce( noTransparent, "Transparent huge pages are not available; small pages are used instead" );
+#endif
+		return base;
+	}
+	mapped = roundUp( length, (size_t)sysconf( _SC_PAGESIZE ) );
+	void* base = mmap( 0, mapped, prot, flags, -1, 0 );
+	return ( base == MAP_FAILED ) ? 0 : base;
+}
+
+void memPlacedAllocator::placePages( void* base, size_t length ) {
+#if defined(__linux__) && defined(SYS_mbind)
+	static bool noBind = false;
+	int nodes = topology().nodes;
+	if ( policy.placement == MemoryPolicy::FirstTouch || nodes < 2 ) return;
+	unsigned long mask[numaMaskWords];
+	memset( mask, 0, sizeof(mask) );
+	const int bits = 8*sizeof(unsigned long);
+	int mode;
+	if ( policy.placement == MemoryPolicy::OnNode ) {
+		mode = MPOL_PREFERRED;
+		int n = policy.node % nodes;
+		mask[n/bits] |= 1UL << ( n%bits );
+	} else {
+		mode = MPOL_INTERLEAVE;
+		for( int n=0; n<nodes; n++ ) {
+			mask[n/bits] |= 1UL << ( n%bits );
+		}
+	}
+	if ( syscall( SYS_mbind, base, length, mode, mask, (unsigned long)( numaMaxNodes+1 ), 0 ) != 0 ) {
+		warnOnce( noBind, "The kernel refuses the placement of the pages on the NUMA nodes; the first-touch placement is used" );
+	}
+#else
+	(void)base;
+	(void)length;
+#endif
+}
+
+void* memPlacedAllocator::allocate( size_t bytes ) {
+	if ( bytes < policy.minBytes || policy.isDefault() ) {
+		void* block;
+		if ( posix_memalign( &block, NNFW_MEMORY_ALIGNMENT, bytes ) != 0 ) return 0;
+		return block;
+	}
+	size_t mapped;
+	char* base = (char*)mapPages( bytes + placedHeaderSize, mapped );
+	if ( !base ) return 0;
+	placePages( base, mapped );
+	placedHeader* h = (placedHeader*)base;
+	h->base = base;
+	h->length = mapped;
+	return base + placedHeaderSize;
+}
+
+void memPlacedAllocator::deallocate( void* block, size_t bytes ) {
+	if ( bytes < policy.minBytes || policy.isDefault() ) {
+		free( block );
+		return;
+	}
+	placedHeader* h = (placedHeader*)( (char*)block - placedHeaderSize );
+	munmap( h->base, h->length );
+}
+
+#endif
+
+MemoryPolicy::MemoryPolicy( Placement placement, int node, Pages pages, size_t minBytes )
+	: placement(placement), node(node), pages(pages), minBytes(minBytes) {
+}
+
+MemoryAllocator* MemoryPolicy::allocator() const {
+	// --- the allocators are never destroyed: the buffers hold a pointer to the one allocating them
+	static QMutex mutex;
+	static std::vector<memPlacedAllocator*>* allocators = new std::vector<memPlacedAllocator*>();
+	QMutexLocker lock( &mutex );
+	for( u_int i=0; i<allocators->size(); i++ ) {
+		if ( (*allocators)[i]->policy == *this ) {
+			return (*allocators)[i];
+		}
+	}
+	allocators->push_back( new memPlacedAllocator( *this ) );
+	return allocators->back();
+}
+
+int MemoryPolicy::numNodes() {
+	return topology().nodes;
+}
+
+int MemoryPolicy::currentNode() {
+#if defined(__linux__) && defined(SYS_getcpu)
+	unsigned int cpu, node;
+	if ( syscall( SYS_getcpu, &cpu, &node, 0 ) == 0 ) {
+		return (int)node;
+	}
+#endif
+	return 0;
+}
+
+int MemoryPolicy::numCpusOf( int node ) {
+	const numaTopology& t = topology();
+	if ( node < 0 || node >= t.nodes ) return 0;
+	return (int)t.cpus[node].size();
+}
+
+bool MemoryPolicy::bindThreadToNode( int node ) {
+#ifdef __linux__
+	const numaTopology& t = topology();
+	if ( node < 0 || node >= t.nodes || t.cpus[node].empty() ) return false;
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	for( u_int i=0; i<t.cpus[node].size(); i++ ) {
+		if ( t.cpus[node][i] < CPU_SETSIZE ) CPU_SET( t.cpus[node][i], &set );
+	}
+	return ( sched_setaffinity( 0, sizeof(set), &set ) == 0 );
+#else
+	(void)node;
+	return false;
+#endif
+}
+
+void MemoryPolicy::unbindThread() {
+#ifdef __linux__
+	const numaTopology& t = topology();
+	cpu_set_t set;
+	CPU_ZERO( &set );
+	if ( t.allCpus.empty() ) {
+		for( int i=0; i<CPU_SETSIZE; i++ ) CPU_SET( i, &set );
+	}
+	for( u_int i=0; i<t.allCpus.size(); i++ ) {
+		if ( t.allCpus[i] < CPU_SETSIZE ) CPU_SET( t.allCpus[i], &set );
+	}
+	sched_setaffinity( 0, sizeof(set), &set );
+#endif
+}
+
+/*! read the value in kB of a field of /proc/meminfo; return -1 if it's not there */
+static long meminfoField( const char* field ) {
+	FILE* f = fopen( "/proc/meminfo", "r" );
+	if ( !f ) return -1;
+	char line[256];
+	long value = -1;
+	size_t len = strlen( field );
+	while( fgets( line, sizeof(line), f ) ) {
+		if ( strncmp( line, field, len ) == 0 && line[len] == ':' ) {
+			value = strtol( line+len+1, 0, 10 );
+			break;
+		}
+	}
+	fclose( f );
+	return value;
+}
+
+size_t MemoryPolicy::hugePageSize() {
+	static long kb = meminfoField( "Hugepagesize" );
+	return ( kb > 0 ) ? (size_t)kb*1024 : (size_t)2*1024*1024;
+}
+
+int MemoryPolicy::freeHugePages() {
+	long n = meminfoField( "HugePages_Free" );
+	return ( n > 0 ) ? (int)n : 0;
+}
+
+bool MemoryPolicy::transparentHugePagesEnabled() {
+	char line[256];
+	if ( !readLine( "/sys/kernel/mm/transparent_hugepage/enabled", line, sizeof(line) ) ) {
+		return false;
+	}
+	return ( strstr( line, "[never]" ) == 0 );
+}
+
+}
@@ -0,0 +1,319 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "types.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QAtomicInt>
+#include <QThreadStorage>
+#include <vector>
+#include <new>
+#include <cstdlib>
+#ifdef WIN32
+	#include <malloc.h>
+#endif
+
+namespace nnfw {
+
+/*! the smallest size class of the default allocator is 2^memMinShift bytes */
+static const u_int memMinShift = 5;
+/*! the largest size class of the default allocator is 2^memMaxShift bytes */
+static const u_int memMaxShift = 20;
+static const u_int memNumClasses = memMaxShift - memMinShift + 1;
+/*! bytes kept by the free list of each size class of a thread */
+static const size_t memListBytes = 1 << 20;
+
+/*! the header stored just before the data returned by memoryAlloc */
+class memHeader {
+public:
+	MemoryAllocator* owner;
+	size_t bytes;
+};
+/*! alignment of the data smaller than NNFW_MEMORY_ALIGNMENT; it's enough for any scalar type and
+ *  for the SSE vectors, and it lets a vector of few elements fit into a block of 32 bytes */
+static const size_t memSmallAlignment = 16;
+
+/*! the space reserved before data of bytes; it keeps the data aligned and contains the header */
+static size_t memHeaderSize( size_t bytes ) {
+	return ( bytes < NNFW_MEMORY_ALIGNMENT ) ? memSmallAlignment : NNFW_MEMORY_ALIGNMENT;
+}
+
+/*! a block into a free list */
+class memFreeBlock {
+public:
+	memFreeBlock* next;
+};
+
+/*! allocate memory from the system aligned as required by the blocks of bytes */
+static void* systemAlloc( size_t bytes ) {
+	size_t align = ( bytes < NNFW_MEMORY_ALIGNMENT ) ? memSmallAlignment : NNFW_MEMORY_ALIGNMENT;
+#ifdef WIN32
+	return _aligned_malloc( bytes, align );
+#else
+	void* block;
+	if ( posix_memalign( &block, align, bytes ) != 0 ) return 0;
+	return block;
+#endif
+}
+
+/*! release memory allocated by systemAlloc */
+static void systemFree( void* block ) {
+#ifdef WIN32
+	_aligned_free( block );
+#else
+	free( block );
+#endif
+}
+
+/*! the counters kept by each thread */
+enum memCounter {
+	memAllocations = 0,
+	memDeallocations,
+	memRecycled,
+	memBytesAllocated,
+	memBytesFreed,
+	memNumCounters
+};
+/*! a counter of a thread is folded into its totals before reaching this value */
+static const int memFoldLimit = 1 << 30;
+
+/*! the free lists and the counters of a thread */
+class memThreadCache {
+public:
+	memThreadCache();
+	/*! release the blocks of the free lists and keep the counters into the totals */
+	~memThreadCache();
+	/*! the value of a counter; only the thread owning the cache, or a thread holding the mutex
+	 *  of memShared, can call it */
+	double total( u_int which );
+	memFreeBlock* lists[memNumClasses];
+	u_int counts[memNumClasses];
+	/*! the counters are written only by the thread owning the cache, but memoryStats reads them
+	 *  from any thread, so they are atomic */
+	QAtomicInt counters[memNumCounters];
+	/*! the part of the counters exceeding memFoldLimit; it's changed holding the mutex */
+	double folded[memNumCounters];
+	/*! the allocator installed by setThreadMemoryAllocator */
+	MemoryAllocator* allocator;
+};
+
+/*! the state shared by all threads; it's never destroyed, so the VectorData destroyed
+ *  at the exit of the program can still release their data */
+class memShared {
+public:
+	memShared() : mutex(), caches(), threads(), retired(), allocator(0) {
+		retired.allocations = 0;
+		retired.deallocations = 0;
+		retired.recycled = 0;
+		retired.bytesAllocated = 0.0;
+		retired.bytesInUse = 0.0;
+	};
+	/*! protects threads and retired */
+	QMutex mutex;
+	QThreadStorage<memThreadCache*> caches;
+	std::vector<memThreadCache*> threads;
+	/*! the counters of the terminated threads */
+	MemoryStats retired;
+	MemoryAllocator* allocator;
+};
+
+static memShared& shared() {
+	static memShared* s = new memShared();
+	return *s;
+}
+
+memThreadCache::memThreadCache() : allocator(0) {
+	for( u_int i=0; i<memNumClasses; i++ ) {
+		lists[i] = 0;
+		counts[i] = 0;
+	}
+	for( u_int i=0; i<memNumCounters; i++ ) {
+		counters[i] = 0;
+		folded[i] = 0.0;
+	}
+}
+
+memThreadCache::~memThreadCache() {
+	for( u_int i=0; i<memNumClasses; i++ ) {
+		while( lists[i] ) {
+			memFreeBlock* b = lists[i];
+			lists[i] = b->next;
+			systemFree( b );
+		}
+	}
+	memShared& s = shared();
+	QMutexLocker lock( &s.mutex );
+	s.retired.allocations += (unsigned long)total( memAllocations );
+	s.retired.deallocations += (unsigned long)total( memDeallocations );
+	s.retired.recycled += (unsigned long)total( memRecycled );
+	s.retired.bytesAllocated += total( memBytesAllocated );
+	s.retired.bytesInUse += total( memBytesAllocated ) - total( memBytesFreed );
+	for( u_int i=0; i<s.threads.size(); i++ ) {
+		if ( s.threads[i] == this ) {
+			s.threads.erase( s.threads.begin()+i );
+			break;
+		}
+	}
+}
+
+double memThreadCache::total( u_int which ) {
+	return folded[which] + counters[which].fetchAndAddRelaxed( 0 );
+}
+
+/*! return the cache of the current thread */
+static memThreadCache* localCache() {
+	memShared& s = shared();
+	if ( s.caches.hasLocalData() ) {
+		return s.caches.localData();
+	}
+	memThreadCache* cache = new memThreadCache();
+	s.caches.setLocalData( cache );
+	QMutexLocker lock( &s.mutex );
+	s.threads.push_back( cache );
+	return cache;
+}
+
+/*! add n to a counter of the cache of the current thread */
+static void memCount( memThreadCache* cache, u_int which, size_t n ) {
+	if ( n < (size_t)memFoldLimit ) {
+		if ( cache->counters[which].fetchAndAddRelaxed( (int)n ) < memFoldLimit - (int)n ) {
+			return;
+		}
+		n = 0;
+	}
+	// --- the counter is moved into folded before it overflows; it happens rarely
+	QMutexLocker lock( &shared().mutex );
+	cache->folded[which] += (double)n + cache->counters[which].fetchAndStoreRelaxed( 0 );
+}
+
+/*! return the size class of a block of bytes, or memNumClasses if it's too large */
+static u_int sizeClass( size_t bytes ) {
+	u_int c = 0;
+	while( c < memNumClasses && ( (size_t)1 << ( c+memMinShift ) ) < bytes ) {
+		c++;
+	}
+	return c;
+}
+
+/*! the default allocator: a free list for each size class and for each thread */
+class memPoolAllocator : public MemoryAllocator {
+public:
+	void* allocate( size_t bytes ) {
+		u_int c = sizeClass( bytes );
+		if ( c == memNumClasses ) {
+			return systemAlloc( bytes );
+		}
+		memThreadCache* cache = localCache();
+		if ( cache->lists[c] ) {
+			memFreeBlock* b = cache->lists[c];
+			cache->lists[c] = b->next;
+			cache->counts[c]--;
+			memCount( cache, memRecycled, 1 );
+			return b;
+		}
+		return systemAlloc( (size_t)1 << ( c+memMinShift ) );
+	};
+	void deallocate( void* block, size_t bytes ) {
+		u_int c = sizeClass( bytes );
+		if ( c == memNumClasses ) {
+			systemFree( block );
+			return;
+		}
+		// --- the block goes into the list of the thread releasing it
+		memThreadCache* cache = localCache();
+		size_t size = (size_t)1 << ( c+memMinShift );
+		if ( ( cache->counts[c]+1 )*size > memListBytes && cache->counts[c] >= 2 ) {
+			systemFree( block );
+			return;
+		}
+		memFreeBlock* b = (memFreeBlock*)block;
+		b->next = cache->lists[c];
+		cache->lists[c] = b;
+		cache->counts[c]++;
+	};
+};
+
+static MemoryAllocator* defaultAllocator() {
+	static memPoolAllocator* pool = new memPoolAllocator();
+	return pool;
+}
+
+void setMemoryAllocator( MemoryAllocator* allocator ) {
+	shared().allocator = allocator;
+}
+
+MemoryAllocator* setThreadMemoryAllocator( MemoryAllocator* allocator ) {
+	memThreadCache* cache = localCache();
+	MemoryAllocator* prev = cache->allocator;
+	cache->allocator = allocator;
+	return prev;
+}
+
+void* memoryAlloc( size_t bytes ) {
+	memShared& s = shared();
+	memThreadCache* cache = localCache();
+	MemoryAllocator* owner = cache->allocator;
+	if ( !owner ) {
+		owner = ( s.allocator ) ? s.allocator : defaultAllocator();
+	}
+	size_t hsize = memHeaderSize( bytes );
+	char* block = (char*)( owner->allocate( bytes + hsize ) );
+	if ( !block ) {
+		// --- the same behaviour of new
+		throw std::bad_alloc();
+	}
+	// --- the header is always just before the data, so memoryFree finds it without knowing hsize
+	memHeader* h = (memHeader*)( block + hsize ) - 1;
+	h->owner = owner;
+	h->bytes = bytes;
+	memCount( cache, memAllocations, 1 );
+	memCount( cache, memBytesAllocated, bytes );
+	return block + hsize;
+}
+
+void memoryFree( void* data ) {
+	if ( !data ) return;
+	memHeader* h = (memHeader*)data - 1;
+	size_t hsize = memHeaderSize( h->bytes );
+	memThreadCache* cache = localCache();
+	memCount( cache, memDeallocations, 1 );
+	memCount( cache, memBytesFreed, h->bytes );
+	h->owner->deallocate( (char*)data - hsize, h->bytes + hsize );
+}
+
+MemoryStats memoryStats() {
+	memShared& s = shared();
+	QMutexLocker lock( &s.mutex );
+	MemoryStats st = s.retired;
+	for( u_int i=0; i<s.threads.size(); i++ ) {
+		memThreadCache* c = s.threads[i];
+		st.allocations += (unsigned long)c->total( memAllocations );
+		st.deallocations += (unsigned long)c->total( memDeallocations );
+		st.recycled += (unsigned long)c->total( memRecycled );
+		st.bytesAllocated += c->total( memBytesAllocated );
+		st.bytesInUse += c->total( memBytesAllocated ) - c->total( memBytesFreed );
+	}
+	return st;
+}
+
+unsigned long memoryAllocations() {
+	return (unsigned long)localCache()->total( memAllocations );
+}
+
+}
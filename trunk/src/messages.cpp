@@ -20,7 +20,10 @@
 #include "types.h"
 #include <iostream>
 #include <QString>
+#include <QThread>
+#include <QAtomicInt>
 #include <cstdio>
+#include <cstring>
 
 extern void exit( int status );
 
@@ -30,6 +33,8 @@ namespace nnfw {
 class nnfwStringPrivate {
 public:
 	QString qstr;
+	/*! keeps the data returned by toUtf8 */
+	QByteArray utf8;
 };
 
 nnfwString::nnfwString() {
@@ -90,27 +95,279 @@ bool nnfwString::operator==( const nnfwString& left ) {
 }
 
 const char* nnfwString::toUtf8() const {
-	return prv->qstr.toUtf8().data();
+	prv->utf8 = prv->qstr.toUtf8();
+	return prv->utf8.constData();
 }
 
-nMessage::nMessage() {
-	linePending = false;
+/*! prefix of messages for each level */
+static const char* levelPrefix( int level ) {
+	switch( level ) {
+	case nLogWarning: return "== WARNING: ";
+	case nLogError: return "== ERROR: ";
+	default: return "== FATAL: ";
+	}
+}
+
+/*! write a message on the standard output */
+static void writeMessage( int level, const char* text, unsigned int len ) {
+	printf( "%s%.*s\n", levelPrefix( level ), (int)len, text );
+}
+
+/*! difference of positions, correct also when they wrap around */
+static inline int seqDiff( int a, int b ) {
+	return (int)( (unsigned int)a - (unsigned int)b );
+}
+
+/*! a slot of the queue of messages */
+class msgSlot {
+public:
+	/*! position of the slot in the sequence of writes; it says if the slot is free or full */
+	QAtomicInt seq;
+	int level;
+	unsigned int len;
+	char text[NNFW_MESSAGE_SIZE];
+};
+
+/*! Bounded queue of messages with many producers and a single consumer, without locks;
+ *  each slot passes from free to full and back following the sequence numbers */
+class msgQueue : public QThread {
+public:
+	msgQueue( unsigned int capacity ) : ring(0), mask(0), head(0), tail(0), written(0), lost(0), stopping(0) {
+		unsigned int size = 2;
+		while( size < capacity ) size *= 2;
+		ring = new msgSlot[size];
+		mask = size-1;
+		for( unsigned int i=0; i<size; i++ ) {
+			ring[i].seq = (int)i;
+		}
+	};
+	~msgQueue() {
+		stopping.fetchAndStoreOrdered( 1 );
+		wait();
+		delete []ring;
+	};
+	/*! return false if the queue is full */
+	bool push( int level, const char* text, unsigned int len ) {
+		int pos = tail.fetchAndAddOrdered( 0 );
+		while( true ) {
+			msgSlot& slot = ring[pos & mask];
+			int diff = seqDiff( slot.seq.fetchAndAddAcquire( 0 ), pos );
+			if ( diff == 0 ) {
+				if ( tail.testAndSetOrdered( pos, pos+1 ) ) {
+					slot.level = level;
+					slot.len = len;
+					memcpy( slot.text, text, len );
+					slot.seq.fetchAndStoreRelease( pos+1 );
+					return true;
+				}
+				pos = tail.fetchAndAddOrdered( 0 );
+			} else if ( diff < 0 ) {
+				return false;
+			} else {
+				pos = tail.fetchAndAddOrdered( 0 );
+			}
+		}
+	};
+	/*! write the next message; return false if the queue is empty */
+	bool pop() {
+		msgSlot& slot = ring[head & mask];
+		if ( seqDiff( slot.seq.fetchAndAddAcquire( 0 ), head+1 ) < 0 ) {
+			return false;
+		}
+		writeMessage( slot.level, slot.text, slot.len );
+		slot.seq.fetchAndStoreRelease( head + mask + 1 );
+		head++;
+		written.fetchAndStoreRelease( head );
+		return true;
+	};
+	/*! wait until the messages pushed before the call are written */
+	void flush() {
+		int target = tail.fetchAndAddOrdered( 0 );
+		while( seqDiff( written.fetchAndAddAcquire( 0 ), target ) < 0 ) {
+			QThread::yieldCurrentThread();
+		}
+	};
+	msgSlot* ring;
+	int mask;
+	/*! next slot to read; used only by the writer thread */
+	int head;
+	/*! next slot to write */
+	QAtomicInt tail;
+	/*! number of messages written */
+	QAtomicInt written;
+	QAtomicInt lost;
+	QAtomicInt stopping;
+protected:
+	void run() {
+		while( true ) {
+			if ( pop() ) continue;
+			if ( stopping.fetchAndAddAcquire( 0 ) ) {
+				// --- the messages pushed before stopping are written
+				while( pop() ) { };
+				break;
+			}
+			fflush( stdout );
+			msleep( 1 );
+		}
+		fflush( stdout );
+	};
+};
+
+/*! the queue used in asynchronous mode */
+static msgQueue* queue = 0;
+/*! messages discarded by queues already destroyed */
+static unsigned int droppedBefore = 0;
+
+/*! it writes the pending messages at the exit of program */
+class msgQueueGuard {
+public:
+	~msgQueueGuard() {
+		nMessage::setAsync( false );
+	};
+};
+static msgQueueGuard queueGuard;
+
+int nMessage::threshold = nLogWarning;
+
+void nMessage::setLevel( nLogLevel level ) {
+	threshold = level;
 }
 
-nMessage::msgLine::msgLine( nMessage* parent ) : msg() {
-	this->parent = parent;
-	if ( parent->linePending ) {
-		delete (parent->pending);
+void nMessage::setAsync( bool b, unsigned int capacity ) {
+	// --- it must not be called while other threads are printing messages
+	if ( queue ) {
+		droppedBefore += (unsigned int)queue->lost.fetchAndAddOrdered( 0 );
+		delete queue;
+		queue = 0;
 	}
-	parent->linePending = true;
-	parent->pending = this;
+	if ( b ) {
+		queue = new msgQueue( capacity );
+		queue->start();
+	}
+}
+
+bool nMessage::isAsync() {
+	return ( queue != 0 );
+}
+
+void nMessage::flush() {
+	if ( queue ) {
+		queue->flush();
+	}
+	fflush( stdout );
+}
+
+unsigned int nMessage::dropped() {
+	unsigned int n = droppedBefore;
+	if ( queue ) {
+		n += (unsigned int)queue->lost.fetchAndAddOrdered( 0 );
+	}
+	return n;
+}
+
+nMessage::msgLine::msgLine( nLogLevel level )
+	: lev(level), active( nMessage::isEnabled( level ) ), len(0) {
+}
+
+nMessage::msgLine::msgLine( const msgLine& src )
+	: lev(src.lev), active(src.active), len(src.len) {
+	if ( active ) {
+		memcpy( text, src.text, len );
+	}
+	src.active = false;
 }
 
 nMessage::msgLine::~msgLine() {
-	printf( "%s\n", msg.toUtf8() );
-	parent->linePending = false;
-    return;
+	if ( !active ) return;
+	if ( queue ) {
+		if ( lev < nLogFatal ) {
+			if ( !queue->push( lev, text, len ) ) {
+				queue->lost.fetchAndAddOrdered( 1 );
+			}
+			return;
+		}
+		// --- fatal messages are never discarded
+		while( !queue->push( lev, text, len ) ) {
+			QThread::yieldCurrentThread();
+		}
+		queue->flush();
+	} else {
+		writeMessage( lev, text, len );
+	}
 }
 
+void nMessage::msgLine::put( const char* str, unsigned int n ) {
+	if ( n > NNFW_MESSAGE_SIZE - len ) {
+		n = NNFW_MESSAGE_SIZE - len;
+	}
+	memcpy( text+len, str, n );
+	len += n;
 }
 
+nMessage::msgLine& nMessage::msgLine::operator<<( const nnfwString& part ) {
+	if ( active ) {
+		const char* str = part.toUtf8();
+		put( str, strlen( str ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( const char* part ) {
+	if ( active && part ) {
+		put( part, strlen( part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( char part ) {
+	if ( active ) {
+		put( &part, 1 );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( int part ) {
+	if ( active ) {
+		char buf[32];
+		put( buf, sprintf( buf, "%d", part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( unsigned int part ) {
+	if ( active ) {
+		char buf[32];
+		put( buf, sprintf( buf, "%u", part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( long part ) {
+	if ( active ) {
+		char buf[32];
+		put( buf, sprintf( buf, "%ld", part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( unsigned long part ) {
+	if ( active ) {
+		char buf[32];
+		put( buf, sprintf( buf, "%lu", part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( double part ) {
+	if ( active ) {
+		char buf[32];
+		put( buf, sprintf( buf, "%g", part ) );
+	}
+	return (*this);
+}
+
+nMessage::msgLine& nMessage::msgLine::operator<<( float part ) {
+	return (*this) << (double)part;
+}
+
+}
@@ -19,22 +19,46 @@
 
 #include "neuralnet.h"
 #include "nnfwfactory.h"
+#include "biasedcluster.h"
+#include "gatedcluster.h"
+#include "matrixlinker.h"
 #include <algorithm>
+#include <set>
 #include <functional>
 #include <cstring>
+#include <QMutex>
+#include <QMutexLocker>
 
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+#endif
 
 namespace nnfw {
 
+/*! the number of nets in real-time mode and the level of messages before the first of them
+ *  was enabled; the level is restored when the last one is disabled */
+static QMutex rtLevelMutex;
+static int rtNets = 0;
+static nLogLevel rtSavedLevel = nLogWarning;
+
 /**********************************************
  *  Implementation of BaseNeuralNet Class     *
  **********************************************/
 
 BaseNeuralNet::BaseNeuralNet() {
     dimUps = 0;
+    paramSize = 0;
+    paramDirty = true;
+	realtime = false;
+	rtViolations = 0;
 }
 
 BaseNeuralNet::~BaseNeuralNet() {
+	if ( realtime ) {
+		setRealTime( false );
+	}
 }
 
 void BaseNeuralNet::addCluster( Cluster* c, bool isInput, bool isOutput ) {
@@ -68,6 +92,8 @@ void BaseNeuralNet::addCluster( Cluster* c, bool isInput, bool isOutput ) {
         hidclusters.push_back( c );
 	}
 	clsMap[c->name()] = c;
+	paramDirty = true;
+	subOrders.clear();
     return;
 }
 
@@ -88,6 +114,8 @@ bool BaseNeuralNet::removeCluster( Cluster* c ) {
 	hidclusters.erase( ids[3] );
 	clsMap.erase( c->name() );
 	clsIdsMap.erase( c );
+	paramDirty = true;
+	subOrders.clear();
     return true;
 }
 
@@ -238,6 +266,8 @@ void BaseNeuralNet::addLinker( Linker* l ) {
     inLinks[ l->getTo() ].push_back( l );
 
 	lksMap[l->name()] = l;
+	paramDirty = true;
+	subOrders.clear();
     return;
 }
 
@@ -257,6 +287,8 @@ bool BaseNeuralNet::removeLinker( Linker* l ) {
 	inLinks[ l->getTo() ].erase( ids[2] );
 	lksMap.erase( l->name() );
 	lksIdsMap.erase( l );
+	paramDirty = true;
+	subOrders.clear();
     return true;
 }
 
@@ -293,6 +325,7 @@ void BaseNeuralNet::setOrder( Updatable* u[], u_int dim ) {
         }
     }
     dimUps = ups.size();
+    subOrders.clear();
     return;
 }
 
@@ -305,9 +338,74 @@ void BaseNeuralNet::setOrder( const UpdatableVec& u ) {
         }
     }
     dimUps = ups.size();
+    subOrders.clear();
     return;
 }
 
+const UpdatableVec& BaseNeuralNet::orderFor( const ClusterVec& outputs ) {
+	subKey.clear();
+	for( u_int i=0; i<outputs.size(); i++ ) {
+		subKey.push_back( outputs[i] );
+	}
+	return subOrder();
+}
+
+void BaseNeuralNet::evaluate( const ClusterVec& outputs ) {
+	const UpdatableVec& sub = orderFor( outputs );
+	for( u_int i=0; i<sub.size(); i++ ) {
+		NNFW_PROFILE_SCOPE( sub[i] );
+		sub[i]->update();
+	}
+}
+
+void BaseNeuralNet::evaluate( Cluster* output ) {
+	subKey.clear();
+	subKey.push_back( output );
+	const UpdatableVec& sub = subOrder();
+	for( u_int i=0; i<sub.size(); i++ ) {
+		NNFW_PROFILE_SCOPE( sub[i] );
+		sub[i]->update();
+	}
+}
+
+const UpdatableVec& BaseNeuralNet::subOrder() {
+	std::sort( subKey.begin(), subKey.end() );
+	subKey.erase( std::unique( subKey.begin(), subKey.end() ), subKey.end() );
+	SubOrdersMap::iterator it = subOrders.find( subKey );
+	if ( it != subOrders.end() ) {
+		return it->second;
+	}
+	// --- the Clusters reachable backward from the requested ones
+	std::set<Cluster*> needed;
+	std::vector<Cluster*> tovisit( subKey );
+	while( !tovisit.empty() ) {
+		Cluster* cl = tovisit.back();
+		tovisit.pop_back();
+		if ( needed.count( cl ) ) continue;
+		needed.insert( cl );
+		const LinkerVec& ins = linkers( cl, false );
+		for( u_int i=0; i<ins.size(); i++ ) {
+			tovisit.push_back( ins[i]->from() );
+		}
+	}
+	UpdatableVec& sub = subOrders[subKey];
+	for( u_int i=0; i<dimUps; i++ ) {
+		Cluster* cl = dynamic_cast<Cluster*>( ups[i] );
+		if ( cl ) {
+			if ( needed.count( cl ) ) sub.push_back( cl );
+			continue;
+		}
+		Linker* lk = dynamic_cast<Linker*>( ups[i] );
+		if ( lk ) {
+			if ( needed.count( lk->to() ) ) sub.push_back( lk );
+			continue;
+		}
+		// --- other Updatables are always kept
+		sub.push_back( ups[i] );
+	}
+	return sub;
+}
+
 void BaseNeuralNet::randomize( Real min, Real max ) {
 	int dim = clustersv.size();
 	for( int i=0; i<dim; i++ ) {
@@ -381,7 +479,242 @@ BaseNeuralNet* BaseNeuralNet::clone() const {
 		ord << clone->getByName( order()[i]->name() );
 	}
 	clone->setOrder( ord );
+	if ( !memPolicy.isDefault() ) {
+		clone->setMemoryPolicy( memPolicy );
+	}
 	return clone;
 }
 
+const BaseNeuralNet::ParameterBlockVec& BaseNeuralNet::parameterBlocks() {
+	if ( !paramDirty ) {
+		return paramBlocks;
+	}
+	paramBlocks.clear();
+	paramSize = 0;
+	ParameterBlock pb;
+	for( u_int i=0; i<clustersv.size(); i++ ) {
+		BiasedCluster* bc = dynamic_cast<BiasedCluster*>( clustersv[i] );
+		if ( bc ) {
+			pb.updatable = bc;
+			pb.vec = &( bc->biases() );
+			pb.mat = 0;
+			pb.offset = paramSize;
+			pb.length = pb.vec->size();
+			paramSize += pb.length;
+			paramBlocks.append( pb );
+			continue;
+		}
+		GatedCluster* gc = dynamic_cast<GatedCluster*>( clustersv[i] );
+		if ( gc ) {
+			pb.updatable = gc;
+			pb.vec = &( gc->biases() );
+			pb.mat = 0;
+			pb.offset = paramSize;
+			pb.length = pb.vec->size();
+			paramSize += pb.length;
+			paramBlocks.append( pb );
+			pb.vec = 0;
+			pb.mat = &( gc->weights() );
+			pb.offset = paramSize;
+			pb.length = pb.mat->size();
+			paramSize += pb.length;
+			paramBlocks.append( pb );
+		}
+	}
+	for( u_int i=0; i<linkersv.size(); i++ ) {
+		MatrixLinker* ml = dynamic_cast<MatrixLinker*>( linkersv[i] );
+		if ( !ml ) continue;
+		pb.updatable = ml;
+		pb.vec = 0;
+		pb.mat = &( ml->matrix() );
+		pb.offset = paramSize;
+		pb.length = pb.mat->size();
+		paramSize += pb.length;
+		paramBlocks.append( pb );
+	}
+	paramDirty = false;
+	return paramBlocks;
+}
+
+u_int BaseNeuralNet::parametersSize() {
+	parameterBlocks();
+	return paramSize;
+}
+
+void BaseNeuralNet::gatherParameters( Real* buffer ) {
+	const ParameterBlockVec& pbs = parameterBlocks();
+	for( u_int i=0; i<pbs.size(); i++ ) {
+		const ParameterBlock& pb = pbs[i];
+		const Real* src = ( pb.vec ) ? pb.vec->rawdata() : pb.mat->rawdata().rawdata();
+		memoryCopy( buffer + pb.offset, src, pb.length );
+	}
+}
+
+void BaseNeuralNet::scatterParameters( const Real* buffer ) {
+	const ParameterBlockVec& pbs = parameterBlocks();
+	for( u_int i=0; i<pbs.size(); i++ ) {
+		const ParameterBlock& pb = pbs[i];
+		Real* dst = ( pb.vec ) ? pb.vec->rawdata() : pb.mat->rawdata().rawdata();
+		memoryCopy( dst, buffer + pb.offset, pb.length );
+		MatrixLinker* ml = dynamic_cast<MatrixLinker*>( pb.updatable );
+		if ( ml ) ml->weightsChanged();
+		// --- the weights of the missing connections of the gates have to stay zero
+		GatedCluster* gc = dynamic_cast<GatedCluster*>( pb.updatable );
+		if ( gc && pb.mat ) gc->constrainWeights();
+	}
+}
+
+bool BaseNeuralNet::setRealTime( bool enable, bool lockMemory ) {
+	if ( !enable ) {
+		if ( !realtime ) return true;
+		realtime = false;
+		unlockMemory();
+		{
+			QMutexLocker lock( &rtLevelMutex );
+			if ( --rtNets == 0 ) {
+				nMessage::setLevel( rtSavedLevel );
+			}
+		}
+		if ( rtViolations > 0 ) {
+			nWarning() << rtViolations << " real-time steps of the net allocated memory";
+		}
+		return true;
+	}
+	unlockMemory();
+	bool ok = prefault( lockMemory );
+	if ( !ok ) {
+		nWarning() << "It's not possible to lock the memory of the net; the real-time mode is enabled without locking";
+	}
+	stepLatencies.reset();
+	rtViolations = 0;
+	if ( !realtime ) {
+		QMutexLocker lock( &rtLevelMutex );
+		if ( rtNets++ == 0 ) {
+			rtSavedLevel = nMessage::level();
+			if ( rtSavedLevel < nLogFatal ) {
+				nMessage::setLevel( nLogFatal );
+			}
+		}
+	}
+	realtime = true;
+	return ok;
+}
+
+void BaseNeuralNet::stepRealTime() {
+	unsigned long allocs = memoryAllocations();
+	double start = Profiler::now();
+	for( u_int i=0; i<dimUps; i++ ) {
+		NNFW_PROFILE_SCOPE( ups[i] );
+		ups[i]->update();
+	}
+	stepLatencies.record( Profiler::now() - start );
+	if ( memoryAllocations() != allocs ) {
+		rtViolations++;
+	}
+}
+
+/*! touch the stack that step() will use, so its pages are already mapped */
+static void prefaultStack() {
+	volatile char stack[64*1024];
+	for( u_int i=0; i<sizeof(stack); i+=1024 ) {
+		stack[i] = 0;
+	}
+}
+
+bool BaseNeuralNet::prefault( bool lock ) {
+	std::vector< std::pair<void*, size_t> > bufs;
+	for( u_int i=0; i<clustersv.size(); i++ ) {
+		RealVec& ins = clustersv[i]->inputs();
+		RealVec& outs = clustersv[i]->outputs();
+		if ( ins.size() > 0 ) bufs.push_back( std::make_pair( (void*)ins.rawdata(), ins.size()*sizeof(Real) ) );
+		if ( outs.size() > 0 ) bufs.push_back( std::make_pair( (void*)outs.rawdata(), outs.size()*sizeof(Real) ) );
+	}
+	// --- the temporaries of Clusters and Linkers
+	std::vector<RealVec*> work;
+	for( u_int i=0; i<clustersv.size(); i++ ) {
+		clustersv[i]->workingMemory( work );
+	}
+	for( u_int i=0; i<linkersv.size(); i++ ) {
+		linkersv[i]->workingMemory( work );
+	}
+	for( u_int i=0; i<work.size(); i++ ) {
+		if ( work[i]->size() > 0 ) bufs.push_back( std::make_pair( (void*)work[i]->rawdata(), work[i]->size()*sizeof(Real) ) );
+	}
+	const ParameterBlockVec& pbs = parameterBlocks();
+	for( u_int i=0; i<pbs.size(); i++ ) {
+		if ( pbs[i].length == 0 ) continue;
+		Real* data = ( pbs[i].vec ) ? pbs[i].vec->rawdata() : pbs[i].mat->rawdata().rawdata();
+		bufs.push_back( std::make_pair( (void*)data, pbs[i].length*sizeof(Real) ) );
+	}
+	bool ok = true;
+	for( u_int i=0; i<bufs.size(); i++ ) {
+		// --- writing the same value maps the page without changing the data
+		volatile char* p = (volatile char*)bufs[i].first;
+		size_t len = bufs[i].second;
+		for( size_t off=0; off<len; off+=1024 ) {
+			p[off] = p[off];
+		}
+		p[len-1] = p[len-1];
+		if ( !lock ) continue;
+#ifdef WIN32
+		bool locked = ( VirtualLock( bufs[i].first, len ) != 0 );
+#else
+		bool locked = ( mlock( bufs[i].first, len ) == 0 );
+#endif
+		if ( locked ) {
+			rtLocked.push_back( bufs[i] );
+		} else {
+			ok = false;
+		}
+	}
+	prefaultStack();
+	return ok;
+}
+
+void BaseNeuralNet::unlockMemory() {
+	for( u_int i=0; i<rtLocked.size(); i++ ) {
+#ifdef WIN32
+		VirtualUnlock( rtLocked[i].first, rtLocked[i].second );
+#else
+		munlock( rtLocked[i].first, rtLocked[i].second );
+#endif
+	}
+	rtLocked.clear();
+}
+
+size_t BaseNeuralNet::setMemoryPolicy( const MemoryPolicy& policy ) {
+	memPolicy = policy;
+	// --- the memory locked by the real-time mode is going to be released
+	bool relock = !rtLocked.empty();
+	unlockMemory();
+	size_t moved = 0;
+	MemoryAllocator* prev = setThreadMemoryAllocator( policy.allocator() );
+	const ParameterBlockVec& pbs = parameterBlocks();
+	for( u_int i=0; i<pbs.size(); i++ ) {
+		const ParameterBlock& pb = pbs[i];
+		size_t bytes = pb.length*sizeof(Real);
+		if ( bytes < policy.minBytes ) continue;
+		// --- the copy is allocated following the policy and then exchanged with the original
+		if ( pb.vec ) {
+			if ( pb.vec->isView() ) continue;
+			RealVec tmp( pb.vec->size() );
+			tmp.assign( *(pb.vec) );
+			pb.vec->swap( tmp );
+		} else {
+			if ( pb.mat->isView() ) continue;
+			RealMat tmp( pb.mat->rows(), pb.mat->cols() );
+			tmp.assign( *(pb.mat) );
+			pb.mat->swap( tmp );
+			MatrixLinker* ml = dynamic_cast<MatrixLinker*>( pb.updatable );
+			if ( ml ) ml->weightsChanged();
+		}
+		moved += bytes;
+	}
+	setThreadMemoryAllocator( prev );
+	if ( realtime ) {
+		prefault( relock );
+	}
+	return moved;
+}
+
 }
@@ -22,6 +22,8 @@
 #include "biasedcluster.h"
 #include "ddecluster.h"
 #include "fakecluster.h"
+#include "lstmcluster.h"
+#include "grucluster.h"
 #include "matrixlinker.h"
 #include "sparsematrixlinker.h"
 #include "dotlinker.h"
@@ -99,6 +101,7 @@ public:
     /*! apply the rule changing the Updatable object */
     virtual void rule( Real learn_rate, const RealVec& x, const RealVec& y ) const {
 		ml->matrix().deltarule( learn_rate, x, y );
+		ml->weightsChanged();
 	};
 
     /*! Virtual Copy-Constructor */
@@ -243,6 +246,8 @@ void Factory::initFactory() {
 	clustertypes["BiasedCluster"] = new Creator<BiasedCluster>();
 	clustertypes["DDECluster"] = new Creator<DDECluster>();
 	clustertypes["FakeCluster"] = new Creator<FakeCluster>();
+	clustertypes["LSTMCluster"] = new Creator<LSTMCluster>();
+	clustertypes["GRUCluster"] = new Creator<GRUCluster>();
 	
 	linkertypes["SparseMatrixLinker"] = new Creator<SparseMatrixLinker>();
 	linkertypes["CopyLinker"] = new Creator<CopyLinker>();
@@ -289,6 +294,8 @@ void Factory::initFactory() {
 	modtypes["BiasedCluster"] = new BiasedClusterModifier();
 	modtypes["DDECluster"] = new DummyModifier();
 	modtypes["FakeCluster"] = new DummyModifier();
+	modtypes["LSTMCluster"] = new DummyModifier();
+	modtypes["GRUCluster"] = new DummyModifier();
 	modtypes["SparseMatrixLinker"] = new SparseMatrixLinkerModifier();
 	modtypes["CopyLinker"] = new DummyModifier();
 	modtypes["DotLinker"] = new MatrixLinkerModifier();
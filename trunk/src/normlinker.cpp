@@ -28,13 +28,15 @@
 namespace nnfw {
 
 NormLinker::NormLinker( Cluster* from, Cluster* to, const char* name )
-    : MatrixLinker(from, to, name), temp( to->numNeurons() ) {
-    setTypename( "NormLinker" );
+    : MatrixLinker(from, to, name), temp( to->numNeurons() ), wnorms( to->numNeurons() ), normsValid(false) {
+    static const PropertyKey typeKey( "NormLinker" );
+    setTypename( typeKey );
 }
 
 NormLinker::NormLinker( PropertySettings& prop )
-    : MatrixLinker( prop ), temp( to()->numNeurons() ) {
-    setTypename( "NormLinker" );
+    : MatrixLinker( prop ), temp( to()->numNeurons() ), wnorms( to()->numNeurons() ), normsValid(false) {
+    static const PropertyKey typeKey( "NormLinker" );
+    setTypename( typeKey );
 }
 
 NormLinker::~NormLinker() {
@@ -45,18 +47,88 @@ void NormLinker::update() {
     if ( to()->needReset() ) {
         to()->resetInputs();
     }
+    if ( !normsValid ) {
+        updateNorms();
+    }
+    const RealVec& x = from()->outputs();
     temp.zeroing();
-    for( u_int j=0; j<cols(); j++ ) {
-        for( u_int i=0; i<rows(); i++ ) {
-            Real d = from()->outputs()[i] - matrix()[i][j];
-            temp[j] += d*d;
-        }
-        temp[j] = std::sqrt( temp[j] );
+    RealMat::mul( temp, x, matrix() );
+    Real xx = 0.0;
+    for( u_int i=0; i<x.size(); i++ ) {
+        xx += x[i]*x[i];
+    }
+    for( u_int j=0; j<temp.size(); j++ ) {
+        // --- rounding can make the squared distance slightly negative
+        Real d2 = xx - 2.0*temp[j] + wnorms[j];
+        temp[j] = ( d2 > 0.0 ) ? std::sqrt( d2 ) : 0.0;
     }
     to()->inputs() += temp;
     return;
 }
 
+void NormLinker::updateCost( double& flops, double& bytes ) const {
+    const double r = rows();
+    const double c = cols();
+    flops = 2.0*r*c + 2.0*r + 5.0*c;
+    bytes = ( r*c + r + 4.0*c )*sizeof(Real);
+}
+
+void NormLinker::workingMemory( std::vector<RealVec*>& buffers ) {
+    buffers.push_back( &temp );
+    buffers.push_back( &wnorms );
+}
+
+void NormLinker::distances( const RealMat& xs, RealMat& ys, u_int count ) {
+    if ( xs.rows() < count || ys.rows() < count || xs.cols() != rows() || ys.cols() != cols() ) {
+        nError() << "Wrong dimensions of matrices passed to NormLinker::distances" ;
+        return;
+    }
+    if ( count == 0 ) return;
+    if ( !normsValid ) {
+        updateNorms();
+    }
+    for( u_int k=0; k<count; k++ ) {
+        ys[k].assign( wnorms );
+    }
+    RealMat::mul( ys, -2.0, xs, matrix(), count );
+    for( u_int k=0; k<count; k++ ) {
+        const RealVec& x = xs[k];
+        Real xx = 0.0;
+        for( u_int i=0; i<x.size(); i++ ) {
+            xx += x[i]*x[i];
+        }
+        RealVec& y = ys[k];
+        for( u_int j=0; j<y.size(); j++ ) {
+            Real d2 = y[j] + xx;
+            y[j] = ( d2 > 0.0 ) ? std::sqrt( d2 ) : 0.0;
+        }
+    }
+}
+
+const RealVec& NormLinker::squaredNorms() {
+    if ( !normsValid ) {
+        updateNorms();
+    }
+    return wnorms;
+}
+
+void NormLinker::weightsChanged() {
+    normsValid = false;
+}
+
+void NormLinker::updateNorms() {
+    // --- row by row, following the layout of the matrix
+    const RealMat& w = matrix();
+    wnorms.zeroing();
+    for( u_int i=0; i<w.rows(); i++ ) {
+        const RealVec& row = w[i];
+        for( u_int j=0; j<wnorms.size(); j++ ) {
+            wnorms[j] += row[j]*row[j];
+        }
+    }
+    normsValid = true;
+}
+
 NormLinker* NormLinker::clone() const {
 	NormLinker* newclone = new NormLinker( this->from(), this->to(), name() );
 	newclone->setMatrix( this->matrix() );
@@ -25,7 +25,8 @@ namespace nnfw {
 OutputFunction::OutputFunction()
     : Propertized(), tmp1(1), tmp2(1) {
     /* Nothing else to do */
-    setTypename( "OutputFunction" );
+    static const PropertyKey typeKey( "OutputFunction" );
+    setTypename( typeKey );
 }
 
 OutputFunction::~OutputFunction() {
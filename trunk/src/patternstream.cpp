@@ -0,0 +1,407 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "patternstream.h"
+#include "neuralnet.h"
+#include "random.h"
+#include "profiler.h"
+#include <QFile>
+#include <QThread>
+#include <QMutex>
+#include <QWaitCondition>
+#include <vector>
+#include <string>
+#include <cstring>
+
+namespace nnfw {
+
+/*! the identifier at the start of a pattern file */
+static const char streamMagic[8] = { 'N', 'N', 'F', 'W', 'P', 'A', 'T', 'S' };
+/*! the version of pattern file format */
+static const u_int streamVersion = 1;
+
+/*! description of the data of one Cluster into each row of file */
+class streamBlock {
+public:
+	Cluster* cluster;
+	bool isInput;
+	u_int dim;
+	/*! position into the row */
+	u_int offset;
+	/*! the data of the two DataSet used as double buffer */
+	RealVec* data[2];
+};
+
+/*! copy count rows from src into the matrices of blocks */
+template<class T>
+void decodeRows( const char* src, u_int count, u_int rowlen, std::vector<streamBlock>& blocks, int slot ) {
+	const T* rows = (const T*)src;
+	for( u_int i=0; i<count; i++ ) {
+		const T* row = rows + i*rowlen;
+		for( u_int b=0; b<blocks.size(); b++ ) {
+			RealVec& dst = *( blocks[b].data[slot] );
+			const u_int start = i*blocks[b].dim;
+			const T* bsrc = row + blocks[b].offset;
+			for( u_int k=0; k<blocks[b].dim; k++ ) {
+				dst[start+k] = (Real)( bsrc[k] );
+			}
+		}
+	}
+}
+
+class PatternStreamPrivate : public QThread {
+public:
+	PatternStreamPrivate( const char* filename )
+		: QThread(), file( filename ), map(0), valid(false), npat(0), batch(0), nbatches(0),
+		  realsize(0), rowlen(0), dataStart(0), blocks(), raw(), order(), pos(0), shuffle(false),
+		  requestSlot(-1), requestBatch(0), busy(false), quit(false), readError(false), mutex(), cond() {
+		slots[0] = slots[1] = 0;
+		slotCount[0] = slotCount[1] = 0;
+		slotReady[0] = slotReady[1] = false;
+	};
+	~PatternStreamPrivate() {
+		if ( isRunning() ) {
+			mutex.lock();
+			quit = true;
+			cond.wakeAll();
+			mutex.unlock();
+			wait();
+		}
+		if ( map ) {
+			file.unmap( map );
+		}
+		file.close();
+		delete (slots[0]);
+		delete (slots[1]);
+	};
+	/*! the background thread: waits for a request and decodes the batch */
+	void run() {
+		Tracer::setThreadName( "PatternStream loader" );
+		mutex.lock();
+		while( true ) {
+			while( requestSlot < 0 && !quit ) {
+				cond.wait( &mutex );
+			}
+			if ( quit ) break;
+			int slot = requestSlot;
+			u_int b = requestBatch;
+			requestSlot = -1;
+			busy = true;
+			mutex.unlock();
+			decode( slot, b );
+			mutex.lock();
+			busy = false;
+			slotReady[slot] = true;
+			cond.wakeAll();
+		}
+		mutex.unlock();
+	};
+	/*! decode the b-th batch into slot */
+	void decode( int slot, u_int b ) {
+		NNFW_PROFILE_SCOPE_IN( "PatternStream::decode", "io" );
+		u_int first = b*batch;
+		u_int count = ( first+batch > npat ) ? npat-first : batch;
+		qint64 rowbytes = (qint64)rowlen*realsize;
+		qint64 start = dataStart + first*rowbytes;
+		const char* src;
+		if ( map ) {
+			src = (const char*)( map + start );
+		} else {
+			// --- a short read, i.e. the file truncated after opening it, ends the stream
+			if ( !file.seek( start ) || file.read( &raw[0], count*rowbytes ) != count*rowbytes ) {
+				nError() << "Error reading the batch " << b << " of the pattern file; the stream ends here";
+				readError = true;
+				slotCount[slot] = 0;
+				return;
+			}
+			src = &raw[0];
+		}
+		if ( realsize == sizeof(float) ) {
+			decodeRows<float>( src, count, rowlen, blocks, slot );
+		} else {
+			decodeRows<double>( src, count, rowlen, blocks, slot );
+		}
+		slotCount[slot] = count;
+	};
+	/*! ask to the background thread to decode the b-th batch into slot */
+	void request( int slot, u_int b ) {
+		mutex.lock();
+		slotReady[slot] = false;
+		requestSlot = slot;
+		requestBatch = b;
+		cond.wakeAll();
+		mutex.unlock();
+	};
+	/*! wait until the slot is ready */
+	void waitSlot( int slot ) {
+		NNFW_PROFILE_SCOPE_IN( "PatternStream::waitSlot", "io" );
+		mutex.lock();
+		while( !slotReady[slot] ) {
+			cond.wait( &mutex );
+		}
+		mutex.unlock();
+	};
+	/*! wait until the background thread is idle */
+	void waitIdle() {
+		mutex.lock();
+		while( requestSlot >= 0 || busy ) {
+			cond.wait( &mutex );
+		}
+		mutex.unlock();
+	};
+
+	QFile file;
+	uchar* map;
+	bool valid;
+	u_int npat;
+	u_int batch;
+	u_int nbatches;
+	u_int realsize;
+	u_int rowlen;
+	qint64 dataStart;
+	std::vector<streamBlock> blocks;
+	/*! buffer for reading a batch from the file */
+	std::vector<char> raw;
+	/*! order of batches of current epoch */
+	std::vector<u_int> order;
+	/*! next batch to return */
+	u_int pos;
+	bool shuffle;
+	DataSet* slots[2];
+	u_int slotCount[2];
+	// --- shared with background thread, protected by mutex
+	bool slotReady[2];
+	int requestSlot;
+	u_int requestBatch;
+	bool busy;
+	bool quit;
+	/*! true when a batch couldn't be read from the file */
+	bool readError;
+	QMutex mutex;
+	QWaitCondition cond;
+};
+
+/*! read an u_int from file */
+static bool readUInt( QFile& file, u_int& v ) {
+	return file.read( (char*)&v, sizeof(u_int) ) == (qint64)sizeof(u_int);
+}
+
+/*! write an u_int to file */
+static bool writeUInt( QFile& file, u_int v ) {
+	return file.write( (const char*)&v, sizeof(u_int) ) == (qint64)sizeof(u_int);
+}
+
+PatternStream::PatternStream( const char* filename, BaseNeuralNet* net, u_int batchSize, bool useMap ) {
+	prv = new PatternStreamPrivate( filename );
+	if ( !prv->file.open( QIODevice::ReadOnly ) ) {
+		nError() << "PatternStream can't open the file " << filename;
+		return;
+	}
+	// --- read the header
+	char magic[8];
+	u_int version, nblocks;
+	if ( prv->file.read( magic, 8 ) != 8 || memcmp( magic, streamMagic, 8 ) != 0 ||
+		 !readUInt( prv->file, version ) || version != streamVersion ) {
+		nError() << "The file " << filename << " is not a pattern file";
+		return;
+	}
+	if ( !readUInt( prv->file, prv->realsize ) || !readUInt( prv->file, prv->npat ) || !readUInt( prv->file, nblocks ) ||
+		 ( prv->realsize != sizeof(float) && prv->realsize != sizeof(double) ) ) {
+		nError() << "Corrupted header in the file " << filename;
+		return;
+	}
+	qint64 headerSize = 8 + 4*sizeof(u_int);
+	prv->rowlen = 0;
+	for( u_int b=0; b<nblocks; b++ ) {
+		u_int isInput, dim, len;
+		if ( !readUInt( prv->file, isInput ) || !readUInt( prv->file, dim ) || !readUInt( prv->file, len ) ) {
+			nError() << "Corrupted header in the file " << filename;
+			return;
+		}
+		std::string name( len, ' ' );
+		if ( len > 0 && prv->file.read( &name[0], len ) != (qint64)len ) {
+			nError() << "Corrupted header in the file " << filename;
+			return;
+		}
+		headerSize += 3*sizeof(u_int) + len;
+		Cluster* cl = dynamic_cast<Cluster*>( net->getByName( name.c_str() ) );
+		if ( !cl || cl->numNeurons() != dim ) {
+			nError() << "The Cluster " << name.c_str() << " stored into " << filename << " doesn't exist or has different size";
+			return;
+		}
+		streamBlock sb;
+		sb.cluster = cl;
+		sb.isInput = ( isInput != 0 );
+		sb.dim = dim;
+		sb.offset = prv->rowlen;
+		prv->rowlen += dim;
+		prv->blocks.push_back( sb );
+	}
+	// --- the data starts aligned to 8 bytes
+	prv->dataStart = ( headerSize + 7 ) & ~((qint64)7);
+	if ( prv->file.size() < prv->dataStart + (qint64)prv->npat*prv->rowlen*prv->realsize ) {
+		nError() << "The file " << filename << " is truncated";
+		return;
+	}
+	if ( useMap ) {
+		prv->map = prv->file.map( 0, prv->file.size() );
+		if ( !prv->map ) {
+			nWarning() << "It's not possible to map the file " << filename << " in memory; buffered reads will be used";
+		}
+	}
+	// --- create the two batches used as double buffer
+	prv->batch = ( batchSize == 0 ) ? 1 : batchSize;
+	prv->nbatches = ( prv->npat + prv->batch - 1 ) / prv->batch;
+	if ( !prv->map ) {
+		prv->raw.resize( (size_t)prv->batch*prv->rowlen*prv->realsize );
+	}
+	for( int s=0; s<2; s++ ) {
+		prv->slots[s] = new DataSet( prv->batch );
+		for( u_int b=0; b<prv->blocks.size(); b++ ) {
+			streamBlock& sb = prv->blocks[b];
+			if ( sb.isInput ) {
+				prv->slots[s]->addInputsOf( sb.cluster );
+				sb.data[s] = &( prv->slots[s]->inputsDataOf( sb.cluster ) );
+			} else {
+				prv->slots[s]->addOutputsOf( sb.cluster );
+				sb.data[s] = &( prv->slots[s]->outputsDataOf( sb.cluster ) );
+			}
+		}
+	}
+	prv->order.resize( prv->nbatches );
+	for( u_int i=0; i<prv->nbatches; i++ ) {
+		prv->order[i] = i;
+	}
+	prv->valid = true;
+	prv->start();
+	rewind();
+}
+
+PatternStream::~PatternStream() {
+	delete prv;
+}
+
+bool PatternStream::isValid() const {
+	return prv->valid;
+}
+
+u_int PatternStream::size() const {
+	return prv->npat;
+}
+
+u_int PatternStream::batchSize() const {
+	return prv->batch;
+}
+
+u_int PatternStream::numBatches() const {
+	return prv->nbatches;
+}
+
+void PatternStream::setShuffle( bool enable ) {
+	prv->shuffle = enable;
+}
+
+void PatternStream::rewind() {
+	if ( !prv->valid ) return;
+	prv->waitIdle();
+	if ( prv->shuffle && prv->nbatches > 1 ) {
+		for( u_int i=prv->nbatches-1; i>0; i-- ) {
+			u_int j = Random::flatInt( i+1 );
+			u_int tmp = prv->order[i];
+			prv->order[i] = prv->order[j];
+			prv->order[j] = tmp;
+		}
+	}
+	prv->pos = 0;
+	prv->readError = false;
+	if ( prv->nbatches > 0 ) {
+		prv->request( 0, prv->order[0] );
+	}
+}
+
+const DataSet* PatternStream::nextBatch( u_int& count ) {
+	count = 0;
+	if ( !prv->valid || prv->pos >= prv->nbatches ) {
+		return 0;
+	}
+	int slot = prv->pos % 2;
+	prv->waitSlot( slot );
+	if ( prv->readError ) {
+		prv->pos = prv->nbatches;
+		return 0;
+	}
+	// --- the other slot is not used anymore; start to decode the following batch into it
+	if ( prv->pos+1 < prv->nbatches ) {
+		prv->request( 1-slot, prv->order[ prv->pos+1 ] );
+	}
+	prv->pos++;
+	count = prv->slotCount[slot];
+	return prv->slots[slot];
+}
+
+bool PatternStream::save( const char* filename, DataSet& set ) {
+	QFile file( filename );
+	if ( !file.open( QIODevice::WriteOnly ) ) {
+		nError() << "PatternStream can't write the file " << filename;
+		return false;
+	}
+	const ClusterVec& inscl = set.inputClusters();
+	const ClusterVec& outscl = set.outputClusters();
+	file.write( streamMagic, 8 );
+	writeUInt( file, streamVersion );
+	writeUInt( file, sizeof(Real) );
+	writeUInt( file, set.size() );
+	writeUInt( file, inscl.size() + outscl.size() );
+	qint64 headerSize = 8 + 4*sizeof(u_int);
+	VectorData<RealVec*> datas;
+	for( u_int b=0; b<inscl.size()+outscl.size(); b++ ) {
+		bool isInput = ( b < inscl.size() );
+		Cluster* cl = isInput ? inscl[b] : outscl[b-inscl.size()];
+		u_int len = strlen( cl->name() );
+		writeUInt( file, isInput ? 1 : 0 );
+		writeUInt( file, cl->numNeurons() );
+		writeUInt( file, len );
+		file.write( cl->name(), len );
+		headerSize += 3*sizeof(u_int) + len;
+		datas.append( isInput ? &( set.inputsDataOf( cl ) ) : &( set.outputsDataOf( cl ) ) );
+	}
+	const char pad[8] = { 0, 0, 0, 0, 0, 0, 0, 0 };
+	file.write( pad, ( ( headerSize + 7 ) & ~((qint64)7) ) - headerSize );
+	bool ok = true;
+	std::vector<Real> rowbuf;
+	for( u_int i=0; i<set.size() && ok; i++ ) {
+		rowbuf.clear();
+		for( u_int b=0; b<datas.size(); b++ ) {
+			const RealVec& data = *( datas[b] );
+			const u_int n = data.size() / set.size();
+			for( u_int k=i*n; k<(i+1)*n; k++ ) {
+				rowbuf.push_back( data[k] );
+			}
+		}
+		qint64 bytes = rowbuf.size()*sizeof(Real);
+		ok = ( bytes == 0 ) || ( file.write( (const char*)&rowbuf[0], bytes ) == bytes );
+	}
+	file.close();
+	if ( !ok ) {
+		nError() << "Error writing the file " << filename;
+	}
+	return ok;
+}
+
+}
@@ -0,0 +1,301 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "population.h"
+#include "cluster.h"
+#include "biasedcluster.h"
+#include "matrixlinker.h"
+#include "outputfunction.h"
+#include "random.h"
+#include <string>
+
+namespace nnfw {
+
+Population::Population( BaseNeuralNet* net, u_int size )
+	: tnet(net), popsize(size), glength(0), valid(true), cls(), lks(), ord(), clsIndex(), lksIndex() {
+	// --- Clusters
+	const ClusterVec& cv = net->clusters();
+	for( u_int i=0; i<cv.size(); i++ ) {
+		Cluster* cl = cv[i];
+		std::string type( cl->getTypename().getString() );
+		u_int n = cl->numNeurons();
+		cluster_block cb;
+		cb.cluster = cl;
+		cb.isBiased = ( type == "BiasedCluster" );
+		cb.isFake = ( type == "FakeCluster" );
+		if ( !cb.isBiased && !cb.isFake && type != "SimpleCluster" ) {
+			nError() << "Population doesn't support Cluster of type " << type.c_str() << "; the Population will not be evaluated";
+			valid = false;
+		}
+		cb.needReset = false;
+		cb.inputs = new RealMat( popsize, n );
+		// --- FakeCluster's outputs are the same data of its inputs
+		cb.outputs = ( cb.isFake ) ? cb.inputs : new RealMat( popsize, n );
+		cb.temp = 0;
+		cb.params = 0;
+		cb.offset = 0;
+		if ( cb.isBiased ) {
+			BiasedCluster* bcl = (BiasedCluster*)cl;
+			cb.temp = new RealMat( popsize, n );
+			cb.params = new RealMat( popsize, n );
+			cb.offset = glength;
+			glength += n;
+			for( u_int b=0; b<popsize; b++ ) {
+				(*(cb.params))[b].assign( bcl->biases() );
+			}
+		}
+		for( u_int b=0; b<popsize; b++ ) {
+			(*(cb.inputs))[b].assign( cl->inputs() );
+			if ( !cb.isFake ) {
+				(*(cb.outputs))[b].assign( cl->outputs() );
+			}
+			OutputFunction* f = cl->getFunction()->clone();
+			f->setCluster( cl );
+			cb.functions.append( f );
+		}
+		clsIndex[cl] = cls.size();
+		cls.append( cb );
+	}
+	// --- Linkers
+	const LinkerVec& lv = net->linkers();
+	for( u_int i=0; i<lv.size(); i++ ) {
+		Linker* l = lv[i];
+		std::string type( l->getTypename().getString() );
+		linker_block lb;
+		lb.linker = 0;
+		lb.params = 0;
+		lb.offset = 0;
+		lb.from = clsIndex.count( l->from() ) ? clsIndex[ l->from() ] : -1;
+		lb.to = clsIndex.count( l->to() ) ? clsIndex[ l->to() ] : -1;
+		if ( type != "DotLinker" || lb.from == -1 || lb.to == -1 ) {
+			nError() << "Population doesn't support Linker of type " << type.c_str() << "; the Population will not be evaluated";
+			valid = false;
+		} else {
+			MatrixLinker* ml = (MatrixLinker*)l;
+			u_int rows = ml->rows();
+			u_int cols = ml->cols();
+			lb.linker = ml;
+			lb.params = new RealMat( popsize, rows*cols );
+			lb.offset = glength;
+			glength += rows*cols;
+			const RealMat& w = ml->matrix();
+			for( u_int b=0; b<popsize; b++ ) {
+				RealVec& row = (*(lb.params))[b];
+				for( u_int r=0; r<rows; r++ ) {
+					for( u_int c=0; c<cols; c++ ) {
+						row[r*cols+c] = w[r][c];
+					}
+				}
+			}
+		}
+		lksIndex[l] = lks.size();
+		lks.append( lb );
+	}
+	// --- Update order
+	const UpdatableVec& uv = net->order();
+	for( u_int i=0; i<uv.size(); i++ ) {
+		order_entry oe;
+		Cluster* cl = dynamic_cast<Cluster*>( uv[i] );
+		Linker* l = dynamic_cast<Linker*>( uv[i] );
+		if ( cl && clsIndex.count( cl ) ) {
+			oe.isCluster = true;
+			oe.index = clsIndex[cl];
+		} else if ( l && lksIndex.count( l ) ) {
+			oe.isCluster = false;
+			oe.index = lksIndex[l];
+		} else {
+			nError() << "The Updatable " << uv[i]->name() << " in the update order doesn't belong to the net";
+			valid = false;
+			continue;
+		}
+		ord.append( oe );
+	}
+}
+
+Population::~Population() {
+	for( u_int i=0; i<cls.size(); i++ ) {
+		if ( cls[i].outputs != cls[i].inputs ) {
+			delete (cls[i].outputs);
+		}
+		delete (cls[i].inputs);
+		delete (cls[i].temp);
+		delete (cls[i].params);
+		for( u_int b=0; b<cls[i].functions.size(); b++ ) {
+			delete (cls[i].functions[b]);
+		}
+	}
+	for( u_int i=0; i<lks.size(); i++ ) {
+		delete (lks[i].params);
+	}
+}
+
+void Population::getGenome( u_int i, RealVec& genome ) const {
+#ifdef NNFW_DEBUG
+	if ( i >= popsize || genome.size() != glength ) {
+		nError() << "Wrong individual or genome length; getGenome will be ignored";
+		return;
+	}
+#endif
+	for( u_int k=0; k<cls.size(); k++ ) {
+		if ( !cls[k].params ) continue;
+		const RealVec& row = (*(cls[k].params))[i];
+		for( u_int j=0; j<row.size(); j++ ) {
+			genome[ cls[k].offset+j ] = row[j];
+		}
+	}
+	for( u_int k=0; k<lks.size(); k++ ) {
+		if ( !lks[k].params ) continue;
+		const RealVec& row = (*(lks[k].params))[i];
+		for( u_int j=0; j<row.size(); j++ ) {
+			genome[ lks[k].offset+j ] = row[j];
+		}
+	}
+}
+
+void Population::setGenome( u_int i, const RealVec& genome ) {
+#ifdef NNFW_DEBUG
+	if ( i >= popsize || genome.size() != glength ) {
+		nError() << "Wrong individual or genome length; setGenome will be ignored";
+		return;
+	}
+#endif
+	for( u_int k=0; k<cls.size(); k++ ) {
+		if ( !cls[k].params ) continue;
+		RealVec& row = (*(cls[k].params))[i];
+		for( u_int j=0; j<row.size(); j++ ) {
+			row[j] = genome[ cls[k].offset+j ];
+		}
+	}
+	for( u_int k=0; k<lks.size(); k++ ) {
+		if ( !lks[k].params ) continue;
+		RealVec& row = (*(lks[k].params))[i];
+		for( u_int j=0; j<row.size(); j++ ) {
+			row[j] = genome[ lks[k].offset+j ];
+		}
+	}
+}
+
+void Population::getGenomes( RealMat& genomes ) const {
+	for( u_int b=0; b<popsize; b++ ) {
+		getGenome( b, genomes[b] );
+	}
+}
+
+void Population::setGenomes( const RealMat& genomes ) {
+	for( u_int b=0; b<popsize; b++ ) {
+		setGenome( b, genomes[b] );
+	}
+}
+
+void Population::exportGenome( u_int i ) {
+	for( u_int k=0; k<cls.size(); k++ ) {
+		if ( !cls[k].params ) continue;
+		((BiasedCluster*)(cls[k].cluster))->setBiases( (*(cls[k].params))[i] );
+	}
+	for( u_int k=0; k<lks.size(); k++ ) {
+		if ( !lks[k].params ) continue;
+		const RealVec& row = (*(lks[k].params))[i];
+		RealMat& w = lks[k].linker->matrix();
+		u_int cols = w.cols();
+		for( u_int r=0; r<w.rows(); r++ ) {
+			for( u_int c=0; c<cols; c++ ) {
+				w[r][c] = row[r*cols+c];
+			}
+		}
+		lks[k].linker->weightsChanged();
+	}
+}
+
+void Population::randomize( Real min, Real max ) {
+	for( u_int k=0; k<cls.size(); k++ ) {
+		if ( !cls[k].params ) continue;
+		Random::flatRealMat( *(cls[k].params), min, max );
+	}
+	for( u_int k=0; k<lks.size(); k++ ) {
+		if ( !lks[k].params ) continue;
+		Random::flatRealMat( *(lks[k].params), min, max );
+	}
+}
+
+RealMat& Population::inputs( Cluster* cl ) {
+	return *( cls[ clsIndex[cl] ].inputs );
+}
+
+RealMat& Population::outputs( Cluster* cl ) {
+	return *( cls[ clsIndex[cl] ].outputs );
+}
+
+void Population::setInputs( Cluster* cl, const RealVec& in ) {
+	cluster_block& cb = cls[ clsIndex[cl] ];
+	for( u_int b=0; b<popsize; b++ ) {
+		(*(cb.inputs))[b].assign( in );
+	}
+	cb.needReset = false;
+}
+
+RealMat* Population::parameters( Updatable* up ) {
+	Cluster* cl = dynamic_cast<Cluster*>( up );
+	if ( cl && clsIndex.count( cl ) ) {
+		return cls[ clsIndex[cl] ].params;
+	}
+	Linker* l = dynamic_cast<Linker*>( up );
+	if ( l && lksIndex.count( l ) ) {
+		return lks[ lksIndex[l] ].params;
+	}
+	return 0;
+}
+
+void Population::step() {
+	if ( !valid ) return;
+	for( u_int i=0; i<ord.size(); i++ ) {
+		if ( ord[i].isCluster ) {
+			updateCluster( cls[ ord[i].index ] );
+		} else {
+			updateLinker( lks[ ord[i].index ] );
+		}
+	}
+}
+
+void Population::updateCluster( cluster_block& cb ) {
+	if ( !cb.isFake ) {
+		RealMat& ins = *(cb.isBiased ? cb.temp : cb.inputs);
+		if ( cb.isBiased ) {
+			// --- all individuals at once: temp = inputs - biases
+			cb.temp->assign( *(cb.inputs) );
+			*(cb.temp) -= *(cb.params);
+		}
+		RealMat& outs = *(cb.outputs);
+		for( u_int b=0; b<popsize; b++ ) {
+			cb.functions[b]->apply( ins[b], outs[b] );
+		}
+	}
+	cb.needReset = !( cb.cluster->isAccumulate() );
+}
+
+void Population::updateLinker( linker_block& lb ) {
+	cluster_block& to = cls[ lb.to ];
+	if ( to.needReset ) {
+		to.inputs->zeroing();
+		to.needReset = false;
+	}
+	RealMat::batchMul( *(to.inputs), *(cls[ lb.from ].outputs), *(lb.params),
+						lb.linker->rows(), lb.linker->cols() );
+}
+
+}
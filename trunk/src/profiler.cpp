@@ -0,0 +1,207 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "profiler.h"
+#include "updatable.h"
+#include "random.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <map>
+#include <algorithm>
+#include <cstdio>
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <time.h>
+#endif
+
+namespace nnfw {
+
+/*! the measures collected, protected by profMutex */
+static QMutex profMutex;
+static std::map<const Updatable*, Profiler::Entry> profUpdatables;
+static std::map<std::string, Profiler::Entry> profLabels;
+static double profPeakFlops = 0.0;
+static double profPeakBytes = 0.0;
+static volatile bool profCollecting = true;
+
+static Profiler::Entry newEntry( const Updatable* u, const std::string& name, const std::string& type ) {
+	Profiler::Entry e;
+	e.updatable = u;
+	e.name = name;
+	e.type = type;
+	e.calls = 0;
+	e.total = 0.0;
+	e.max = 0.0;
+	e.flops = 0.0;
+	e.bytes = 0.0;
+	return e;
+}
+
+static void addCall( Profiler::Entry& e, double seconds ) {
+	e.calls++;
+	e.total += seconds;
+	if ( seconds > e.max ) e.max = seconds;
+}
+
+static bool byTotal( const Profiler::Entry& a, const Profiler::Entry& b ) {
+	return a.total > b.total;
+}
+
+bool Profiler::isEnabled() {
+#ifdef NNFW_PROFILE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Profiler::reset() {
+	QMutexLocker lock( &profMutex );
+	profUpdatables.clear();
+	profLabels.clear();
+}
+
+void Profiler::setCollecting( bool collecting ) {
+	profCollecting = collecting;
+}
+
+bool Profiler::isCollecting() {
+	return profCollecting;
+}
+
+void Profiler::record( const Updatable* u, double seconds ) {
+	if ( !profCollecting ) return;
+	double flops, bytes;
+	u->updateCost( flops, bytes );
+	QMutexLocker lock( &profMutex );
+	std::map<const Updatable*, Entry>::iterator it = profUpdatables.find( u );
+	if ( it == profUpdatables.end() ) {
+		it = profUpdatables.insert( std::make_pair( u, newEntry( u, u->name(), u->getTypename().getString() ) ) ).first;
+	}
+	addCall( it->second, seconds );
+	it->second.flops += flops;
+	it->second.bytes += bytes;
+}
+
+void Profiler::record( const char* label, double seconds ) {
+	if ( !profCollecting ) return;
+	QMutexLocker lock( &profMutex );
+	std::map<std::string, Entry>::iterator it = profLabels.find( label );
+	if ( it == profLabels.end() ) {
+		it = profLabels.insert( std::make_pair( std::string( label ), newEntry( 0, label, "" ) ) ).first;
+	}
+	addCall( it->second, seconds );
+}
+
+std::vector<Profiler::Entry> Profiler::entries() {
+	QMutexLocker lock( &profMutex );
+	std::vector<Entry> all;
+	for( std::map<const Updatable*, Entry>::iterator it = profUpdatables.begin(); it != profUpdatables.end(); it++ ) {
+		all.push_back( it->second );
+	}
+	for( std::map<std::string, Entry>::iterator it = profLabels.begin(); it != profLabels.end(); it++ ) {
+		all.push_back( it->second );
+	}
+	std::stable_sort( all.begin(), all.end(), byTotal );
+	return all;
+}
+
+void Profiler::measurePeak() {
+	// --- arithmetic: a matrix-vector product fitting in cache
+	const u_int n = 256;
+	RealMat m( n, n );
+	RealVec x( n ), y( n );
+	// --- a private stream, so measuring doesn't change the numbers generated by Random
+	RandomStream rnd( 1 );
+	rnd.flatRealMat( m, -1.0, 1.0 );
+	rnd.flatRealVec( x, -1.0, 1.0 );
+	u_int iters = 0;
+	double start = now();
+	double elapsed = 0.0;
+	while( elapsed < 0.2 ) {
+		for( u_int i=0; i<16; i++ ) {
+			y.zeroing();
+			RealMat::mul( y, x, m );
+		}
+		iters += 16;
+		elapsed = now() - start;
+	}
+	profPeakFlops = 2.0*n*n*iters/elapsed;
+	// --- memory: a copy of vectors much larger than the caches
+	const u_int size = 1 << 23;
+	RealVec a( size, 1.0 ), b( size );
+	iters = 0;
+	start = now();
+	elapsed = 0.0;
+	while( elapsed < 0.2 ) {
+		b.assign( a );
+		iters++;
+		elapsed = now() - start;
+	}
+	profPeakBytes = 2.0*size*sizeof(Real)*iters/elapsed;
+}
+
+double Profiler::peakGFlops() {
+	return profPeakFlops*1e-9;
+}
+
+double Profiler::peakBandwidth() {
+	return profPeakBytes*1e-9;
+}
+
+void Profiler::report() {
+	std::vector<Entry> all = entries();
+	printf( "%-24s %-22s %10s %12s %12s %12s %9s %6s %9s %6s\n", "name", "type", "calls",
+	        "total ms", "mean us", "max us", "GFLOP/s", "%peak", "GB/s", "%peak" );
+	for( u_int i=0; i<all.size(); i++ ) {
+		const Entry& e = all[i];
+		double mean = ( e.calls > 0 ) ? e.total/e.calls : 0.0;
+		printf( "%-24s %-22s %10lu %12.3f %12.3f %12.3f", e.name.c_str(), e.type.c_str(), e.calls,
+		        e.total*1e3, mean*1e6, e.max*1e6 );
+		if ( e.updatable && e.total > 0.0 ) {
+			double gflops = e.flops/e.total*1e-9;
+			double gbytes = e.bytes/e.total*1e-9;
+			printf( " %9.3f", gflops );
+			if ( profPeakFlops > 0.0 ) printf( " %6.1f", 100.0*gflops/peakGFlops() ); else printf( " %6s", "-" );
+			printf( " %9.3f", gbytes );
+			if ( profPeakBytes > 0.0 ) printf( " %6.1f", 100.0*gbytes/peakBandwidth() ); else printf( " %6s", "-" );
+		}
+		printf( "\n" );
+	}
+	if ( profPeakFlops > 0.0 ) {
+		printf( "peak: %.3f GFLOP/s, %.3f GB/s\n", peakGFlops(), peakBandwidth() );
+	}
+}
+
+double Profiler::now() {
+#ifdef WIN32
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceFrequency( &frequency );
+	QueryPerformanceCounter( &count );
+	return (double)count.QuadPart / (double)frequency.QuadPart;
+#else
+	struct timespec ts;
+	clock_gettime( CLOCK_MONOTONIC, &ts );
+	return ts.tv_sec + ts.tv_nsec*1e-9;
+#endif
+}
+
+}
@@ -19,6 +19,10 @@
 
 #include "propertized.h"
 #include <QString>
+#include <QMutex>
+#include <QMutexLocker>
+#include <set>
+#include <cstring>
 
 
 namespace nnfw {
@@ -258,20 +262,67 @@ void Variant::checkType( types t ) const {
 }
 
 
+PropertyKey::PropertyKey( const char* name ) {
+    // --- the keys may be created by any thread constructing a Propertized or looking up a property
+    static QMutex poolMutex;
+    static std::set<std::string> pool;
+    QMutexLocker lock( &poolMutex );
+    key = pool.insert( std::string(name) ).first->c_str();
+}
+
+PropertyTable::PropertyTable()
+    : props(), children() {
+}
+
+PropertyTable* PropertyTable::root() {
+    static PropertyTable* rootTable = new PropertyTable();
+    return rootTable;
+}
+
+PropertyTable* PropertyTable::extend( const AbstractPropertyAccess& access ) {
+    for( u_int i=0; i<children.size(); i++ ) {
+        PropertyAccessVec& cp = children[i]->props;
+        if ( cp[cp.size()-1]->sameAs( access ) ) {
+            return children[i];
+        }
+    }
+    PropertyTable* child = new PropertyTable();
+    child->props.resize( props.size() );
+    child->props.assign( props );
+    AbstractPropertyAccess* newacc = access.clone();
+    newacc->namep = PropertyKey( access.name() ).name();
+    child->props.append( newacc );
+    children.append( child );
+    return child;
+}
+
+AbstractPropertyAccess* PropertyTable::search( const char* name ) const {
+    for( int i=props.size()-1; i>=0; i-- ) {
+        if ( strcmp( props[i]->name(), name ) == 0 ) {
+            return props[i];
+        }
+    }
+    return 0;
+}
+
+AbstractPropertyAccess* PropertyTable::search( const PropertyKey& key ) const {
+    for( int i=props.size()-1; i>=0; i-- ) {
+        if ( props[i]->name() == key.name() ) {
+            return props[i];
+        }
+    }
+    return 0;
+}
+
 Propertized::Propertized()
-    : props(), vecProps(0) {
+    : ptable( PropertyTable::root() ) {
     vtypename = 0;
-    setTypename( "Propertized" );
+    static const PropertyKey typeKey( "Propertized" );
+    setTypename( typeKey );
     addProperty( "typename", Variant::t_string, this, &Propertized::getTypename );
 }
 
 Propertized::~Propertized() {
-    props.clear();
-    for( u_int i=0; i<vecProps.size(); i++ ) {
-        delete (vecProps[i]);
-    }
-    vecProps.clear();
-    delete []vtypename;
 }
 
 void Propertized::setProperties( PropertySettings& prop ) {
@@ -282,13 +333,12 @@ void Propertized::setProperties( PropertySettings& prop ) {
     }
 }
 
+void Propertized::setTypename( const PropertyKey& type ) {
+    vtypename = type.name();
+}
+
 void Propertized::setTypename( const char* type ) {
-    if (vtypename) {
-        delete []vtypename;
-    }
-    u_int size = strlen(type);
-    vtypename = new char[size+1];
-    strcpy( vtypename, type );
+    vtypename = PropertyKey( type ).name();
 }
 
 Variant Propertized::convertStringTo( const Variant& str, Variant::types t ) {
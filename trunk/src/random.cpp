@@ -18,6 +18,7 @@
  ********************************************************************************/
 
 #include "random.h"
+#include <QThread>
 #include <cmath>
 
 #ifdef NNFW_USE_GSL
@@ -32,15 +33,294 @@ namespace nnfw {
 NNFW_INTERNAL gsl_rng* rnd = gsl_rng_alloc( gsl_rng_taus2 );
 #endif
 
+/*! the generator used by the bulk methods of Random */
+NNFW_INTERNAL RandomStream globalStream;
+/*! threads used for filling large matrices; zero means the number of processors */
+NNFW_INTERNAL u_int fillThreads = 0;
+/*! matrices with less elements are filled by the calling thread */
+static const u_int parallelFillSize = 1 << 16;
+
+/*! 2^-32, maps a 32-bit value into [0;1) */
+static const double wordScale = 1.0/4294967296.0;
+static const double twoPi = 6.28318530717958647692;
+
+/*! 32x32 bit product split into the high and low words */
+static inline void mulhilo( u_int a, u_int b, u_int& hi, u_int& lo ) {
+	quint64 p = (quint64)a * (quint64)b;
+	hi = (u_int)( p >> 32 );
+	lo = (u_int)p;
+}
+
+/*! Philox4x32 with ten rounds */
+static inline void philox( const u_int key[2], const u_int ctr[4], u_int out[4] ) {
+	u_int k0 = key[0];
+	u_int k1 = key[1];
+	u_int c0 = ctr[0], c1 = ctr[1], c2 = ctr[2], c3 = ctr[3];
+	for( int r=0; r<10; r++ ) {
+		u_int hi0, lo0, hi1, lo1;
+		mulhilo( 0xD2511F53u, c0, hi0, lo0 );
+		mulhilo( 0xCD9E8D57u, c2, hi1, lo1 );
+		c0 = hi1 ^ c1 ^ k0;
+		c1 = lo1;
+		c2 = hi0 ^ c3 ^ k1;
+		c3 = lo0;
+		k0 += 0x9E3779B9u;
+		k1 += 0xBB67AE85u;
+	}
+	out[0] = c0;
+	out[1] = c1;
+	out[2] = c2;
+	out[3] = c3;
+}
+
+/*! the four values of a block of a bulk method */
+class flatDist {
+public:
+	flatDist( Real min, Real max ) : min(min), range(max-min) { };
+	void operator()( const u_int w[4], Real v[4] ) const {
+		for( int k=0; k<4; k++ ) {
+			v[k] = min + range*(Real)( w[k]*wordScale );
+		}
+	};
+	Real min;
+	Real range;
+};
+
+class gaussDist {
+public:
+	gaussDist( Real mean, Real stdev ) : mean(mean), stdev(stdev) { };
+	void operator()( const u_int w[4], Real v[4] ) const {
+		// --- Box-Muller transform of two pairs of values
+		for( int k=0; k<4; k+=2 ) {
+			double r = std::sqrt( -2.0*std::log( ( w[k]+0.5 )*wordScale ) );
+			double a = twoPi*( w[k+1]*wordScale );
+			v[k] = mean + stdev*(Real)( r*std::cos( a ) );
+			v[k+1] = mean + stdev*(Real)( r*std::sin( a ) );
+		}
+	};
+	Real mean;
+	Real stdev;
+};
+
+class boolDist {
+public:
+	boolDist( Real trueProb ) : prob(trueProb) { };
+	void operator()( const u_int w[4], bool v[4] ) const {
+		for( int k=0; k<4; k++ ) {
+			v[k] = ( w[k]*wordScale < prob );
+		}
+	};
+	double prob;
+};
+
+/*! fill the rows from r0 to r1 (excluded) of mat; element (r,c) takes its value from the
+ *  block (r*cols+c)/4 after the position of s; a vector is filled as the single row of a matrix */
+template<class T, class Dist, class Mat>
+static void fillRows( const RandomStream& s, const Dist& dist, Mat& mat, u_int cols, u_int r0, u_int r1 ) {
+	u_int w[4];
+	T v[4];
+	u_int cur = 0;
+	bool valid = false;
+	for( u_int r=r0; r<r1; r++ ) {
+		for( u_int c=0; c<cols; c++ ) {
+			u_int e = r*cols + c;
+			if ( !valid || e/4 != cur ) {
+				cur = e/4;
+				s.block( cur, w );
+				dist( w, v );
+				valid = true;
+			}
+			mat[r][c] = v[e%4];
+		}
+	}
+}
+
+/*! a thread filling a range of rows */
+template<class T, class Dist, class Mat>
+class fillWorker : public QThread {
+public:
+	fillWorker( const RandomStream& s, const Dist& d, Mat& m, u_int r0, u_int r1 )
+		: s(s), dist(d), mat(m), r0(r0), r1(r1) { };
+	~fillWorker() {
+		wait();
+	};
+	const RandomStream& s;
+	const Dist& dist;
+	Mat& mat;
+	u_int r0;
+	u_int r1;
+protected:
+	void run() {
+		fillRows<T>( s, dist, mat, mat.cols(), r0, r1 );
+	};
+};
+
+/*! fill mat splitting its rows among threads, then skip the blocks used */
+template<class T, class Dist, class Mat>
+static void fillMat( RandomStream& s, const Dist& dist, Mat& mat ) {
+	const u_int rows = mat.rows();
+	const u_int cols = mat.cols();
+	u_int nt = Random::numThreads();
+	if ( rows*cols < parallelFillSize || nt < 2 || rows < 2 ) {
+		nt = 1;
+	} else if ( nt > rows ) {
+		nt = rows;
+	}
+	std::vector< fillWorker<T,Dist,Mat>* > workers;
+	for( u_int i=1; i<nt; i++ ) {
+		workers.push_back( new fillWorker<T,Dist,Mat>( s, dist, mat, ( rows*i )/nt, ( rows*(i+1) )/nt ) );
+		workers.back()->start();
+	}
+	// --- the first range is filled by the calling thread
+	fillRows<T>( s, dist, mat, cols, 0, rows/nt );
+	for( u_int i=0; i<workers.size(); i++ ) {
+		delete workers[i];
+	}
+	s.skip( rows*cols );
+}
+
+RandomStream::RandomStream( unsigned long seed, unsigned long stream ) {
+	setSeed( seed, stream );
+}
+
+void RandomStream::setSeed( unsigned long seed, unsigned long stream ) {
+	seedv = seed;
+	streamv = stream;
+	// --- the shifts are split, because unsigned long may be 32 bits wide
+	key[0] = (u_int)( seed & 0xFFFFFFFFul );
+	key[1] = (u_int)( ( ( seed >> 16 ) >> 16 ) & 0xFFFFFFFFul );
+	ctr[0] = 0;
+	ctr[1] = 0;
+	ctr[2] = (u_int)( stream & 0xFFFFFFFFul );
+	ctr[3] = (u_int)( ( ( stream >> 16 ) >> 16 ) & 0xFFFFFFFFul );
+	used = 4;
+	hasSpare = false;
+	spare = 0.0;
+}
+
+void RandomStream::advance( u_int n ) {
+	u_int lo = ctr[0] + n;
+	if ( lo < ctr[0] ) {
+		ctr[1]++;
+	}
+	ctr[0] = lo;
+}
+
+void RandomStream::skip( u_int n ) {
+	advance( n/4 + ( n%4 != 0 ? 1 : 0 ) );
+	// --- the values left by the scalar methods are discarded
+	used = 4;
+	hasSpare = false;
+}
+
+void RandomStream::block( u_int n, u_int words[4] ) const {
+	u_int c[4] = { ctr[0] + n, ctr[1], ctr[2], ctr[3] };
+	if ( c[0] < ctr[0] ) {
+		c[1]++;
+	}
+	philox( key, c, words );
+}
+
+u_int RandomStream::nextWord() {
+	if ( used == 4 ) {
+		philox( key, ctr, buffer );
+		advance( 1 );
+		used = 0;
+	}
+	return buffer[used++];
+}
+
+Real RandomStream::flatReal() {
+	return (Real)( nextWord()*wordScale );
+}
+
+Real RandomStream::flatReal( Real min, Real max ) {
+	return min + ( max-min )*flatReal();
+}
+
+bool RandomStream::boolean( Real trueProb ) {
+	return ( nextWord()*wordScale < trueProb );
+}
+
+u_int RandomStream::flatInt( u_int x ) {
+	if ( x == 0 ) return 0;
+	return (u_int)( nextWord()*wordScale*x );
+}
+
+Real RandomStream::gauss( Real mean, Real stdev ) {
+	if ( hasSpare ) {
+		hasSpare = false;
+		return mean + stdev*spare;
+	}
+	double r = std::sqrt( -2.0*std::log( ( nextWord()+0.5 )*wordScale ) );
+	double a = twoPi*( nextWord()*wordScale );
+	spare = (Real)( r*std::sin( a ) );
+	hasSpare = true;
+	return mean + stdev*(Real)( r*std::cos( a ) );
+}
+
+RealVec& RandomStream::flatRealVec( RealVec& vec, Real min, Real max ) {
+	RealVec* row = &vec;
+	fillRows<Real>( *this, flatDist( min, max ), row, vec.size(), 0, 1 );
+	skip( vec.size() );
+	return vec;
+}
+
+RealMat& RandomStream::flatRealMat( RealMat& mat, Real min, Real max ) {
+	fillMat<Real>( *this, flatDist( min, max ), mat );
+	return mat;
+}
+
+RealVec& RandomStream::gaussRealVec( RealVec& vec, Real mean, Real stdev ) {
+	RealVec* row = &vec;
+	fillRows<Real>( *this, gaussDist( mean, stdev ), row, vec.size(), 0, 1 );
+	skip( vec.size() );
+	return vec;
+}
+
+RealMat& RandomStream::gaussRealMat( RealMat& mat, Real mean, Real stdev ) {
+	fillMat<Real>( *this, gaussDist( mean, stdev ), mat );
+	return mat;
+}
+
+BoolVec& RandomStream::booleanVec( BoolVec& vec, Real trueProb ) {
+	BoolVec* row = &vec;
+	fillRows<bool>( *this, boolDist( trueProb ), row, vec.size(), 0, 1 );
+	skip( vec.size() );
+	return vec;
+}
+
+MatrixData<bool>& RandomStream::booleanMat( MatrixData<bool>& mat, Real trueProb ) {
+	fillMat<bool>( *this, boolDist( trueProb ), mat );
+	return mat;
+}
+
 void Random::setSeed( long int seed ) {
 #ifdef NNFW_USE_GSL
     gsl_rng_set( rnd, seed );
 #else
     srand( seed );
 #endif
+    globalStream.setSeed( (unsigned long)seed );
     return;
 }
 
+RandomStream& Random::stream() {
+	return globalStream;
+}
+
+void Random::setNumThreads( u_int n ) {
+	fillThreads = n;
+}
+
+u_int Random::numThreads() {
+	if ( fillThreads == 0 ) {
+		int ideal = QThread::idealThreadCount();
+		return ( ideal > 0 ) ? (u_int)ideal : 1;
+	}
+	return fillThreads;
+}
+
 Real Random::flatReal( ) {
 #ifdef NNFW_USE_GSL
     return (Real)( gsl_rng_uniform( rnd ) );
@@ -58,19 +338,19 @@ Real Random::flatReal( Real min, Real max ) {
 }
 
 RealVec& Random::flatRealVec( RealVec& vec, Real min, Real max ) {
-	for( u_int i=0; i<vec.size(); i++ ) {
-		vec[i] = flatReal( min, max );
-	}
-	return vec;
+	return globalStream.flatRealVec( vec, min, max );
 }
 
 RealMat& Random::flatRealMat( RealMat& mat, Real min, Real max ) {
-	for( u_int row_nr=0; row_nr<mat.rows(); row_nr++ ) {
-		for( u_int col_nr=0; col_nr<mat.cols(); col_nr++ ) {
-			mat[row_nr][col_nr] = flatReal( min, max );
-		}
-	}
-	return mat;
+	return globalStream.flatRealMat( mat, min, max );
+}
+
+RealMat& Random::gaussRealMat( RealMat& mat, Real mean, Real stdev ) {
+	return globalStream.gaussRealMat( mat, mean, stdev );
+}
+
+MatrixData<bool>& Random::booleanMat( MatrixData<bool>& mat, Real trueProb ) {
+	return globalStream.booleanMat( mat, trueProb );
 }
 
 bool Random::boolean( ) {
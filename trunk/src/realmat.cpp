@@ -85,6 +85,42 @@ RealVec& RealMat::mul( RealVec& y, const RealMat& m, const RealVec& x ) {
     return y;
 }
 
+RealMat& RealMat::batchMul( RealMat& y, const RealMat& x, const RealMat& m, u_int rows, u_int cols ) {
+#ifdef NNFW_DEBUG
+    if ( m.cols() != rows*cols || y.rows() != m.rows() || y.cols() != cols ||
+         x.cols() != rows || ( x.rows() != 1 && x.rows() != m.rows() ) ) {
+        nError() << "Wrong dimensions in batchMul";
+        return y;
+    }
+#endif
+    const u_int stride = rows*cols;
+    const u_int xstride = ( x.rows() == 1 ) ? 0 : rows;
+    Real* mRaw = m.rawdata().rawdata();
+    Real* xRaw = x.rawdata().rawdata();
+    Real* yRaw = y.rawdata().rawdata();
+    for( u_int b = 0; b<m.rows(); b++ ) {
+        const Real* mb = mRaw + b*stride;
+        const Real* xb = xRaw + b*xstride;
+        Real* yb = yRaw + b*cols;
+#ifdef NNFW_USE_MKL
+#ifndef NNFW_DOUBLE_PRECISION
+        cblas_sgemv(CblasRowMajor, CblasTrans, rows, cols, 1.0, mb, cols, xb, 1, 1.0f, yb, 1);
+#else
+        cblas_dgemv(CblasRowMajor, CblasTrans, rows, cols, 1.0, mb, cols, xb, 1, 1.0, yb, 1);
+#endif
+#else
+        for ( u_int j = 0; j<rows; j++ ) {
+            const Real xj = xb[j];
+            const Real* mrow = mb + j*cols;
+            for ( u_int i = 0; i<cols; i++ ) {
+                yb[i] += xj * mrow[i];
+            }
+        }
+#endif
+    }
+    return y;
+}
+
 RealMat& RealMat::deltarule( Real rate, const RealVec& x, const RealVec& y ) {
 #ifdef NNFW_USE_MKL
     Real* mRaw = rawdata().rawdata();
@@ -109,6 +145,79 @@ RealMat& RealMat::deltarule( Real rate, const RealVec& x, const RealVec& y ) {
 #endif
 }
 
+RealMat& RealMat::mul( RealMat& y, Real rate, const RealMat& x, const RealMat& m, u_int count ) {
+#ifdef NNFW_DEBUG
+    if ( x.cols() != m.rows() || y.cols() != m.cols() || x.rows() < count || y.rows() < count ) {
+        nError() << "Wrong dimensions in mul";
+        return y;
+    }
+#endif
+    if ( count == 0 ) return y;
+#ifdef NNFW_USE_MKL
+    Real* mRaw = m.rawdata().rawdata();
+    Real* xRaw = x.rawdata().rawdata();
+    Real* yRaw = y.rawdata().rawdata();
+#ifndef NNFW_DOUBLE_PRECISION
+    cblas_sgemm( CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                count, m.cols(), m.rows(), rate, xRaw, x.cols(), mRaw, m.cols(), 1.0f, yRaw, y.cols() );
+#else
+    cblas_dgemm( CblasRowMajor, CblasNoTrans, CblasNoTrans,
+                count, m.cols(), m.rows(), rate, xRaw, x.cols(), mRaw, m.cols(), 1.0, yRaw, y.cols() );
+#endif
+#else
+	for ( u_int k=0; k<count; k++ ) {
+		const RealVec& xk = x[k];
+		RealVec& yk = y[k];
+		for ( u_int r=0; r<m.rows(); r++ ) {
+			const Real rx = rate * xk[r];
+			if ( rx == 0.0 ) continue;
+			const RealVec& mr = m[r];
+			for ( u_int c=0; c<m.cols(); c++ ) {
+				yk[c] += rx * mr[c];
+			}
+		}
+	}
+#endif
+	return y;
+}
+
+RealMat& RealMat::batchDeltarule( Real rate, const RealMat& x, const RealMat& y, u_int count ) {
+#ifdef NNFW_DEBUG
+    if ( x.cols() != rows() || y.cols() != cols() || x.rows() < count || y.rows() < count ) {
+        nError() << "Wrong dimensions in batchDeltarule";
+        return (*this);
+    }
+#endif
+    if ( count == 0 ) return (*this);
+#ifdef NNFW_USE_MKL
+    Real* mRaw = rawdata().rawdata();
+    Real* xRaw = x.rawdata().rawdata();
+    Real* yRaw = y.rawdata().rawdata();
+#ifndef NNFW_DOUBLE_PRECISION
+    cblas_sgemm( CblasRowMajor, CblasTrans, CblasNoTrans,
+                rows(), cols(), count, rate, xRaw, x.cols(), yRaw, y.cols(), 1.0f, mRaw, cols() );
+#else
+    cblas_dgemm( CblasRowMajor, CblasTrans, CblasNoTrans,
+                rows(), cols(), count, rate, xRaw, x.cols(), yRaw, y.cols(), 1.0, mRaw, cols() );
+#endif
+	return (*this);
+#else
+	RealMat& self = *this;
+	for ( u_int k=0; k<count; k++ ) {
+		const RealVec& xk = x[k];
+		const RealVec& yk = y[k];
+		for ( u_int r=0; r<rows(); r++ ) {
+			const Real rx = rate * xk[r];
+			if ( rx == 0.0 ) continue;
+			RealVec& mr = self[r];
+			for ( u_int c=0; c<cols(); c++ ) {
+				mr[c] += rx * yk[c];
+			}
+		}
+	}
+	return self;
+#endif
+}
 
     // ****************************
     // *** MATH FUNCTION **********
@@ -162,11 +162,14 @@ Real RealVec::mse( const RealVec& target, const RealVec& actual ) {
 		return 0.0;
 	}
 #endif
-	RealVec error( target.size() );
-	error.assign(target);
-	error -= actual;
-	error.square();
-	return error.mean();
+	// --- accumulate directly, without a temporary vector
+	u_int n = target.size();
+	Real acc = 0.0;
+	for( u_int i=0; i<n; i++ ) {
+		Real diff = target[i] - actual[i];
+		acc += diff*diff;
+	}
+	return acc/n;
 };
 
 
@@ -0,0 +1,425 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "sharedtraining.h"
+#include "neuralnet.h"
+#include "profiler.h"
+#include <QAtomicInt>
+#include <vector>
+#include <string>
+#include <cerrno>
+#include <cstring>
+#ifndef WIN32
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+	#include <signal.h>
+	#include <time.h>
+#endif
+
+namespace nnfw {
+
+/*! the maximum number of processes of a group */
+static const u_int sharedMaxProcesses = 256;
+/*! bytes reserved to the header; the slots start after it */
+static const size_t sharedHeaderSize = 4096;
+
+/*! the header of the segment; the segment is created filled of zeros, so all the fields start from
+ *  zero without initializing them. Only int fields are used, so processes built with different
+ *  precisions see the same layout */
+class sharedHeader {
+public:
+	QAtomicInt numProcesses;
+	QAtomicInt numParameters;
+	/*! the Exchange and syncEvery of the group, plus one; zero is not set yet */
+	QAtomicInt exchange;
+	QAtomicInt syncEvery;
+	/*! the processes arrived at the barrier */
+	QAtomicInt arrived;
+	/*! incremented each time all the processes arrive at the barrier */
+	QAtomicInt generation;
+	/*! set when a process leaves the group abnormally */
+	QAtomicInt failed;
+	/*! the pid of the process of each rank; zero if not connected yet */
+	QAtomicInt pids[sharedMaxProcesses];
+};
+
+/*! read an atomic value with a full memory barrier */
+static int atomicLoad( QAtomicInt& a ) {
+	return a.fetchAndAddOrdered( 0 );
+}
+
+class SharedTrainingPrivate {
+public:
+	SharedTrainingPrivate( BaseNeuralNet* n, const char* nm, u_int r, u_int np, SharedTraining::Exchange ex, u_int every )
+		: net(n), name(nm), rank(r), nprocs(np), exchange(ex), every(every), timeout(0.0),
+		  steps(0), syncs(0), connected(false), base(0), length(0), header(0), slots(0), result(0),
+		  params(), last() {
+	};
+	/*! open the segment and wait the other processes */
+	bool connect();
+	/*! unmap the segment */
+	void disconnect();
+	/*! leave the group, so the other processes don't wait this one anymore */
+	void leave();
+	/*! leave the group after a failure */
+	void fail( const char* reason );
+	/*! wait until all the processes arrive; return false if a process fails or the timeout expires */
+	bool barrier();
+	/*! return false if a process of the group is dead */
+	bool peersAlive();
+	/*! the exchange */
+	bool synchronize();
+
+	BaseNeuralNet* net;
+	std::string name;
+	u_int rank;
+	u_int nprocs;
+	SharedTraining::Exchange exchange;
+	u_int every;
+	double timeout;
+	u_int steps;
+	u_int syncs;
+	bool connected;
+	/*! the mapping of the segment */
+	void* base;
+	size_t length;
+	sharedHeader* header;
+	/*! the slot of each process, nprocs*numParameters values */
+	double* slots;
+	/*! the values reduced, numParameters values */
+	double* result;
+	/*! the parameters of the net */
+	std::vector<Real> params;
+	/*! the parameters after the last exchange, for calculating the updates */
+	std::vector<double> last;
+};
+
+#ifdef WIN32
+
+bool SharedTrainingPrivate::connect() {
+	nError() << "SharedTraining is not supported on this system; the process trains alone";
+	return false;
+}
+
+void SharedTrainingPrivate::disconnect() {
+	connected = false;
+}
+
+bool SharedTrainingPrivate::peersAlive() {
+	return true;
+}
+
+bool SharedTraining::remove( const char* ) {
+	return false;
+}
+
+#else
+
+bool SharedTrainingPrivate::connect() {
+	if ( nprocs == 0 || nprocs > sharedMaxProcesses || rank >= nprocs ) {
+		nError() << "SharedTraining: wrong rank " << rank << " of " << nprocs << " processes";
+		return false;
+	}
+	u_int n = net->parametersSize();
+	params.resize( n );
+	last.resize( n );
+	length = sharedHeaderSize + ( (size_t)nprocs + 1 )*n*sizeof(double);
+	int fd = shm_open( name.c_str(), O_RDWR | O_CREAT, 0600 );
+	if ( fd < 0 ) {
+		nError() << "SharedTraining: it's not possible to open the shared memory " << name.c_str() << ": " << strerror( errno );
+		return false;
+	}
+	// --- the segment only grows, so a process with a different net can't truncate the mapping of the others
+	struct stat st;
+	if ( fstat( fd, &st ) != 0 || ( (size_t)st.st_size < length && ftruncate( fd, length ) != 0 ) ) {
+		nError() << "SharedTraining: it's not possible to resize the shared memory " << name.c_str() << ": " << strerror( errno );
+		::close( fd );
+		return false;
+	}
+	base = mmap( 0, length, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 );
+	::close( fd );
+	if ( base == MAP_FAILED ) {
+		base = 0;
+		nError() << "SharedTraining: it's not possible to map the shared memory " << name.c_str() << ": " << strerror( errno );
+		return false;
+	}
+	header = (sharedHeader*)base;
+	slots = (double*)( (char*)base + sharedHeaderSize );
+	result = slots + (size_t)nprocs*n;
+	// --- the first process sets the size of the group and of the net, the others check them
+	bool sameProcs = header->numProcesses.testAndSetOrdered( 0, nprocs ) || atomicLoad( header->numProcesses ) == (int)nprocs;
+	bool sameParams = header->numParameters.testAndSetOrdered( 0, n ) || atomicLoad( header->numParameters ) == (int)n;
+	if ( !sameProcs || !sameParams ) {
+		nError() << "SharedTraining: the group " << name.c_str() << " has " << atomicLoad( header->numProcesses )
+		         << " processes training " << atomicLoad( header->numParameters ) << " parameters, instead of "
+		         << nprocs << " and " << n;
+		// --- the group can't train with a different configuration, so the processes waiting leave it too
+		header->failed.fetchAndStoreOrdered( 1 );
+		disconnect();
+		return false;
+	}
+	// --- the same for the kind and the frequency of the exchanges; they are stored plus one, as zero is valid
+	bool sameExchange = header->exchange.testAndSetOrdered( 0, (int)exchange+1 ) || atomicLoad( header->exchange ) == (int)exchange+1;
+	bool sameEvery = header->syncEvery.testAndSetOrdered( 0, (int)every+1 ) || atomicLoad( header->syncEvery ) == (int)every+1;
+	if ( !sameExchange || !sameEvery ) {
+		nError() << "SharedTraining: the group " << name.c_str() << " exchanges " << ( ( atomicLoad( header->exchange ) == 1 ) ? "Parameters" : "Updates" )
+		         << " every " << atomicLoad( header->syncEvery )-1 << " steps, instead of "
+		         << ( ( exchange == SharedTraining::Parameters ) ? "Parameters" : "Updates" ) << " every " << every;
+		header->failed.fetchAndStoreOrdered( 1 );
+		disconnect();
+		return false;
+	}
+	if ( !header->pids[rank].testAndSetOrdered( 0, (int)getpid() ) ) {
+		nError() << "SharedTraining: the rank " << rank << " of the group " << name.c_str()
+		         << " is already connected; call SharedTraining::remove if a previous group terminated abnormally";
+		disconnect();
+		return false;
+	}
+	connected = true;
+	if ( !barrier() ) {
+		fail( "not all the processes connected" );
+		return false;
+	}
+	// --- everybody has opened the segment, so the name is not needed anymore
+	if ( rank == 0 ) {
+		shm_unlink( name.c_str() );
+	}
+	// --- all the processes start from the parameters of rank 0
+	if ( n == 0 ) return true;
+	net->gatherParameters( &params[0] );
+	if ( rank == 0 ) {
+		for( u_int i=0; i<n; i++ ) {
+			result[i] = params[i];
+		}
+	}
+	if ( !barrier() ) {
+		fail( "the process of rank 0 didn't send the parameters" );
+		return false;
+	}
+	for( u_int i=0; i<n; i++ ) {
+		params[i] = (Real)result[i];
+		last[i] = params[i];
+	}
+	// --- result is written again only after the first barrier of the next exchange
+	net->scatterParameters( &params[0] );
+	return true;
+}
+
+void SharedTrainingPrivate::disconnect() {
+	if ( base ) {
+		munmap( base, length );
+	}
+	base = 0;
+	header = 0;
+	slots = 0;
+	result = 0;
+	connected = false;
+}
+
+bool SharedTrainingPrivate::peersAlive() {
+	for( u_int i=0; i<nprocs; i++ ) {
+		int pid = atomicLoad( header->pids[i] );
+		if ( pid != 0 && kill( pid, 0 ) != 0 && errno == ESRCH ) {
+			return false;
+		}
+	}
+	return true;
+}
+
+bool SharedTraining::remove( const char* name ) {
+	return ( shm_unlink( name ) == 0 );
+}
+
+#endif
+
+void SharedTrainingPrivate::leave() {
+	if ( connected ) {
+		// --- the group can't exchange without this process, so the others leave it at the next barrier
+		header->pids[rank].fetchAndStoreOrdered( 0 );
+		header->failed.fetchAndStoreOrdered( 1 );
+	}
+	disconnect();
+}
+
+void SharedTrainingPrivate::fail( const char* reason ) {
+	if ( header ) {
+		header->failed.fetchAndStoreOrdered( 1 );
+	}
+	disconnect();
+	nWarning() << "SharedTraining: the process of rank " << rank << " leaves the group " << name.c_str()
+	           << " (" << reason << ") and goes on training alone";
+}
+
+bool SharedTrainingPrivate::barrier() {
+	if ( atomicLoad( header->failed ) ) return false;
+	int gen = atomicLoad( header->generation );
+	if ( header->arrived.fetchAndAddOrdered( 1 ) == (int)nprocs-1 ) {
+		// --- the last one opens the barrier
+		header->arrived.fetchAndStoreOrdered( 0 );
+		header->generation.fetchAndAddOrdered( 1 );
+		return true;
+	}
+	double start = Profiler::now();
+	double lastCheck = start;
+	u_int spins = 0;
+	while( atomicLoad( header->generation ) == gen ) {
+		// --- a process may leave just after opening the barrier, so the generation is checked again
+		if ( atomicLoad( header->failed ) ) return ( atomicLoad( header->generation ) != gen );
+		// --- spin for a while, as the exchanges are frequent, then sleep
+		if ( ++spins < 1000 ) continue;
+#ifndef WIN32
+		struct timespec ts = { 0, 20000 };
+		nanosleep( &ts, 0 );
+#endif
+		double now = Profiler::now();
+		if ( now - lastCheck < 0.05 ) continue;
+		lastCheck = now;
+		if ( !peersAlive() ) return false;
+		if ( timeout > 0.0 && now - start > timeout ) return false;
+	}
+	return true;
+}
+
+bool SharedTrainingPrivate::synchronize() {
+	if ( !connected ) return false;
+	NNFW_PROFILE_SCOPE_IN( "SharedTraining::synchronize", "sync" );
+	u_int n = params.size();
+	if ( n == 0 ) {
+		syncs++;
+		return true;
+	}
+	net->gatherParameters( &params[0] );
+	double* mine = slots + (size_t)rank*n;
+	if ( exchange == SharedTraining::Updates ) {
+		for( u_int i=0; i<n; i++ ) {
+			mine[i] = params[i] - last[i];
+		}
+	} else {
+		for( u_int i=0; i<n; i++ ) {
+			mine[i] = params[i];
+		}
+	}
+	if ( !barrier() ) {
+		fail( "a process is dead, too slow or has left" );
+		return false;
+	}
+	// --- each process reduces its part of the parameters, summing in order of rank
+	u_int first = (u_int)( ( (size_t)n*rank )/nprocs );
+	u_int end = (u_int)( ( (size_t)n*(rank+1) )/nprocs );
+	double scale = ( exchange == SharedTraining::Parameters ) ? 1.0/nprocs : 1.0;
+	for( u_int i=first; i<end; i++ ) {
+		double sum = 0.0;
+		for( u_int k=0; k<nprocs; k++ ) {
+			sum += slots[(size_t)k*n+i];
+		}
+		result[i] = sum*scale;
+	}
+	if ( !barrier() ) {
+		fail( "a process is dead, too slow or has left" );
+		return false;
+	}
+	// --- everybody reads the whole result; the slots and result are written again only after
+	// --- the first barrier of the next exchange, which all the processes reach after reading
+	if ( exchange == SharedTraining::Updates ) {
+		for( u_int i=0; i<n; i++ ) {
+			params[i] = (Real)( last[i] + result[i] );
+			// --- last is what the net really has, otherwise the rounding of Real would be
+			// --- counted as an update at the next exchange
+			last[i] = params[i];
+		}
+	} else {
+		for( u_int i=0; i<n; i++ ) {
+			params[i] = (Real)result[i];
+			last[i] = params[i];
+		}
+	}
+	net->scatterParameters( &params[0] );
+	syncs++;
+	return true;
+}
+
+/**********************************************
+ *  Implementation of SharedTraining Class    *
+ **********************************************/
+
+SharedTraining::SharedTraining( BaseNeuralNet* net, const char* name, u_int rank, u_int numProcesses, Exchange exchange, u_int syncEvery ) {
+	prv = new SharedTrainingPrivate( net, name, rank, numProcesses, exchange, syncEvery );
+	prv->connect();
+}
+
+SharedTraining::~SharedTraining() {
+	prv->leave();
+	delete prv;
+}
+
+bool SharedTraining::isConnected() const {
+	return prv->connected;
+}
+
+u_int SharedTraining::rank() const {
+	return prv->rank;
+}
+
+u_int SharedTraining::numProcesses() const {
+	return prv->nprocs;
+}
+
+SharedTraining::Exchange SharedTraining::exchange() const {
+	return prv->exchange;
+}
+
+void SharedTraining::setSyncEvery( u_int steps ) {
+	prv->every = steps;
+	prv->steps = 0;
+}
+
+u_int SharedTraining::syncEvery() const {
+	return prv->every;
+}
+
+void SharedTraining::setTimeout( double seconds ) {
+	prv->timeout = seconds;
+}
+
+bool SharedTraining::stepDone() {
+	if ( !prv->connected ) return false;
+	if ( prv->every == 0 ) return true;
+	prv->steps++;
+	if ( prv->steps < prv->every ) return true;
+	prv->steps = 0;
+	return prv->synchronize();
+}
+
+bool SharedTraining::synchronize() {
+	prv->steps = 0;
+	return prv->synchronize();
+}
+
+u_int SharedTraining::numSynchronizations() const {
+	return prv->syncs;
+}
+
+void SharedTraining::shardRange( u_int size, u_int& first, u_int& count ) const {
+	count = size / prv->nprocs;
+	first = count*prv->rank;
+}
+
+}
@@ -32,12 +32,14 @@ namespace nnfw {
 
 SimpleCluster::SimpleCluster( u_int numNeurons, const char* name )
     : Cluster( numNeurons, name) {
-    setTypename( "SimpleCluster" );
+    static const PropertyKey typeKey( "SimpleCluster" );
+    setTypename( typeKey );
 }
 
 SimpleCluster::SimpleCluster( PropertySettings& prop )
     : Cluster( prop ) {
-    setTypename( "SimpleCluster" );
+    static const PropertyKey typeKey( "SimpleCluster" );
+    setTypename( typeKey );
 }
 
 SimpleCluster::~SimpleCluster() {
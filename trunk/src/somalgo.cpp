@@ -0,0 +1,245 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "somalgo.h"
+#include "neuralnet.h"
+#include "matrixlinker.h"
+#include <cmath>
+
+namespace nnfw {
+
+SOMAlgo::SOMAlgo( BaseNeuralNet* net, MatrixLinker* prototypes, u_int width, u_int height, u_int batchSize )
+	: LearningAlgorithm(net), lk(prototypes), ninputs( prototypes->rows() ), nunits( prototypes->cols() ),
+	  gridx( nunits ), gridy( nunits ), nfun(Gaussian), rateStart(0.5), rateEnd(0.01),
+	  radiusStart(0.5), radiusEnd(0.5), duration(10000), tsteps(0),
+	  xs( (batchSize>0) ? batchSize : 1, ninputs ), hs( (batchSize>0) ? batchSize : 1, nunits ), pending(0),
+	  norms( nunits ), normsValid(false), dist( nunits ), winners( (batchSize>0) ? batchSize : 1 ), hsum( nunits ) {
+	if ( width*height != nunits ) {
+		nError() << "The grid " << width << "x" << height << " doesn't match the " << nunits
+				 << " units of " << lk->name() << "; the units will be placed on a line";
+		width = nunits;
+		height = 1;
+	}
+	for( u_int j=0; j<nunits; j++ ) {
+		gridx[j] = j % width;
+		gridy[j] = j / width;
+	}
+	radiusStart = ( ( width > height ) ? width : height ) / 2.0;
+}
+
+SOMAlgo::~SOMAlgo() {
+}
+
+void SOMAlgo::setRate( Real start, Real end ) {
+	rateStart = start;
+	rateEnd = end;
+}
+
+void SOMAlgo::setRadius( Real start, Real end ) {
+	radiusStart = start;
+	radiusEnd = end;
+}
+
+void SOMAlgo::setDuration( u_int steps ) {
+	duration = steps;
+}
+
+Real SOMAlgo::decay( Real start, Real end ) const {
+	if ( duration == 0 || tsteps >= duration ) return end;
+	Real t = (Real)tsteps / duration;
+	if ( start > 0.0 && end > 0.0 ) {
+		return start * std::pow( end/start, t );
+	}
+	return start + ( end - start ) * t;
+}
+
+Real SOMAlgo::rate() const {
+	return decay( rateStart, rateEnd );
+}
+
+Real SOMAlgo::radius() const {
+	return decay( radiusStart, radiusEnd );
+}
+
+void SOMAlgo::restart() {
+	tsteps = 0;
+	pending = 0;
+}
+
+void SOMAlgo::updateNorms() {
+	const RealMat& w = lk->matrix();
+	norms.zeroing();
+	for( u_int i=0; i<ninputs; i++ ) {
+		const RealVec& row = w[i];
+		for( u_int j=0; j<nunits; j++ ) {
+			norms[j] += row[j]*row[j];
+		}
+	}
+	normsValid = true;
+}
+
+u_int SOMAlgo::nearest( const RealVec& x, Real& d2 ) {
+	if ( !normsValid ) updateNorms();
+	// --- dist <- ||w||^2 - 2*x*W
+	dist.assign( norms );
+	for( u_int i=0; i<ninputs; i++ ) {
+		const Real xi = -2.0 * x[i];
+		if ( xi == 0.0 ) continue;
+		const RealVec& row = lk->matrix()[i];
+		for( u_int j=0; j<nunits; j++ ) {
+			dist[j] += xi * row[j];
+		}
+	}
+	u_int best = dist.minIndex();
+	Real xx = 0.0;
+	for( u_int i=0; i<ninputs; i++ ) {
+		xx += x[i]*x[i];
+	}
+	d2 = xx + dist[best];
+	if ( d2 < 0.0 ) d2 = 0.0;
+	return best;
+}
+
+u_int SOMAlgo::winner( const RealVec& x ) {
+	Real d2;
+	return nearest( x, d2 );
+}
+
+void SOMAlgo::learn() {
+	if ( pending == 0 ) return;
+	NNFW_PROFILE_SCOPE( "SOMAlgo::learn" );
+	RealMat& w = lk->matrix();
+	updateNorms();
+	// --- hs <- ||w||^2 - 2*x*W for all inputs with one matrix product; ||x||^2 doesn't change the winner
+	for( u_int k=0; k<pending; k++ ) {
+		hs[k].assign( norms );
+	}
+	RealMat::mul( hs, -2.0, xs, w, pending );
+	for( u_int k=0; k<pending; k++ ) {
+		winners[k] = hs[k].minIndex();
+	}
+	// --- hs <- neighborhood weights of the winners
+	const Real eta = rate();
+	const Real r = radius();
+	const Real r2 = r*r;
+	const Real inv = ( r > 0.0 ) ? 1.0/(2.0*r2) : 0.0;
+	hsum.zeroing();
+	for( u_int k=0; k<pending; k++ ) {
+		RealVec& h = hs[k];
+		const u_int c = winners[k];
+		if ( r <= 0.0 ) {
+			h.zeroing();
+			h[c] = 1.0;
+			hsum[c] += 1.0;
+			continue;
+		}
+		const Real cx = gridx[c];
+		const Real cy = gridy[c];
+		for( u_int j=0; j<nunits; j++ ) {
+			const Real dx = gridx[j] - cx;
+			const Real dy = gridy[j] - cy;
+			const Real d2 = dx*dx + dy*dy;
+			if ( nfun == Bubble ) {
+				h[j] = ( d2 <= r2 ) ? 1.0 : 0.0;
+			} else {
+				// --- beyond three times the radius the weight is negligible
+				h[j] = ( d2 > 9.0*r2 ) ? 0.0 : std::exp( -d2*inv );
+			}
+		}
+		hsum += h;
+	}
+	// --- w_j <- (1 - a_j*sum_k h_kj) * w_j + a_j * sum_k h_kj * x_k
+	for( u_int j=0; j<nunits; j++ ) {
+		const Real s = hsum[j];
+		const Real a = ( eta*s > 1.0 ) ? 1.0/s : eta;
+		dist[j] = 1.0 - a*s;
+		hsum[j] = a;
+	}
+	for( u_int i=0; i<ninputs; i++ ) {
+		w[i] *= dist;
+	}
+	for( u_int k=0; k<pending; k++ ) {
+		hs[k] *= hsum;
+	}
+	w.batchDeltarule( 1.0, xs, hs, pending );
+	lk->weightsChanged();
+	normsValid = false;
+	tsteps += pending;
+	pending = 0;
+}
+
+void SOMAlgo::learn( const Pattern& pat ) {
+	const RealVec& x = pat.inputsOf( lk->from() );
+	if ( x.size() != ninputs ) return;
+	xs[pending].assign( x );
+	pending++;
+	if ( pending == xs.rows() ) {
+		learn();
+	}
+}
+
+Real SOMAlgo::calculateMSE( const Pattern& pat ) {
+	const RealVec& x = pat.inputsOf( lk->from() );
+	if ( x.size() != ninputs ) return 0.0;
+	Real d2;
+	nearest( x, d2 );
+	return d2/ninputs;
+}
+
+void SOMAlgo::learnOnSet( const PatternSet& set ) {
+	LearningAlgorithm::learnOnSet( set );
+	learn();
+}
+
+void SOMAlgo::learnOnSet( const DataSet& set ) {
+	LearningAlgorithm::learnOnSet( set );
+	learn();
+}
+
+void SOMAlgo::learnOnSet( PatternStream& stream ) {
+	LearningAlgorithm::learnOnSet( stream );
+	learn();
+}
+
+Real SOMAlgo::calculateMSEOnSet( const PatternSet& set ) {
+	if ( set.size() == 0 ) return 0.0;
+	updateNorms();
+	Real mseacc = 0.0;
+	for( u_int i=0; i<set.size(); i++ ) {
+		mseacc += calculateMSE( set[i] );
+	}
+	return mseacc/set.size();
+}
+
+Real SOMAlgo::calculateMSEOnSet( const DataSet& set ) {
+	if ( set.size() == 0 ) return 0.0;
+	updateNorms();
+	Real mseacc = 0.0;
+	for( u_int i=0; i<set.size(); i++ ) {
+		mseacc += calculateMSE( set[i] );
+	}
+	return mseacc/set.size();
+}
+
+Real SOMAlgo::calculateMSEOnSet( PatternStream& stream ) {
+	updateNorms();
+	return LearningAlgorithm::calculateMSEOnSet( stream );
+}
+
+}
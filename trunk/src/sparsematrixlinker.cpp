@@ -32,19 +32,17 @@ SparseMatrixLinker::SparseMatrixLinker( Cluster* from, Cluster* to, const char*
         }
     }
     addProperty( "mask", Variant::t_realmat, this, &SparseMatrixLinker::maskP, &SparseMatrixLinker::setMask );
-    setTypename( "SparseMatrixLinker" );
+    static const PropertyKey typeKey( "SparseMatrixLinker" );
+    setTypename( typeKey );
 }
 
 SparseMatrixLinker::SparseMatrixLinker( Real prob, Cluster* from, Cluster* to, const char* name )
     : MatrixLinker( from, to, name ), maskm(rows(), cols()) {
     // --- Init data
-    for( u_int i=0; i<rows(); i++ ) {
-        for( u_int j=0; j<cols(); j++ ) {
-            maskm[i][j] = Random::boolean( prob );
-        }
-    }
+    Random::booleanMat( maskm, prob );
     addProperty( "mask", Variant::t_realmat, this, &SparseMatrixLinker::maskP, &SparseMatrixLinker::setMask );
-    setTypename( "SparseMatrixLinker" );
+    static const PropertyKey typeKey( "SparseMatrixLinker" );
+    setTypename( typeKey );
 }
 
 SparseMatrixLinker::SparseMatrixLinker( Cluster* from, Cluster* to, Real prob, bool zeroDiagonal,
@@ -76,7 +74,8 @@ SparseMatrixLinker::SparseMatrixLinker( Cluster* from, Cluster* to, Real prob, b
         }
     }
     addProperty( "mask", Variant::t_realmat, this, &SparseMatrixLinker::maskP, &SparseMatrixLinker::setMask );
-    setTypename( "SparseMatrixLinker" );
+    static const PropertyKey typeKey( "SparseMatrixLinker" );
+    setTypename( typeKey );
 }
 
 SparseMatrixLinker::SparseMatrixLinker( PropertySettings& prop )
@@ -86,7 +85,8 @@ SparseMatrixLinker::SparseMatrixLinker( PropertySettings& prop )
         setMask( v );
     }
     addProperty( "mask", Variant::t_realmat, this, &SparseMatrixLinker::maskP, &SparseMatrixLinker::setMask );
-    setTypename( "SparseMatrixLinker" );
+    static const PropertyKey typeKey( "SparseMatrixLinker" );
+    setTypename( typeKey );
 }
 
 
@@ -110,15 +110,9 @@ void SparseMatrixLinker::setWeight( u_int from, u_int to, Real weight ) {
 }
 
 void SparseMatrixLinker::randomize( Real min, Real max ) {
-    for ( u_int i = 0; i<rows(); i++ ) {
-        for ( u_int j = 0; j<cols(); j++ ) {
-            if ( maskm[i][j] ) {
-                matrix()[i][j] = Random::flatReal( min, max );
-            } else {
-                matrix()[i][j] = 0.0;
-            }
-        }
-    }
+    Random::flatRealMat( matrix(), min, max );
+    matrix().cover( maskm );
+    weightsChanged();
 }
 
 void SparseMatrixLinker::update() {
@@ -130,6 +124,14 @@ void SparseMatrixLinker::update() {
     return;
 }
 
+void SparseMatrixLinker::updateCost( double& flops, double& bytes ) const {
+    // --- the disconnected weights are zero and the product uses all of them
+    const double r = rows();
+    const double c = cols();
+    flops = 2.0*r*c;
+    bytes = ( r*c + r + 2.0*c )*sizeof(Real);
+}
+
 void SparseMatrixLinker::connect( u_int from, u_int to ) {
     if ( from >= rows() ) {
         // Messaggio di errore !!!
@@ -143,11 +145,7 @@ void SparseMatrixLinker::connect( u_int from, u_int to ) {
 }
 
 void SparseMatrixLinker::connectRandom( Real prob ) {
-    for ( u_int r = 0; r < rows(); r++ ) {
-        for ( u_int c = 0; c < cols(); c++ ) {
-            maskm[r][c] = ! ( Random::flatReal() < prob );
-        }
-    }
+    Random::booleanMat( maskm, 1.0-prob );
 }
 
 void SparseMatrixLinker::connectAll() {
@@ -176,11 +174,7 @@ void SparseMatrixLinker::disconnectAll() {
 }
 
 void SparseMatrixLinker::disconnectRandom( Real prob ) {
-    for ( u_int r = 0; r < rows(); r++ ) {
-        for ( u_int c = 0; c < cols(); c++ ) {
-            maskm[r][c] = ! ( Random::flatReal() < prob );
-        }
-    }
+    Random::booleanMat( maskm, 1.0-prob );
 }
 
 void SparseMatrixLinker::setMask( const MatrixData<bool>& m ) {
@@ -0,0 +1,277 @@
+/********************************************************************************
+ *  Neural Network Framework.                                                   *
+ *  Copyright (C) 2005-2008 Gianluca Massera <emmegian@yahoo.it>                *
+ *                                                                              *
+ *  This program is free software; you can redistribute it and/or modify        *
+ *  it under the terms of the GNU General Public License as published by        *
+ *  the Free Software Foundation; either version 2 of the License, or           *
+ *  (at your option) any later version.                                         *
+ *                                                                              *
+ *  This program is distributed in the hope that it will be useful,             *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of              *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the               *
+ *  GNU General Public License for more details.                                *
+ *                                                                              *
+ *  You should have received a copy of the GNU General Public License           *
+ *  along with this program; if not, write to the Free Software                 *
+ *  Foundation, Inc., 51 Franklin St, Fifth Floor, Boston, MA  02110-1301  USA  *
+ ********************************************************************************/
+
+#include "tracer.h"
+#include "profiler.h"
+#include "updatable.h"
+#include <QMutex>
+#include <QMutexLocker>
+#include <QThreadStorage>
+#include <QAtomicInt>
+#include <vector>
+#include <string>
+#include <cstdio>
+#include <cstring>
+
+#ifdef WIN32
+	#include <windows.h>
+#else
+	#include <unistd.h>
+#endif
+
+namespace nnfw {
+
+/*! an event of the timeline */
+class traceEvent {
+public:
+	/*! the label of the code, or zero for the update() of an Updatable */
+	const char* label;
+	const char* category;
+	/*! copy of the name of the Updatable, which may be renamed or destroyed before save */
+	char name[32];
+	double start;
+	double end;
+};
+
+/*! the events of a thread; only the owner thread writes the events. The events before count are
+ *  complete and can be read by any thread; start waits until writing is zero before resetting it */
+class traceBuffer {
+public:
+	std::vector<traceEvent> events;
+	QAtomicInt count;
+	QAtomicInt dropped;
+	/*! one while the owner is recording an event */
+	QAtomicInt writing;
+	/*! identifier of the track into the timeline */
+	u_int tid;
+	std::string name;
+	/*! false when the thread owning it is terminated */
+	bool owned;
+};
+
+/*! the buffer of a thread; it's deleted by QThreadStorage when the thread terminates */
+class traceHandle {
+public:
+	traceHandle( traceBuffer* b ) : buf(b) { };
+	~traceHandle();
+	traceBuffer* buf;
+};
+
+/*! traceMutex protects the list of the buffers, not the events; it's declared before
+ *  traceLocal so it's destroyed after the handle of the main thread */
+static QMutex traceMutex;
+static std::vector<traceBuffer*> traceBuffers;
+static QThreadStorage<traceHandle*> traceLocal;
+/*! one while recording; the recording threads check it after setting writing of their buffer */
+static QAtomicInt traceActive;
+static u_int traceCapacity = 0;
+static double traceOrigin = 0.0;
+
+/*! read an atomic value with a full memory barrier */
+static int atomicLoad( QAtomicInt& a ) {
+	return a.fetchAndAddOrdered( 0 );
+}
+
+traceHandle::~traceHandle() {
+	QMutexLocker lock( &traceMutex );
+	buf->owned = false;
+}
+
+/*! return the buffer of the current thread, assigning one if it doesn't have it yet */
+static traceBuffer* localBuffer() {
+	if ( traceLocal.hasLocalData() ) {
+		return traceLocal.localData()->buf;
+	}
+	QMutexLocker lock( &traceMutex );
+	traceBuffer* buf = 0;
+	for( u_int i=0; i<traceBuffers.size(); i++ ) {
+		if ( !traceBuffers[i]->owned ) {
+			buf = traceBuffers[i];
+			break;
+		}
+	}
+	if ( !buf ) {
+		buf = new traceBuffer();
+		buf->tid = traceBuffers.size();
+		traceBuffers.push_back( buf );
+	}
+	buf->owned = true;
+	if ( buf->events.size() < traceCapacity ) {
+		buf->events.resize( traceCapacity );
+	}
+	traceLocal.setLocalData( new traceHandle( buf ) );
+	return buf;
+}
+
+/*! return a slot for a new event of the current thread, or zero if it's not recording or the buffer
+ *  is full; when a slot is returned the event must be published by endEvent */
+static traceEvent* beginEvent( traceBuffer* buf ) {
+	buf->writing.fetchAndStoreOrdered( 1 );
+	// --- checked after setting writing: either start sees it and waits, or this sees the stop
+	if ( !atomicLoad( traceActive ) ) {
+		buf->writing.fetchAndStoreOrdered( 0 );
+		return 0;
+	}
+	u_int n = atomicLoad( buf->count );
+	if ( n >= buf->events.size() ) {
+		buf->dropped.fetchAndAddOrdered( 1 );
+		buf->writing.fetchAndStoreOrdered( 0 );
+		return 0;
+	}
+	return &( buf->events[n] );
+}
+
+/*! make the event written visible to the other threads */
+static void endEvent( traceBuffer* buf ) {
+	buf->count.fetchAndAddOrdered( 1 );
+	buf->writing.fetchAndStoreOrdered( 0 );
+}
+
+/*! write str into file as the content of a JSON string */
+static void writeEscaped( FILE* file, const char* str ) {
+	for( ; *str; str++ ) {
+		unsigned char c = *str;
+		if ( c == '"' || c == '\\' ) {
+			fprintf( file, "\\%c", c );
+		} else if ( c < 0x20 ) {
+			fprintf( file, "\\u%04x", c );
+		} else {
+			fputc( c, file );
+		}
+	}
+}
+
+void Tracer::start( u_int eventsPerThread ) {
+	QMutexLocker lock( &traceMutex );
+	traceActive.fetchAndStoreOrdered( 0 );
+	traceCapacity = eventsPerThread;
+	for( u_int i=0; i<traceBuffers.size(); i++ ) {
+		traceBuffer* buf = traceBuffers[i];
+		// --- the threads still writing an event finish it, the others see the stop
+		while( atomicLoad( buf->writing ) ) { }
+		buf->count.fetchAndStoreOrdered( 0 );
+		buf->dropped.fetchAndStoreOrdered( 0 );
+		buf->events.resize( traceCapacity );
+	}
+	traceOrigin = Profiler::now();
+	traceActive.fetchAndStoreOrdered( 1 );
+}
+
+void Tracer::stop() {
+	traceActive.fetchAndStoreOrdered( 0 );
+}
+
+bool Tracer::isActive() {
+	return atomicLoad( traceActive ) != 0;
+}
+
+void Tracer::setThreadName( const char* name ) {
+	traceBuffer* buf = localBuffer();
+	QMutexLocker lock( &traceMutex );
+	buf->name = name;
+}
+
+void Tracer::record( const Updatable* u, double start, double end ) {
+	if ( !atomicLoad( traceActive ) ) return;
+	traceBuffer* buf = localBuffer();
+	traceEvent* e = beginEvent( buf );
+	if ( !e ) return;
+	e->label = 0;
+	e->category = "update";
+	strncpy( e->name, u->name(), sizeof(e->name)-1 );
+	e->name[ sizeof(e->name)-1 ] = '\0';
+	e->start = start;
+	e->end = end;
+	endEvent( buf );
+}
+
+void Tracer::record( const char* label, const char* category, double start, double end ) {
+	if ( !atomicLoad( traceActive ) ) return;
+	traceBuffer* buf = localBuffer();
+	traceEvent* e = beginEvent( buf );
+	if ( !e ) return;
+	e->label = label;
+	e->category = category;
+	e->start = start;
+	e->end = end;
+	endEvent( buf );
+}
+
+u_int Tracer::numEvents() {
+	QMutexLocker lock( &traceMutex );
+	u_int n = 0;
+	for( u_int i=0; i<traceBuffers.size(); i++ ) {
+		n += atomicLoad( traceBuffers[i]->count );
+	}
+	return n;
+}
+
+u_int Tracer::dropped() {
+	QMutexLocker lock( &traceMutex );
+	u_int n = 0;
+	for( u_int i=0; i<traceBuffers.size(); i++ ) {
+		n += atomicLoad( traceBuffers[i]->dropped );
+	}
+	return n;
+}
+
+bool Tracer::save( const char* filename ) {
+	FILE* file = fopen( filename, "w" );
+	if ( !file ) {
+		nError() << "Tracer can't write the file " << filename;
+		return false;
+	}
+#ifdef WIN32
+	unsigned long pid = GetCurrentProcessId();
+#else
+	unsigned long pid = getpid();
+#endif
+	QMutexLocker lock( &traceMutex );
+	bool first = true;
+	fprintf( file, "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[" );
+	for( u_int b=0; b<traceBuffers.size(); b++ ) {
+		traceBuffer* buf = traceBuffers[b];
+		if ( !buf->name.empty() ) {
+			fprintf( file, "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":%lu,\"tid\":%u,\"args\":{\"name\":\"",
+					 first ? "" : ",", pid, buf->tid );
+			writeEscaped( file, buf->name.c_str() );
+			fprintf( file, "\"}}" );
+			first = false;
+		}
+		// --- only the events published before now are written; the others may be incomplete
+		u_int count = atomicLoad( buf->count );
+		for( u_int i=0; i<count; i++ ) {
+			const traceEvent& e = buf->events[i];
+			fprintf( file, "%s\n{\"name\":\"", first ? "" : "," );
+			writeEscaped( file, e.label ? e.label : e.name );
+			fprintf( file, "\",\"cat\":\"%s\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":%lu,\"tid\":%u}",
+					 e.category, ( e.start - traceOrigin )*1e6, ( e.end - e.start )*1e6, pid, buf->tid );
+			first = false;
+		}
+	}
+	fprintf( file, "\n]}\n" );
+	bool ok = ( ferror( file ) == 0 );
+	if ( fclose( file ) != 0 ) ok = false;
+	if ( !ok ) {
+		nError() << "Error writing the file " << filename;
+	}
+	return ok;
+}
+
+}
@@ -18,15 +18,20 @@
  ********************************************************************************/
 
 #include "updatable.h"
-
+#include <QAtomicInt>
 
 namespace nnfw {
 
+/*! incremented by setFrozen when the flag changes */
+static QAtomicInt frozenCounter;
+
 Updatable::Updatable( const char* name )
     : Propertized() {
     this->namev = 0;
+    this->frozen = false;
     setName( name );
     addProperty( "name", Variant::t_string, this, &Updatable::getNameV, &Updatable::setName );
+    addProperty( "frozen", Variant::t_bool, this, &Updatable::frozenP, &Updatable::setFrozenP );
     // setTypename( "Updatable" ); --- it's no instanciable
 }
 
@@ -38,7 +43,16 @@ Updatable::Updatable( PropertySettings& prop )
 	} else {
     	setName( prop["name"].getString() );
 	}
+	Variant& fv = prop["frozen"];
+	if ( fv.isNull() ) {
+		frozen = false;
+	} else if ( fv.type() == Variant::t_string ) {
+		frozen = convertStringTo( fv, Variant::t_bool ).getBool();
+	} else {
+		frozen = fv.getBool();
+	}
     addProperty( "name", Variant::t_string, this, &Updatable::getNameV, &Updatable::setName );
+    addProperty( "frozen", Variant::t_bool, this, &Updatable::frozenP, &Updatable::setFrozenP );
     // setTypename( "Updatable" ); --- it's no instanciable
 }
 
@@ -46,6 +60,16 @@ Updatable::~Updatable() {
     delete []namev;
 }
 
+void Updatable::setFrozen( bool b ) {
+    if ( frozen == b ) return;
+    frozen = b;
+    frozenCounter.fetchAndAddOrdered( 1 );
+}
+
+int Updatable::frozenChanges() {
+    return frozenCounter.fetchAndAddOrdered( 0 );
+}
+
 void Updatable::setName( const char* newname ) {
     if (namev) {
         delete []namev;
@@ -33,7 +33,7 @@
 
 namespace nnfw {
 
-NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
+NNFW_INTERNAL void parseProperty_10( QDomElement cur, Propertized* obj ) {
     AbstractPropertyAccess* pacc = obj->propertySearch( cur.tagName().toAscii().constData() );
     if ( !pacc ) {
         nError() << "the property " << cur.tagName().toAscii().constData() << " doesn't exist in "
@@ -122,9 +122,9 @@ NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
     case Variant::t_realmat:
         list = text.split( ' ', QString::SkipEmptyParts );
         if ( index != -1 ) {
-            vmat = pacc->get( index ).getRealMat();
+            vmat = pacc->get( obj, index ).getRealMat();
         } else {
-            vmat = pacc->get().getRealMat();
+            vmat = pacc->get( obj ).getRealMat();
         }
         rows = vmat->rows();
         cols = vmat->cols();
@@ -150,9 +150,9 @@ NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
         type = cur.attribute( "type" );
         if ( type.isNull() ) {
             if ( index != -1 ) {
-                sub = pacc->get( index ).getOutputFunction();
+                sub = pacc->get( obj, index ).getOutputFunction();
             } else {
-                sub = pacc->get().getOutputFunction();
+                sub = pacc->get( obj ).getOutputFunction();
             }
         } else {
             sub = Factory::createOutputFunction( type.toAscii().constData(), prop );
@@ -167,9 +167,9 @@ NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
         type = cur.attribute( "type" );
         if ( type.isNull() ) {
             if ( index != -1 ) {
-                sub = pacc->get( index ).getPropertized();
+                sub = pacc->get( obj, index ).getPropertized();
             } else {
-                sub = pacc->get().getPropertized();
+                sub = pacc->get( obj ).getPropertized();
             }
         } else {
             sub = Factory::createPropertized( type.toAscii().constData(), prop );
@@ -179,9 +179,9 @@ NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
     }
     bool ok = true;
     if ( index != -1 ) {
-        ok = pacc->set( index, ret );
+        ok = pacc->set( obj, index, ret );
     } else {
-        ok = pacc->set( ret );
+        ok = pacc->set( obj, ret );
     }
     if ( !ok ) {
 		nError() << "There was an error settings the property " << cur.tagName().toAscii().constData();
@@ -191,9 +191,9 @@ NNFW_INTERNAL void parseProperty_10( QDomElement cur, const Propertized* obj ) {
         // --- re-get again because the value passed by Variant is temporary
         Variant v;
         if ( index != -1 ) {
-            v = pacc->get( index );
+            v = pacc->get( obj, index );
         } else {
-            v = pacc->get();
+            v = pacc->get( obj );
         }
         switch( pacc->type() ) {
         case Variant::t_outfunction:
@@ -831,19 +831,19 @@ NNFW_INTERNAL void saveProperties( QDomDocument doc, QDomElement parent, Propert
 			if ( p->isWritable() ) {
 				QDomElement elem = doc.createElement( p->name() );
 				parent.appendChild( elem );
-				QDomNode sub = createPropertyFragment( p->get(), doc, elem, precision );
+				QDomNode sub = createPropertyFragment( p->get( obj ), doc, elem, precision );
 				if ( !sub.isNull() ) {
 					elem.appendChild( sub );
 				}
 			} else {
-				parent.setAttribute( p->name(), createAttributeContent( p->get(), precision ) );
+				parent.setAttribute( p->name(), createAttributeContent( p->get( obj ), precision ) );
 			}
             continue;
         }
         // --- Vector property
         int id = 0;
         Variant v;
-        while( !(v = p->get(id)).isNull() ) {
+        while( !(v = p->get( obj, id )).isNull() ) {
             QDomElement elem = doc.createElement( p->name() );
             elem.setAttribute( "i", QString("%1").arg(id) );
             parent.appendChild( elem );